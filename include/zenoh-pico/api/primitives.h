@@ -119,6 +119,10 @@ zn_subscriber_t *zn_declare_subscriber(zn_session_t *zn,
 /**
  * Undeclare a :c:type:`zn_subscriber_t`.
  *
+ * Upon return, the callback of the subscriber is no longer invoked and none of
+ * its invocations is still in progress, so that its argument can be released.
+ * A subscriber must not be undeclared from its own callback.
+ *
  * Parameters:
  *     sub: The :c:type:`zn_subscriber_t` to undeclare. The callee releases the
  *          subscriber upon successful return.
@@ -188,6 +192,28 @@ int zn_write(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload,
  */
 int zn_write_ext(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload, const size_t len, uint8_t encoding, const uint8_t kind, const zn_congestion_control_t cong_ctrl);
 
+/**
+ * Write data corresponding to a given resource key with a given priority, allowing the
+ * definition of additional properties. On the transports supporting QoS, the data is sent
+ * before the pending data with a lower priority, possibly between its fragments.
+ *
+ * Parameters:
+ *     zn: The zenoh-net session. The caller keeps its ownership.
+ *     reskey: The resource key to write. The caller keeps its ownership.
+ *     payload: The value to write.
+ *     len: The length of the value to write.
+ *     encoding: The encoding of the payload. The callee gets the ownership of
+ *               any allocated value.
+ *     kind: The kind of the value.
+ *     cong_ctrl: The congestion control of this write. Possible values defined
+ *                in :c:type:`zn_congestion_control_t`.
+ *     priority: The priority of this write. Possible values defined
+ *               in :c:type:`zn_priority_t`.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure or if the priority is not valid.
+ */
+int zn_write_prio(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload, const size_t len, uint8_t encoding, const uint8_t kind, const zn_congestion_control_t cong_ctrl, const zn_priority_t priority);
+
 /**
  * Pull data for a pull mode :c:type:`zn_subscriber_t`. The pulled data will be provided
  * by calling the **callback** function provided to the :c:func:`zn_declare_subscriber` function.
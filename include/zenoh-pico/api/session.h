@@ -16,6 +16,9 @@
 #define ZENOH_PICO_SESSION_API_H
 
 #include "zenoh-pico/session/session.h"
+#include "zenoh-pico/session/stats.h"
+#include "zenoh-pico/protocol/rname_trie.h"
+#include "zenoh-pico/collections/intmap.h"
 #include "zenoh-pico/utils/properties.h"
 
 /**
@@ -32,21 +35,36 @@ typedef struct
     z_zint_t query_id;
 
     // Session declarations
-    _zn_resource_list_t *local_resources;
-    _zn_resource_list_t *remote_resources;
+    // Resources are indexed by id, and by the hash of their key
+    _zn_resource_intmap_t local_resources;
+    _zn_resource_intmap_t remote_resources;
+    _z_int_void_map_t local_resources_by_key;
+    _z_int_void_map_t remote_resources_by_key;
 
     // Session subscriptions
     _zn_subscriber_list_t *local_subscriptions;
     _zn_subscriber_list_t *remote_subscriptions;
+    _zn_rname_trie_t local_subscriptions_index;
+    _z_int_void_map_t local_subscriptions_cache;
+    _zn_subscriber_cache_entry_t *local_subscriptions_snapshots;
 
     // Session queryables
     _zn_queryable_list_t *local_queryables;
+    _zn_rname_trie_t local_queryables_index;
     _zn_pending_query_list_t *pending_queries;
 
+    // Session dispatch pool, samples are delivered by the read task when null
+    _zn_dispatch_pool_t *dispatch_pool;
+
     // Session transport.
     // Zenoh-pico is considering a single transport per session.
     _zn_transport_t *tp;
     _zn_transport_manager_t *tp_manager;
+
+#if ZN_STATS == 1
+    // Session statistics, updated with relaxed atomic operations
+    zn_stats_t stats;
+#endif
 } zn_session_t;
 
 /**
@@ -80,6 +98,30 @@ void zn_close(zn_session_t *session);
  */
 zn_properties_t *zn_info(zn_session_t *session);
 
+/**
+ * Get a snapshot of the runtime statistics of a zenoh-net session. The counters
+ * are cumulated since the session has been opened or since the last call to
+ * :c:func:`zn_stats_reset`. The statistics are only collected when ``ZN_STATS``
+ * is enabled.
+ *
+ * Parameters:
+ *     session: A zenoh-net session. The caller keeps its ownership.
+ *     stats: The :c:type:`zn_stats_t` to fill.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` if the statistics are disabled.
+ */
+int zn_stats(zn_session_t *session, zn_stats_t *stats);
+
+/**
+ * Reset the runtime statistics of a zenoh-net session.
+ *
+ * Parameters:
+ *     session: A zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` if the statistics are disabled.
+ */
+int zn_stats_reset(zn_session_t *session);
+
 /*------------------ Zenoh-Pico Session Management Auxiliar------------------*/
 
 /**
@@ -103,6 +145,41 @@ int znp_read(zn_session_t *z);
  */
 int znp_send_keep_alive(zn_session_t *z);
 
+/**
+ * Start a batch scope. The zenoh messages sent after this call (e.g., by
+ * :c:func:`zn_write` or :c:func:`zn_write_ext`) are serialized in the same
+ * transport batch and are not sent until :c:func:`znp_batch_flush` is called,
+ * unless the batch gets full. Batch scopes can be nested: the batch is sent
+ * when the outermost scope is flushed.
+ *
+ * The zenoh messages whose payload is at least ``ZN_ZERO_COPY_THRESHOLD`` bytes
+ * long are the exception: their payload is not copied in the batch, so they
+ * are sent right away in their own frames, after the zenoh messages batched
+ * before them.
+ *
+ * Note that the batch scopes belong to the session, not to the calling thread:
+ * while a scope is open, the zenoh messages sent by any thread of the application
+ * are held in the batch. Opening batch scopes concurrently from several threads
+ * is not supported, as the batch is sent only once all of them are flushed.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_batch_start(zn_session_t *z);
+
+/**
+ * Close a batch scope opened by :c:func:`znp_batch_start` and send the batched
+ * zenoh messages in a single transmission.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_batch_flush(zn_session_t *z);
+
 /**
  * Start a separate task to read from the network and process the messages
  * as soon as they are received. Note that the task can be implemented in
@@ -153,4 +230,116 @@ int znp_start_lease_task(zn_session_t *z);
  */
 int znp_stop_lease_task(zn_session_t *z);
 
+/**
+ * Start a separate task to send the zenoh messages. Publishers then encode their
+ * messages into a bounded queue of ``ZN_TX_QUEUE_SIZE`` messages, drained by this
+ * task into batches, so that they are not blocked by a slow link while it sends.
+ * When the queue is full, messages with the ``zn_congestion_control_t_DROP``
+ * congestion control are dropped, while publishers of messages with the
+ * ``zn_congestion_control_t_BLOCK`` congestion control wait for free space.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_start_write_task(zn_session_t *z);
+
+/**
+ * Stop the write task after the queued zenoh messages have been sent. Publishers
+ * then send their messages directly. The publications in progress complete
+ * before the write task stops.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_stop_write_task(zn_session_t *z);
+
+/**
+ * Start a pool of tasks delivering the received samples to the subscription
+ * callbacks, instead of the read task. Samples are assigned to a task based on
+ * their resource name, so that samples for the same resource name are delivered
+ * in order. Each task queues up to ``ZN_DISPATCH_QUEUE_SIZE`` samples, the read
+ * task blocks when the queue is full.
+ *
+ * The pool can be started and stopped while the read task is running. While
+ * the pool is being stopped, the samples received for a resource name might be
+ * delivered before the ones still queued for it.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ *     workers: The number of tasks of the pool.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_start_dispatch_pool(zn_session_t *z, size_t workers);
+
+/**
+ * Stop the dispatch pool, after the samples already queued have been delivered.
+ * The samples are then delivered by the read task.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_stop_dispatch_pool(zn_session_t *z);
+
+#if Z_REACTOR == 1
+/**
+ * A reactor servicing the links of several sessions with a pool of tasks.
+ */
+typedef _zn_reactor_t znp_reactor_t;
+
+/**
+ * Open a reactor, made of a pool of tasks waiting for any of the links of the sessions
+ * added to it to be ready, and processing the messages received on it. It replaces the
+ * read task of these sessions, so that the number of tasks does not grow with the number
+ * of sessions.
+ *
+ * Parameters:
+ *     tasks: The number of tasks of the reactor, e.g., the number of cores.
+ * Returns:
+ *     The reactor in case of success, ``NULL`` in case of failure.
+ */
+znp_reactor_t *znp_reactor_open(size_t tasks);
+
+/**
+ * Close a reactor. The sessions added to it must have been removed or closed beforehand.
+ *
+ * Parameters:
+ *     reactor: The reactor to close. The callee releases its ownership.
+ */
+void znp_reactor_close(znp_reactor_t *reactor);
+
+/**
+ * Add a session to a reactor, which then reads from the network and processes the messages
+ * of the session, instead of its read task. The read task of the session must not have been
+ * started. A session is removed from the reactor when closed, which must not happen from the
+ * handlers of the session.
+ *
+ * Parameters:
+ *     reactor: The reactor. The caller keeps its ownership.
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_reactor_add_session(znp_reactor_t *reactor, zn_session_t *z);
+
+/**
+ * Remove a session from a reactor, after the messages being processed have been processed.
+ * It can be called from the handlers of the session, which are then the last ones called by
+ * the reactor. The session must not be closed from its own handlers.
+ *
+ * Parameters:
+ *     reactor: The reactor. The caller keeps its ownership.
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int znp_reactor_remove_session(znp_reactor_t *reactor, zn_session_t *z);
+#endif
+
 #endif /* ZENOH_PICO_SESSION_API_H */
@@ -122,6 +122,20 @@
  */
 #define ZN_JOIN_INTERVAL 2500
 
+/**
+ * Maximum time in milliseconds the lease task sleeps between two checks of the timers of the
+ * session. It bounds the delay of the deadlines scheduled while the task sleeps, like the ones
+ * of the queries.
+ */
+#define ZN_TIMER_RESOLUTION 100
+
+/**
+ * Default query timeout in milliseconds: 10 seconds. When the final reply of a query has not been
+ * received in time, the query is completed with the replies received so far. A value of 0 disables
+ * the timeout. Note that the lease task is in charge of expiring the queries.
+ */
+#define ZN_QUERY_TIMEOUT 10000
+
 /**
  * Default socket timeout: 2 seconds
  */
@@ -136,6 +150,15 @@
 #define ZN_SN_RESOLUTION ZN_SN_RESOLUTION_DEFAULT
 
 #define ZN_CONGESTION_CONTROL_DEFAULT zn_congestion_control_t_DROP
+#define ZN_PRIORITY_DEFAULT zn_priority_t_DATA
+
+/**
+ * Request the QoS support when establishing a transport over a link that guarantees
+ * the delivery (e.g., TCP). The zenoh messages are then carried by one conduit per priority,
+ * and the write task sends the higher priorities first, possibly between the fragments
+ * of a large lower priority message.
+ */
+#define ZN_TRANSPORT_QOS 1
 
 #define ZN_LINK_TCP 1
 #define ZN_LINK_UDP_MULTICAST 1
@@ -146,7 +169,100 @@
 
 #define ZN_IOSLICE_SIZE 128
 #define ZN_BATCH_SIZE 65535
+
+/**
+ * Maximum number of slices of a buffer sent with a single gather write,
+ * on the links supporting it.
+ */
+#define ZN_LINK_WRITE_VEC_SIZE 32
+
+/**
+ * Minimum payload size in bytes of a zenoh data message for it to be referenced by the
+ * frames sent on the link rather than copied into the TX batch. Such messages are not
+ * batched with other zenoh messages and, on the links supporting gather writes, the
+ * user payload is sent without any copy.
+ */
+#define ZN_ZERO_COPY_THRESHOLD 1024
+
+/**
+ * Maximum time in milliseconds a zenoh message is kept in the TX batch waiting
+ * for other zenoh messages with the same reliability to be packed in the same frame.
+ * A value of 0 disables the automatic batching: each zenoh message is sent right away.
+ * Note that the lease task is in charge of flushing the batches once the linger time expires.
+ */
+#define ZN_TX_BATCH_LINGER 0
+
+/**
+ * Number of encoded zenoh messages the TX queue can hold when the write task is running.
+ * When the queue is full, messages with the DROP congestion control are dropped while
+ * the publishers of messages with the BLOCK congestion control wait for free space.
+ */
+#define ZN_TX_QUEUE_SIZE 64
 #define ZN_FRAG_MAX_SIZE 300000
+
+/**
+ * Number of reliable frames kept for retransmission, and buffered when received out of order,
+ * on the links that do not guarantee the delivery (e.g., UDP). The memory of each reliable
+ * channel is bounded by this number of frames. At most 32 frames, the size of the ACK_NACK mask.
+ * A missing frame that is not retransmitted within the lease period of the remote peer is skipped.
+ */
+#define ZN_RELIABILITY_WINDOW_SIZE 16
+
+/**
+ * Period in milliseconds of the SYNC messages sent while reliable frames are waiting to be
+ * acknowledged, on the links that do not guarantee the delivery. The remote peer answers with
+ * an ACK_NACK message reporting the missing frames, which are then retransmitted.
+ * Note that the lease task is in charge of sending the SYNC messages.
+ */
+#define ZN_RELIABILITY_SYNC_PERIOD 100
+
+/**
+ * Number of buckets of the table indexing the known peers of a multicast transport by
+ * remote address. Each received datagram is matched against the peers of a single bucket.
+ */
+#define ZN_PEER_TABLE_SIZE 64
+
+/**
+ * Maximum number of (resource id, suffix) pairs whose resolved resource name and
+ * matching local subscriptions are cached for the dispatching of incoming data.
+ * The cache is reset when full or when resources or subscriptions are (un)declared.
+ */
+#define ZN_SUBSCRIPTIONS_CACHE_SIZE 64
+
+/**
+ * Number of samples each dispatch worker can queue before the read task blocks.
+ * Only relevant when a dispatch pool has been started with znp_start_dispatch_pool.
+ */
+#define ZN_DISPATCH_QUEUE_SIZE 64
+
+/**
+ * Maximum time in milliseconds a reactor task waits for a link to be ready. It bounds the time
+ * it takes to close a reactor. Only relevant on the platforms supporting znp_reactor_open.
+ */
+#define ZN_REACTOR_TIMEOUT 100
+
+/**
+ * Number of buckets of the hash maps indexing the local and remote resources.
+ * The buckets are allocated upon the first resource declaration.
+ */
+#define ZN_RESOURCES_MAP_CAPACITY 256
 #define ZN_DYNAMIC_MEMORY_ALLOCATION 0
 
+/**
+ * Enable the pool allocator behind z_malloc, z_realloc and z_free. Allocations up to
+ * 2 KiB are served from the free lists of power-of-two size classes, whose blocks are
+ * carved from chunks of ZN_MEMORY_POOL_CHUNK_SIZE bytes that are never returned to the
+ * platform allocator. Larger allocations go straight to the platform allocator.
+ * The statistics of each size class and subsystem are available with z_pool_stats.
+ */
+#define ZN_MEMORY_POOL 0
+#define ZN_MEMORY_POOL_CHUNK_SIZE 4096
+
+/**
+ * Enable the runtime statistics of the sessions, available with zn_stats: traffic counters,
+ * drop counters, and histograms of the callback execution time and of the send latency.
+ * Counters are updated with relaxed atomic operations when supported by the compiler.
+ */
+#define ZN_STATS 1
+
 #endif /* ZENOH_PICO_CONFIG_H */
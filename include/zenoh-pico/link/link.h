@@ -40,9 +40,11 @@ typedef int (*_zn_f_link_listen)(void *arg);
 typedef void (*_zn_f_link_close)(void *arg);
 typedef size_t (*_zn_f_link_write)(const void *arg, const uint8_t *ptr, size_t len);
 typedef size_t (*_zn_f_link_write_all)(const void *arg, const uint8_t *ptr, size_t len);
+typedef size_t (*_zn_f_link_write_vec)(const void *arg, const z_bytes_t *bufs, size_t n);
 typedef size_t (*_zn_f_link_read)(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr);
 typedef size_t (*_zn_f_link_read_exact)(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr);
 typedef void (*_zn_f_link_free)(void *arg);
+typedef int (*_zn_f_link_fd)(const void *arg);
 
 typedef struct
 {
@@ -66,9 +68,11 @@ typedef struct
     _zn_f_link_close close_f;
     _zn_f_link_write write_f;
     _zn_f_link_write_all write_all_f;
+    _zn_f_link_write_vec write_vec_f;
     _zn_f_link_read read_f;
     _zn_f_link_read_exact read_exact_f;
     _zn_f_link_free free_f;
+    _zn_f_link_fd fd_f;
 
     uint16_t mtu;
     uint8_t is_reliable;
@@ -84,6 +88,7 @@ _zn_link_p_result_t _zn_open_link(const z_str_t locator);
 _zn_link_p_result_t _zn_listen_link(const z_str_t locator);
 
 int _zn_link_send_wbuf(const _zn_link_t *link, const _z_wbuf_t *wbf);
+int _zn_link_send_vec(const _zn_link_t *link, z_bytes_t *bufs, size_t n);
 size_t _zn_link_recv_zbuf(const _zn_link_t *link, _z_zbuf_t *zbf, z_bytes_t *addr);
 size_t _zn_link_recv_exact_zbuf(const _zn_link_t *link, _z_zbuf_t *zbf, size_t len, z_bytes_t *addr);
 
@@ -31,6 +31,7 @@ int _z_uint8_encode(_z_wbuf_t *buf, uint8_t v);
 _z_uint8_result_t _z_uint8_decode(_z_zbuf_t *buf);
 
 _Z_RESULT_DECLARE(z_zint_t, zint)
+size_t _z_zint_len(z_zint_t v);
 int _z_zint_encode(_z_wbuf_t *buf, z_zint_t v);
 _z_zint_result_t _z_zint_decode(_z_zbuf_t *buf);
 
@@ -209,6 +209,32 @@ typedef enum
     zn_reliability_t_RELIABLE,
 } zn_reliability_t;
 
+/**
+ * The priority of the zenoh messages, from the highest to the lowest one.
+ * The messages sent with different priorities are carried by independent conduits,
+ * each with its own sequence numbers, when the transport supports QoS.
+ *
+ *     - **zn_priority_t_CONTROL**
+ *     - **zn_priority_t_REAL_TIME**
+ *     - **zn_priority_t_INTERACTIVE_HIGH**
+ *     - **zn_priority_t_INTERACTIVE_LOW**
+ *     - **zn_priority_t_DATA_HIGH**
+ *     - **zn_priority_t_DATA**
+ *     - **zn_priority_t_DATA_LOW**
+ *     - **zn_priority_t_BACKGROUND**
+ */
+typedef enum
+{
+    zn_priority_t_CONTROL,
+    zn_priority_t_REAL_TIME,
+    zn_priority_t_INTERACTIVE_HIGH,
+    zn_priority_t_INTERACTIVE_LOW,
+    zn_priority_t_DATA_HIGH,
+    zn_priority_t_DATA,
+    zn_priority_t_DATA_LOW,
+    zn_priority_t_BACKGROUND,
+} zn_priority_t;
+
 /**
  * The congestion control.
  *
@@ -239,7 +239,8 @@ void _zn_z_msg_clear_reply_context(_zn_reply_context_t *rc);
 // | ID  |  Prio   |
 // +-+-+-+---------+
 //
-// WARNING: zenoh-pico does not support priorities and QoS.
+// In zenoh-pico, the priority decorator is only sent and handled in front of FRAME messages,
+// on the transports that support QoS. A FRAME without decorator has the default priority.
 
 /*=============================*/
 /*       Zenoh Messages        */
@@ -964,15 +965,22 @@ void _zn_t_msg_clear_ping_pong(_zn_ping_pong_t *msg, uint8_t header);
 //       de-serialize the payload in one single pass when F==0 since no re-ordering needs to take
 //       place at this stage. Then, the F bit is used to detect the last fragment during re-ordering.
 //
+// NOTE: When decoded lazily (see _zn_transport_message_decode_lazy), the list of complete Zenoh
+//       Messages is not materialized: the payload refers to the encoded messages in the read buffer
+//       and is_lazy is set. The messages are then decoded one at a time by _zn_frame_messages_decode.
+//
 typedef union
 {
     _zn_payload_t fragment;
     _zn_zenoh_message_vec_t messages;
+    _zn_payload_t encoded;
 } _zn_frame_payload_t;
 typedef struct
 {
     z_zint_t sn;
     _zn_frame_payload_t payload;
+    uint8_t is_lazy;
+    zn_priority_t priority;
 } _zn_frame_t;
 void _zn_t_msg_clear_frame(_zn_frame_t *msg, uint8_t header);
 
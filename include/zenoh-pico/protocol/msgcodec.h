@@ -94,10 +94,35 @@ _ZN_DECLARE_DECODE(hello);
 _ZN_DECLARE_ENCODE_NOH(transport_message);
 _ZN_DECLARE_DECODE_NOH(transport_message);
 
+/**
+ * Decode a transport message without materializing the zenoh messages of a non-fragmented FRAME.
+ * The FRAME payload refers to the encoded messages in the buffer, that must outlive the transport message.
+ */
+_zn_transport_message_result_t _zn_transport_message_decode_lazy(_z_zbuf_t *zbf);
+void _zn_transport_message_decode_lazy_na(_z_zbuf_t *zbf, _zn_transport_message_result_t *r);
+
 /*------------------ Zenoh Message ------------------*/
 _ZN_DECLARE_ENCODE_NOH(zenoh_message);
 _ZN_DECLARE_DECODE_NOH(zenoh_message);
 
+/**
+ * Encode a zenoh message except for the payload bytes of data messages, that are
+ * left to the caller. Other zenoh messages are encoded as a whole.
+ */
+int _zn_zenoh_message_encode_head(_z_wbuf_t *wbf, const _zn_zenoh_message_t *msg);
+
+typedef int (*_zn_zenoh_message_visitor_t)(_zn_zenoh_message_t *msg, void *arg);
+
+/**
+ * Decode the zenoh messages of a lazily decoded FRAME one at a time, handing each of them to the visitor.
+ * Every message is decoded in the same stack slot and released when the visitor returns, hence
+ * no heap allocation is performed for the messages themselves.
+ *
+ * Returns 0 if all the messages have been visited, -1 on decoding errors, or the first non-zero
+ * value returned by the visitor.
+ */
+int _zn_frame_messages_decode(const _zn_frame_t *frame, _zn_zenoh_message_visitor_t visitor, void *arg);
+
 #endif /* ZENOH_PICO_MSGCODEC_H */
 
 // NOTE: the following headers are for unit testing only
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#ifndef ZENOH_PICO_PROTOCOL_RNAME_TRIE_H
+#define ZENOH_PICO_PROTOCOL_RNAME_TRIE_H
+
+#include "zenoh-pico/collections/element.h"
+#include "zenoh-pico/collections/list.h"
+#include "zenoh-pico/collections/string.h"
+
+/*-------- Resource name trie --------*/
+/**
+ * A node of a resource name trie. Each node represents a chunk of a resource
+ * name, i.e., the characters between two ``/``.
+ *
+ * Members:
+ *   z_str_t chunk: The chunk represented by this node.
+ *   size_t len: The length of the chunk.
+ *   int is_wild: ``1`` if the chunk contains a ``*``, ``0`` otherwise.
+ *   _z_list_t *vals: The values registered for the resource name ending at this node.
+ *   struct _zn_rname_trie_node_t **literals: The children without ``*``, sorted by chunk.
+ *   size_t literals_len: The number of literal children.
+ *   size_t literals_cap: The capacity of the literal children array.
+ *   _z_list_t *wilds: The children containing a ``*``, including ``**``.
+ *   size_t mark: The epoch of the last matching operation that reported this node.
+ */
+typedef struct _zn_rname_trie_node_t
+{
+    z_str_t chunk;
+    size_t len;
+    int is_wild;
+    _z_list_t *vals;
+    struct _zn_rname_trie_node_t **literals;
+    size_t literals_len;
+    size_t literals_cap;
+    _z_list_t *wilds;
+    size_t mark;
+} _zn_rname_trie_node_t;
+
+/**
+ * A trie indexing values by resource name. The matching follows the same
+ * semantic of :c:func:`zn_rname_intersect`, i.e., both the registered resource
+ * names and the matched resource name may contain ``*`` and ``**`` wildcards.
+ * Literal chunks are looked up with a binary search, so matching a resource
+ * name without wildcards costs O(depth * log(fanout)) plus the wildcard branches.
+ *
+ * Members:
+ *   _zn_rname_trie_node_t *root: The root of the trie.
+ *   size_t epoch: The counter used to report each node at most once per matching.
+ */
+typedef struct
+{
+    _zn_rname_trie_node_t *root;
+    size_t epoch;
+} _zn_rname_trie_t;
+
+typedef void (*_zn_rname_trie_visit_f)(void *val, void *arg);
+
+void _zn_rname_trie_init(_zn_rname_trie_t *trie);
+
+int _zn_rname_trie_insert(_zn_rname_trie_t *trie, const z_str_t rname, void *val);
+int _zn_rname_trie_remove(_zn_rname_trie_t *trie, const z_str_t rname, z_element_eq_f f, void *val);
+
+size_t _zn_rname_trie_match(_zn_rname_trie_t *trie, const z_str_t rname, _zn_rname_trie_visit_f f, void *arg);
+
+void _zn_rname_trie_clear(_zn_rname_trie_t *trie);
+
+#endif /* ZENOH_PICO_PROTOCOL_RNAME_TRIE_H */
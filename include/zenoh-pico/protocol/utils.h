@@ -31,6 +31,12 @@
  */
 int zn_rname_intersect(const z_str_t left, const z_str_t right);
 
+/**
+ * Intersects the first chunk of two resource names, i.e., the characters up to
+ * the first ``/``, using the same semantic of :c:func:`zn_rname_intersect`.
+ */
+int _zn_rname_chunk_intersect(const z_str_t left, const z_str_t right);
+
 /*------------------ clone/Copy/Free helpers ------------------*/
 zn_reskey_t _zn_reskey_duplicate(const zn_reskey_t *resky);
 z_timestamp_t z_timestamp_duplicate(const z_timestamp_t *tstamp);
@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#ifndef ZENOH_PICO_SESSION_DISPATCH_H
+#define ZENOH_PICO_SESSION_DISPATCH_H
+
+#include "zenoh-pico/api/session.h"
+
+/*------------------ Dispatch pool ------------------*/
+_zn_dispatch_pool_t *_zn_dispatch_pool_init(zn_session_t *zn, size_t workers);
+int _zn_dispatch_pool_push(_zn_dispatch_pool_t *pool, _zn_subscriber_cache_entry_t *entry, const z_bytes_t payload);
+void _zn_dispatch_pool_free(_zn_dispatch_pool_t **pool);
+
+int _zn_start_dispatch_pool(zn_session_t *zn, size_t workers);
+int _zn_stop_dispatch_pool(zn_session_t *zn);
+
+void *_zn_dispatch_worker_task(void *arg);
+
+#endif /* ZENOH_PICO_SESSION_DISPATCH_H */
@@ -21,6 +21,8 @@
 z_zint_t _zn_get_entity_id(zn_session_t *zn);
 
 /*------------------ Resource ------------------*/
+size_t _zn_reskey_hash(const zn_reskey_t *reskey);
+int _zn_reskey_eq(const zn_reskey_t *left, const zn_reskey_t *right);
 z_zint_t _zn_get_resource_id(zn_session_t *zn);
 _zn_resource_t *_zn_get_resource_by_id(zn_session_t *zn, int is_local, z_zint_t rid);
 _zn_resource_t *_zn_get_resource_by_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey);
@@ -31,6 +33,7 @@ void _zn_flush_resources(zn_session_t *zn);
 
 z_str_t __unsafe_zn_get_resource_name_from_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey);
 _zn_resource_t *__unsafe_zn_get_resource_by_id(zn_session_t *zn, int is_local, z_zint_t id);
+_zn_resource_t *__unsafe_zn_get_resource_by_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey);
 _zn_resource_t *__unsafe_zn_get_resource_matching_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey);
 
 #endif /* ZENOH_PICO_SESSION_RESOURCE_H */
@@ -18,6 +18,7 @@
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/transport/manager.h"
 #include "zenoh-pico/collections/list.h"
+#include "zenoh-pico/collections/intmap.h"
 #include "zenoh-pico/collections/string.h"
 
 #define _ZN_RESOURCE_REMOTE 0
@@ -109,12 +110,26 @@ void _zn_resource_clear(_zn_resource_t *res);
 
 _Z_ELEM_DEFINE(_zn_resource, _zn_resource_t, _zn_noop_size, _zn_resource_clear, _zn_noop_copy)
 _Z_LIST_DEFINE(_zn_resource, _zn_resource_t)
+_Z_INT_MAP_DEFINE(_zn_resource, _zn_resource_t)
 
 /**
  * The callback signature of the functions handling data messages.
+ * The key and the value of the sample are borrowed from the session and the
+ * transport buffers: they are only valid for the duration of the callback and
+ * must be copied to be used afterwards.
  */
 typedef void (*zn_data_handler_t)(const zn_sample_t *sample, const void *arg);
 
+/**
+ * A subscription. Local subscriptions are reference counted: the session holds
+ * one reference while the subscription is declared and each snapshot of the
+ * dispatch cache holds another one. Once undeclared, a subscription is marked
+ * as dead so that the snapshots still in flight skip its callback.
+ *
+ * Members:
+ *   size_t refcount: The number of references to a local subscription.
+ *   int dead: Whether the subscription has been undeclared, read without the session lock.
+ */
 typedef struct
 {
     z_zint_t id;
@@ -123,6 +138,8 @@ typedef struct
     zn_subinfo_t info;
     zn_data_handler_t callback;
     void *arg;
+    size_t refcount;
+    int dead;
 } _zn_subscriber_t;
 
 int _zn_subscriber_eq(const _zn_subscriber_t *one, const _zn_subscriber_t *two);
@@ -131,6 +148,109 @@ void _zn_subscriber_clear(_zn_subscriber_t *sub);
 _Z_ELEM_DEFINE(_zn_subscriber, _zn_subscriber_t, _zn_noop_size, _zn_subscriber_clear, _zn_noop_copy)
 _Z_LIST_DEFINE(_zn_subscriber, _zn_subscriber_t)
 
+/**
+ * A handler of a local subscription, holding a reference on the subscription
+ * so that it outlives its undeclaration while a snapshot still points to it.
+ */
+typedef struct
+{
+    _zn_subscriber_t *sub;
+} _zn_subscriber_handler_t;
+
+/**
+ * An immutable snapshot of the resolution of a resource key into its resource
+ * name and the handlers of the matching local subscriptions. Snapshots are
+ * reference counted: the cache holds one reference and each dispatch in
+ * progress holds another one, so that the handlers are invoked without
+ * holding the session lock while declarations proceed concurrently.
+ * The snapshots alive are linked together, so that undeclaring a subscription
+ * waits for the deliveries in progress on the snapshots pointing to it.
+ *
+ * Members:
+ *   size_t refcount: The number of references to this snapshot.
+ *   size_t active: The number of deliveries in progress on this snapshot.
+ *   z_condvar_t idle: Signaled when the last delivery in progress returns.
+ *   zn_reskey_t key: A copy of the resource key.
+ *   size_t hash: The hash of the resource name, used to pick a dispatch worker.
+ *   z_str_t rname: The complete resource name.
+ *   size_t len: The number of handlers.
+ *   _zn_subscriber_handler_t *handlers: The handlers of the matching local subscriptions.
+ *   struct _zn_subscriber_cache_entry_t *next: The next snapshot alive in the session.
+ *   struct _zn_subscriber_cache_entry_t **pprev: The link pointing to this snapshot.
+ */
+typedef struct _zn_subscriber_cache_entry_t
+{
+    size_t refcount;
+    size_t active;
+    z_condvar_t idle;
+    zn_reskey_t key;
+    size_t hash;
+    z_str_t rname;
+    size_t len;
+    _zn_subscriber_handler_t *handlers;
+    struct _zn_subscriber_cache_entry_t *next;
+    struct _zn_subscriber_cache_entry_t **pprev;
+} _zn_subscriber_cache_entry_t;
+
+/**
+ * A sample waiting to be delivered by a dispatch worker.
+ *
+ * Members:
+ *   _zn_subscriber_cache_entry_t *entry: A reference on the snapshot of the matching subscriptions.
+ *   z_bytes_t payload: A copy of the payload of the sample.
+ */
+typedef struct
+{
+    _zn_subscriber_cache_entry_t *entry;
+    z_bytes_t payload;
+} _zn_dispatch_job_t;
+
+/**
+ * A dispatch worker delivering the samples of its bounded queue in order.
+ *
+ * Members:
+ *   void *session: A pointer to the session the worker belongs to.
+ *   z_task_t *task: The task running the worker loop.
+ *   volatile int running: Whether the worker accepts and processes new samples.
+ *   z_mutex_t mutex: The mutex protecting the queue.
+ *   z_condvar_t can_push: Signaled when a slot is freed in the queue.
+ *   z_condvar_t can_pop: Signaled when a sample is pushed or the worker is stopped.
+ *   size_t head: The index of the oldest sample in the queue.
+ *   size_t len: The number of samples in the queue.
+ *   _zn_dispatch_job_t jobs[]: The circular queue of samples.
+ */
+typedef struct
+{
+    void *session;
+    z_task_t *task;
+    volatile int running;
+    z_mutex_t mutex;
+    z_condvar_t can_push;
+    z_condvar_t can_pop;
+    size_t head;
+    size_t len;
+    _zn_dispatch_job_t jobs[ZN_DISPATCH_QUEUE_SIZE];
+} _zn_dispatch_worker_t;
+
+/**
+ * A pool of dispatch workers. Samples are assigned to a worker based on the
+ * hash of their resource name, so that samples for the same resource are
+ * delivered in the order they have been received.
+ *
+ * Members:
+ *   size_t users: The number of samples being pushed to the pool, protected by the session lock.
+ *   z_condvar_t idle: Signaled when the last push returns while the pool is being stopped.
+ *   size_t len: The number of workers.
+ *   _zn_dispatch_worker_t *workers: The workers.
+ */
+typedef struct
+{
+    size_t users;
+    z_condvar_t idle;
+    size_t len;
+    _zn_dispatch_worker_t *workers;
+} _zn_dispatch_pool_t;
+
 /**
  * The callback signature of the functions handling query messages.
  */
@@ -184,6 +304,8 @@ typedef struct
     _zn_pending_reply_list_t *pending_replies;
     zn_query_handler_t callback;
     void *arg;
+    // Deadline of the final reply, the query is completed when it expires
+    _zn_timer_t timer;
 } _zn_pending_query_t;
 
 int _zn_pending_query_eq(const _zn_pending_query_t *one, const _zn_pending_query_t *two);
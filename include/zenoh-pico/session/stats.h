@@ -0,0 +1,179 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_SESSION_STATS_H
+#define ZENOH_PICO_SESSION_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/msg.h"
+#include "zenoh-pico/system/platform.h"
+
+#define ZN_STATS_MID_NUM 32
+#define ZN_STATS_RELIABILITY_NUM 2
+
+/**
+ * The histograms are log-linear: each power of two is split in 2^ZN_STATS_HIST_SUB_BITS
+ * buckets of the same width, so that the relative error of the recorded values is bounded
+ * by 1 / 2^ZN_STATS_HIST_SUB_BITS. Values from 2^ZN_STATS_HIST_MAX_BITS microseconds
+ * (i.e., about one minute) are recorded in the last bucket.
+ */
+#define ZN_STATS_HIST_SUB_BITS 2
+#define ZN_STATS_HIST_MAX_BITS 26
+#define ZN_STATS_HIST_BUCKETS ((ZN_STATS_HIST_MAX_BITS - ZN_STATS_HIST_SUB_BITS + 1) << ZN_STATS_HIST_SUB_BITS)
+
+/**
+ * A histogram of durations in microseconds.
+ *
+ * Members:
+ *   size_t count: The number of recorded values.
+ *   size_t sum: The sum of the recorded values.
+ *   size_t max: The maximum recorded value.
+ *   size_t buckets[]: The number of recorded values in each bucket, see :c:func:`zn_histogram_bucket_upper`.
+ */
+typedef struct
+{
+    size_t count;
+    size_t sum;
+    size_t max;
+    size_t buckets[ZN_STATS_HIST_BUCKETS];
+} zn_histogram_t;
+
+/**
+ * The traffic counters of a direction of a session.
+ *
+ * Members:
+ *   size_t bytes: The number of bytes sent or received on the link.
+ *   size_t t_msgs: The number of transport messages, each frame or fragment counting as one.
+ *   size_t z_msgs: The number of zenoh messages.
+ *   size_t frames[]: The number of frames, indexed by :c:type:`zn_reliability_t`.
+ *   size_t z_msgs_by_reliability[]: The number of zenoh messages, indexed by :c:type:`zn_reliability_t`.
+ *   size_t msgs_by_mid[]: The number of transport and zenoh messages, indexed by message ID.
+ */
+typedef struct
+{
+    size_t bytes;
+    size_t t_msgs;
+    size_t z_msgs;
+    size_t frames[ZN_STATS_RELIABILITY_NUM];
+    size_t z_msgs_by_reliability[ZN_STATS_RELIABILITY_NUM];
+    size_t msgs_by_mid[ZN_STATS_MID_NUM];
+} zn_stats_traffic_t;
+
+/**
+ * The runtime statistics of a session.
+ *
+ * Members:
+ *   zn_stats_traffic_t tx: The counters of the sent messages.
+ *   zn_stats_traffic_t rx: The counters of the received messages.
+ *   size_t dropped_congestion: The zenoh messages dropped because of the congestion control.
+ *   size_t dropped_out_of_order: The frames dropped because their sequence number is out of order.
+ *   size_t dropped_fragments: The zenoh messages dropped because they exceed ``ZN_FRAG_MAX_SIZE``.
+ *   size_t malformed: The received messages that could not be decoded.
+ *   size_t retransmitted: The reliable frames retransmitted on request of the remote peers.
+ *   size_t lost: The reliable frames skipped because they could no longer be retransmitted.
+ *   zn_histogram_t callback_us: The execution time of the subscription, queryable and reply callbacks.
+ *   zn_histogram_t send_us: The time taken to send a zenoh message, including the time spent
+ *                           waiting for the transport.
+ */
+typedef struct
+{
+    zn_stats_traffic_t tx;
+    zn_stats_traffic_t rx;
+    size_t dropped_congestion;
+    size_t dropped_out_of_order;
+    size_t dropped_fragments;
+    size_t malformed;
+    size_t retransmitted;
+    size_t lost;
+    zn_histogram_t callback_us;
+    zn_histogram_t send_us;
+} zn_stats_t;
+
+/**
+ * Get the smallest value recorded in the bucket following a given bucket of a histogram,
+ * i.e., the exclusive upper bound of the values recorded in the given bucket.
+ *
+ * Parameters:
+ *     bucket: The index of the bucket.
+ * Returns:
+ *     The upper bound in microseconds.
+ */
+size_t zn_histogram_bucket_upper(size_t bucket);
+
+/**
+ * Estimate a percentile of the values recorded in a histogram.
+ *
+ * Parameters:
+ *     h: The histogram.
+ *     percentile: The percentile, between ``0`` and ``100``.
+ * Returns:
+ *     The largest value in microseconds of the bucket holding the percentile, capped by the
+ *     maximum recorded value, or ``0`` if the histogram is empty.
+ */
+size_t zn_histogram_percentile(const zn_histogram_t *h, double percentile);
+
+/*------------------ Statistics helpers ------------------*/
+void _zn_stats_add(size_t *counter, size_t n);
+void _zn_stats_traffic(zn_stats_traffic_t *t, uint8_t header, size_t bytes);
+void _zn_stats_z_msg(zn_stats_traffic_t *t, uint8_t header, zn_reliability_t reliability);
+void _zn_histogram_record(zn_histogram_t *h, z_clock_t *start);
+void _zn_stats_snapshot(const zn_stats_t *src, zn_stats_t *dst);
+void _zn_stats_reset(zn_stats_t *stats);
+
+/**
+ * The statistics are updated through the following macros, that compile to nothing
+ * when ZN_STATS is disabled. The session may be given as a void pointer, as stored by
+ * the transports, and is ignored when null.
+ */
+#define _ZN_STATS_FRAME_HEADER(reliability) ((uint8_t)(_ZN_MID_FRAME | ((reliability) == zn_reliability_t_RELIABLE ? _ZN_FLAG_T_R : 0)))
+
+#if ZN_STATS == 1
+#define _ZN_STATS_ADD(zn, counter, n)                                 \
+    do                                                                \
+    {                                                                 \
+        if ((zn) != NULL)                                             \
+            _zn_stats_add(&((zn_session_t *)(zn))->stats.counter, n); \
+    } while (0)
+#define _ZN_STATS_INC(zn, counter) _ZN_STATS_ADD(zn, counter, 1)
+#define _ZN_STATS_TRAFFIC(zn, dir, header, bytes)                                  \
+    do                                                                             \
+    {                                                                              \
+        if ((zn) != NULL)                                                          \
+            _zn_stats_traffic(&((zn_session_t *)(zn))->stats.dir, header, bytes); \
+    } while (0)
+#define _ZN_STATS_Z_MSG(zn, dir, header, reliability)                                  \
+    do                                                                                 \
+    {                                                                                  \
+        if ((zn) != NULL)                                                              \
+            _zn_stats_z_msg(&((zn_session_t *)(zn))->stats.dir, header, reliability); \
+    } while (0)
+#define _ZN_STATS_CLOCK(start) z_clock_t start = z_clock_now()
+#define _ZN_STATS_RECORD(zn, histogram, start)                                    \
+    do                                                                            \
+    {                                                                             \
+        if ((zn) != NULL)                                                         \
+            _zn_histogram_record(&((zn_session_t *)(zn))->stats.histogram, &start); \
+    } while (0)
+#else
+#define _ZN_STATS_ADD(zn, counter, n) (void)(zn)
+#define _ZN_STATS_INC(zn, counter) (void)(zn)
+#define _ZN_STATS_TRAFFIC(zn, dir, header, bytes) (void)(zn)
+#define _ZN_STATS_Z_MSG(zn, dir, header, reliability) (void)(zn)
+#define _ZN_STATS_CLOCK(start) (void)0
+#define _ZN_STATS_RECORD(zn, histogram, start) (void)(zn)
+#endif
+
+#endif /* ZENOH_PICO_SESSION_STATS_H */
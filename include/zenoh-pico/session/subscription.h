@@ -24,9 +24,15 @@ _zn_subscriber_list_t *_zn_get_subscription_by_key(zn_session_t *zn, int is_loca
 
 int _zn_register_subscription(zn_session_t *zn, int is_local, _zn_subscriber_t *sub);
 int _zn_trigger_subscriptions(zn_session_t *zn, const zn_reskey_t reskey, const z_bytes_t payload);
+void _zn_deliver_subscriptions(zn_session_t *zn, const _zn_subscriber_cache_entry_t *entry, const z_bytes_t payload);
+void _zn_activate_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry);
+void _zn_deactivate_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry);
+void _zn_release_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry);
 void _zn_unregister_subscription(zn_session_t *zn, int is_local, _zn_subscriber_t *sub);
 void _zn_flush_subscriptions(zn_session_t *zn);
 
+void __unsafe_zn_invalidate_subscriptions_cache(zn_session_t *zn);
+
 /*------------------ Pull ------------------*/
 z_zint_t _zn_get_pull_id(zn_session_t *zn);
 
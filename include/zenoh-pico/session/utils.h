@@ -25,6 +25,6 @@ int _zn_session_close(zn_session_t *zn, uint8_t reason);
 void _zn_session_free(zn_session_t **zn);
 
 int _zn_handle_zenoh_message(zn_session_t *zn, _zn_zenoh_message_t *z_msg);
-int _zn_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl);
+int _zn_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority);
 
 #endif /* ZENOH_PICO_SESSION_UTILS_H */
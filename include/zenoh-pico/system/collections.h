@@ -15,8 +15,18 @@
 #ifndef ZENOH_PICO_SYSTEM_COLLECTIONS_H
 #define ZENOH_PICO_SYSTEM_COLLECTIONS_H
 
+#include <stddef.h>
 #include "zenoh-pico/system/platform.h"
 
+#if defined(ZENOH_LINUX) || defined(ZENOH_MACOS)
+#include <stdatomic.h>
+#define Z_RING_LOCK_FREE 1
+typedef atomic_size_t z_atomic_size_t;
+#else
+#define Z_RING_LOCK_FREE 0
+typedef size_t z_atomic_size_t;
+#endif
+
 /*-------- Mvar --------*/
 typedef struct
 {
@@ -34,4 +44,102 @@ z_mvar_t *z_mvar_of(void *e);
 void *z_mvar_get(z_mvar_t *mv);
 void z_mvar_put(z_mvar_t *mv, void *e);
 
+/*-------- Ring --------*/
+/**
+ * A bounded FIFO ring of non-null pointers, for a single producer and a single
+ * consumer. Push and pull never block: they fail when the ring is respectively
+ * full or empty. The ring is lock-free on platforms providing C11 atomics, and
+ * protected by a mutex otherwise.
+ *
+ * Members:
+ *   size_t mask: The capacity of the ring minus one, the capacity being a power of two.
+ *   z_atomic_size_t head: The position of the next element to pull, written by the consumer.
+ *   z_atomic_size_t tail: The position of the next element to push, written by the producer.
+ *   void **elems: The elements.
+ */
+typedef struct
+{
+    size_t mask;
+    z_atomic_size_t head;
+    z_atomic_size_t tail;
+    void **elems;
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_t mtx;
+#endif
+} z_spsc_ring_t;
+
+z_spsc_ring_t *z_spsc_ring_make(size_t capacity);
+size_t z_spsc_ring_capacity(const z_spsc_ring_t *r);
+int z_spsc_ring_push(z_spsc_ring_t *r, void *e);
+void *z_spsc_ring_pull(z_spsc_ring_t *r);
+void z_spsc_ring_free(z_spsc_ring_t **r);
+
+typedef struct
+{
+    z_atomic_size_t seq;
+    void *elem;
+} z_mpsc_ring_cell_t;
+
+/**
+ * A bounded FIFO ring of non-null pointers, for multiple producers and a single
+ * consumer. Each cell carries a sequence number telling whether it is ready to
+ * be written or read, so that producers only contend on the tail position.
+ * Push and pull never block: they fail when the ring is respectively full or
+ * empty. The ring is lock-free on platforms providing C11 atomics, and protected
+ * by a mutex otherwise.
+ *
+ * Members:
+ *   size_t mask: The capacity of the ring minus one, the capacity being a power of two.
+ *   size_t head: The position of the next element to pull, only accessed by the consumer.
+ *   z_atomic_size_t tail: The position of the next element to push, shared by the producers.
+ *   z_mpsc_ring_cell_t *cells: The cells.
+ */
+typedef struct
+{
+    size_t mask;
+    size_t head;
+    z_atomic_size_t tail;
+    z_mpsc_ring_cell_t *cells;
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_t mtx;
+#endif
+} z_mpsc_ring_t;
+
+z_mpsc_ring_t *z_mpsc_ring_make(size_t capacity);
+size_t z_mpsc_ring_capacity(const z_mpsc_ring_t *r);
+int z_mpsc_ring_push(z_mpsc_ring_t *r, void *e);
+void *z_mpsc_ring_pull(z_mpsc_ring_t *r);
+void z_mpsc_ring_free(z_mpsc_ring_t **r);
+
+/**
+ * A bounded blocking FIFO queue of non-null pointers, for multiple producers
+ * and a single consumer. It is built on top of a :c:type:`z_mpsc_ring_t`: the
+ * mutex and the condition variables are only used when a producer finds the
+ * queue full or the consumer finds it empty.
+ *
+ * Members:
+ *   z_mpsc_ring_t *ring: The ring holding the elements.
+ *   z_atomic_size_t waiting_put: The number of producers waiting for a free slot.
+ *   z_atomic_size_t waiting_get: The number of consumers waiting for an element.
+ *   z_mutex_t mtx: The mutex protecting the waits.
+ *   z_condvar_t can_put: Signaled when an element is pulled.
+ *   z_condvar_t can_get: Signaled when an element is pushed.
+ */
+typedef struct
+{
+    z_mpsc_ring_t *ring;
+    z_atomic_size_t waiting_put;
+    z_atomic_size_t waiting_get;
+    z_mutex_t mtx;
+    z_condvar_t can_put;
+    z_condvar_t can_get;
+} z_ring_queue_t;
+
+z_ring_queue_t *z_ring_queue_make(size_t capacity);
+int z_ring_queue_try_put(z_ring_queue_t *q, void *e);
+void z_ring_queue_put(z_ring_queue_t *q, void *e);
+void *z_ring_queue_try_get(z_ring_queue_t *q);
+void *z_ring_queue_get(z_ring_queue_t *q);
+void z_ring_queue_free(z_ring_queue_t **q);
+
 #endif /* ZENOH_PICO_SYSTEM_COLLECTIONS_H */
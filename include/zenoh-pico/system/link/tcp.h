@@ -16,6 +16,7 @@
 #define ZENOH_PICO_SYSTEM_LINK_TCP_H
 
 #include <stdint.h>
+#include "zenoh-pico/collections/bytes.h"
 #include "zenoh-pico/collections/string.h"
 
 #if ZN_LINK_TCP == 1
@@ -35,6 +36,7 @@ void _zn_close_tcp(int sock);
 size_t _zn_read_exact_tcp(int sock, uint8_t *ptr, size_t len);
 size_t _zn_read_tcp(int sock, uint8_t *ptr, size_t len);
 size_t _zn_send_tcp(int sock, const uint8_t *ptr, size_t len);
+size_t _zn_send_vec_tcp(int sock, const z_bytes_t *bufs, size_t n);
 #endif
 
 #endif /* ZENOH_PICO_SYSTEM_LINK_TCP_H */
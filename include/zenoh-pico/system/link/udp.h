@@ -16,6 +16,7 @@
 #define ZENOH_PICO_SYSTEM_LINK_UDP_H
 
 #include <stdint.h>
+#include "zenoh-pico/collections/bytes.h"
 #include "zenoh-pico/collections/string.h"
 
 #if ZN_LINK_UDP_UNICAST == 1 || ZN_LINK_UDP_MULTICAST == 1
@@ -38,6 +39,7 @@ void _zn_close_udp_unicast(int sock);
 size_t _zn_read_exact_udp_unicast(int sock, uint8_t *ptr, size_t len);
 size_t _zn_read_udp_unicast(int sock, uint8_t *ptr, size_t len);
 size_t _zn_send_udp_unicast(int sock, const uint8_t *ptr, size_t len, void *arg);
+size_t _zn_send_vec_udp_unicast(int sock, const z_bytes_t *bufs, size_t n, void *arg);
 
 // Multicast
 int _zn_open_udp_multicast(void *arg_1, void **arg_2, const clock_t tout, const z_str_t iface);
@@ -46,6 +48,7 @@ void _zn_close_udp_multicast(int sock_recv, int sock_send, void *arg);
 size_t _zn_read_exact_udp_multicast(int sock, uint8_t *ptr, size_t len, void *arg, z_bytes_t *addr);
 size_t _zn_read_udp_multicast(int sock, uint8_t *ptr, size_t len, void *arg, z_bytes_t *addr);
 size_t _zn_send_udp_multicast(int sock, const uint8_t *ptr, size_t len, void *arg);
+size_t _zn_send_vec_udp_multicast(int sock, const z_bytes_t *bufs, size_t n, void *arg);
 #endif
 
 #endif /* ZENOH_PICO_SYSTEM_LINK_UDP_H */
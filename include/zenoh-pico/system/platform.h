@@ -15,6 +15,9 @@
 #ifndef ZENOH_PICO_SYSTEM_COMMON_H
 #define ZENOH_PICO_SYSTEM_COMMON_H
 
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/system/pool.h"
+
 #if defined(ZENOH_LINUX) || defined(ZENOH_MACOS)
 #include "zenoh-pico/system/platform/unix.h"
 #elif defined(ZENOH_ESPIDF)
@@ -38,9 +41,22 @@ uint64_t z_random_u64(void);
 void z_random_fill(void *buf, size_t len);
 
 /*------------------ Memory ------------------*/
+void *z_sys_malloc(size_t size);
+void *z_sys_realloc(void *ptr, size_t size);
+void z_sys_free(void *ptr);
+
+#if ZN_MEMORY_POOL == 1
+#ifndef _Z_MEM_SUBSYSTEM
+#define _Z_MEM_SUBSYSTEM Z_MEM_OTHER
+#endif
+#define z_malloc(size) _z_pool_malloc(size, _Z_MEM_SUBSYSTEM)
+#define z_realloc(ptr, size) _z_pool_realloc(ptr, size, _Z_MEM_SUBSYSTEM)
+#define z_free(ptr) _z_pool_free(ptr)
+#else
 void *z_malloc(size_t size);
 void *z_realloc(void *ptr, size_t size);
 void z_free(void *ptr);
+#endif
 
 /*------------------ Thread ------------------*/
 int z_task_init(z_task_t *task, z_task_attr_t *attr, void *(*fun)(void *), void *arg);
@@ -80,4 +96,21 @@ time_t z_time_elapsed_us(z_time_t *time);
 time_t z_time_elapsed_ms(z_time_t *time);
 time_t z_time_elapsed_s(z_time_t *time);
 
+/*------------------ Reactor ------------------*/
+#if Z_REACTOR == 1
+/**
+ * The callback called when a file descriptor registered in a reactor is ready to be read.
+ * It removes the file descriptor from the reactor by returning a negative value, or by calling
+ * z_reactor_remove.
+ */
+typedef int (*z_reactor_f)(void *arg);
+
+int z_reactor_init(z_reactor_t *r);
+int z_reactor_free(z_reactor_t *r);
+
+int z_reactor_add(z_reactor_t *r, int fd, z_reactor_f callback, void *arg);
+int z_reactor_remove(z_reactor_t *r, int fd);
+int z_reactor_wait(z_reactor_t *r, unsigned int tout);
+#endif
+
 #endif /* ZENOH_PICO_SYSTEM_COMMON_H */
@@ -15,6 +15,7 @@
 #ifndef ZENOH_PICO_SYSTEM_UNIX_TYPES_H
 #define ZENOH_PICO_SYSTEM_UNIX_TYPES_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <pthread.h>
 
@@ -26,4 +27,24 @@ typedef pthread_cond_t z_condvar_t;
 typedef struct timespec z_clock_t;
 typedef struct timeval z_time_t;
 
+// The sockets support gather writes
+#define Z_LINK_WRITE_VEC 1
+
+#if defined(ZENOH_LINUX)
+// The readiness of the sockets can be multiplexed with epoll
+#define Z_REACTOR 1
+
+struct z_reactor_handler_t;
+
+typedef struct
+{
+    int epfd;
+    pthread_mutex_t mutex;
+    pthread_cond_t idle;
+    struct z_reactor_handler_t **handlers;
+    size_t capacity;
+    uint32_t gen;
+} z_reactor_t;
+#endif
+
 #endif /* ZENOH_PICO_SYSTEM_UNIX_TYPES_H */
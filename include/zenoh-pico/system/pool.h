@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#ifndef ZENOH_PICO_SYSTEM_POOL_H
+#define ZENOH_PICO_SYSTEM_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define Z_POOL_MIN_BLOCK_SIZE 16
+#define Z_POOL_CLASSES_NUM 8
+
+/**
+ * The subsystems whose allocations are accounted separately by the memory pool.
+ * The allocations of a translation unit are attributed to the subsystem defined
+ * by _Z_MEM_SUBSYSTEM when compiling it, to Z_MEM_OTHER otherwise.
+ */
+typedef enum
+{
+    Z_MEM_OTHER = 0,
+    Z_MEM_TRANSPORT = 1,
+    Z_MEM_SESSION = 2,
+    Z_MEM_CODEC = 3,
+    Z_MEM_COLLECTIONS = 4,
+    Z_MEM_LINK = 5,
+    Z_MEM_SUBSYSTEMS_NUM = 6
+} z_mem_subsystem_t;
+
+/**
+ * Statistics of a size class of the memory pool.
+ *
+ * Members:
+ *   size_t block_size: The size of the blocks of the class, 0 for the allocations
+ *                      larger than the largest class, served by the platform allocator.
+ *   size_t blocks: The number of blocks carved from the chunks of the pool.
+ *   size_t in_use: The number of blocks currently allocated.
+ *   size_t peak: The maximum number of blocks allocated at the same time.
+ *   size_t allocs: The total number of allocations.
+ */
+typedef struct
+{
+    size_t block_size;
+    size_t blocks;
+    size_t in_use;
+    size_t peak;
+    size_t allocs;
+} z_pool_class_stats_t;
+
+/**
+ * Statistics of the allocations of a subsystem.
+ *
+ * Members:
+ *   size_t in_use: The number of bytes currently allocated.
+ *   size_t peak: The maximum number of bytes allocated at the same time.
+ *   size_t allocs: The total number of allocations.
+ *   size_t frees: The total number of deallocations.
+ */
+typedef struct
+{
+    size_t in_use;
+    size_t peak;
+    size_t allocs;
+    size_t frees;
+} z_pool_subsystem_stats_t;
+
+/**
+ * Statistics of the memory pool.
+ *
+ * Members:
+ *   z_pool_class_stats_t classes[]: The statistics of each size class, the last entry
+ *                                   accounts for the allocations larger than the largest class.
+ *   z_pool_subsystem_stats_t subsystems[]: The statistics of each subsystem.
+ *   size_t reserved: The number of bytes of the chunks requested to the platform allocator.
+ */
+typedef struct
+{
+    z_pool_class_stats_t classes[Z_POOL_CLASSES_NUM + 1];
+    z_pool_subsystem_stats_t subsystems[Z_MEM_SUBSYSTEMS_NUM];
+    size_t reserved;
+} z_pool_stats_t;
+
+void *_z_pool_malloc(size_t size, z_mem_subsystem_t subsystem);
+void *_z_pool_realloc(void *ptr, size_t size, z_mem_subsystem_t subsystem);
+void _z_pool_free(void *ptr);
+
+/**
+ * Get a snapshot of the statistics of the memory pool.
+ *
+ * Parameters:
+ *   stats: The statistics to fill.
+ */
+void z_pool_stats(z_pool_stats_t *stats);
+
+#endif /* ZENOH_PICO_SYSTEM_POOL_H */
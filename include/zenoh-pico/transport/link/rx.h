@@ -30,5 +30,6 @@ void _zn_multicast_recv_t_msg_na(_zn_transport_multicast_t *ztm, _zn_transport_m
 
 int _zn_unicast_handle_transport_message(_zn_transport_unicast_t *ztu, _zn_transport_message_t *t_msg);
 int _zn_multicast_handle_transport_message(_zn_transport_multicast_t *ztm, _zn_transport_message_t *t_msg, z_bytes_t *addr);
+void __unsafe_zn_multicast_drop_peer(_zn_transport_multicast_t *ztm, _zn_transport_peer_entry_t *entry);
 
 #endif /* ZENOH_PICO_TRANSPORT_LINK_RX_H */
\ No newline at end of file
@@ -25,4 +25,6 @@ void *_znp_lease_task(void *arg);
 void *_znp_unicast_lease_task(void *arg);
 void *_znp_multicast_lease_task(void *arg);
 
+void _znp_multicast_peer_lease_expired(_zn_timer_t *tmr, void *arg);
+
 #endif /* ZENOH_PICO_TRANSPORT_LINK_TASK_LEASE_H */
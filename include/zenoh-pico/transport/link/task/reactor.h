@@ -0,0 +1,35 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_LINK_TASK_REACTOR_H
+#define ZENOH_PICO_TRANSPORT_LINK_TASK_REACTOR_H
+
+#include "zenoh-pico/transport/transport.h"
+
+#if Z_REACTOR == 1
+_zn_reactor_t *_zn_reactor_init(size_t tasks);
+void _zn_reactor_free(_zn_reactor_t **reactor);
+
+int _zn_reactor_add(_zn_reactor_t *reactor, _zn_transport_t *zt);
+int _zn_reactor_unicast_add(_zn_reactor_t *reactor, _zn_transport_unicast_t *ztu);
+int _zn_reactor_multicast_add(_zn_reactor_t *reactor, _zn_transport_multicast_t *ztm);
+
+int _zn_reactor_remove(_zn_reactor_t *reactor, _zn_transport_t *zt);
+int _zn_reactor_unicast_remove(_zn_reactor_t *reactor, _zn_transport_unicast_t *ztu);
+int _zn_reactor_multicast_remove(_zn_reactor_t *reactor, _zn_transport_multicast_t *ztm);
+
+void *_znp_reactor_task(void *arg);
+#endif
+
+#endif /* ZENOH_PICO_TRANSPORT_LINK_TASK_REACTOR_H */
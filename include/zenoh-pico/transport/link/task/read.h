@@ -21,6 +21,9 @@ int _znp_read(_zn_transport_t *zt);
 int _znp_unicast_read(_zn_transport_unicast_t *ztu);
 int _znp_multicast_read(_zn_transport_multicast_t *ztm);
 
+int _znp_unicast_read_ready(void *arg);
+int _znp_multicast_read_ready(void *arg);
+
 void *_znp_read_task(void *arg);
 void *_znp_unicast_read_task(void *arg);
 void *_znp_multicast_read_task(void *arg);
@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#ifndef ZENOH_PICO_TRANSPORT_LINK_TASK_WRITE_H
+#define ZENOH_PICO_TRANSPORT_LINK_TASK_WRITE_H
+
+#include "zenoh-pico/transport/transport.h"
+
+int _znp_start_write_task(_zn_transport_t *zt);
+int _znp_unicast_start_write_task(_zn_transport_unicast_t *ztu);
+int _znp_multicast_start_write_task(_zn_transport_multicast_t *ztm);
+
+int _znp_stop_write_task(_zn_transport_t *zt);
+int _znp_unicast_stop_write_task(_zn_transport_unicast_t *ztu);
+int _znp_multicast_stop_write_task(_zn_transport_multicast_t *ztm);
+
+void *_znp_unicast_write_task(void *arg);
+void *_znp_multicast_write_task(void *arg);
+
+#endif /* ZENOH_PICO_TRANSPORT_LINK_TASK_WRITE_H */
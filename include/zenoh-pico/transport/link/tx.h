@@ -21,12 +21,20 @@
 
 void __unsafe_zn_prepare_wbuf(_z_wbuf_t *buf, int is_streamed);
 void __unsafe_zn_finalize_wbuf(_z_wbuf_t *buf, int is_streamed);
-_zn_transport_message_t __zn_frame_header(zn_reliability_t reliability, int is_fragment, int is_final, z_zint_t sn);
-int __unsafe_zn_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, zn_reliability_t reliability, size_t sn);
+void __unsafe_zn_finalize_frame(_z_wbuf_t *buf, int is_streamed, size_t ext_len);
+_zn_transport_message_t __zn_frame_header(zn_reliability_t reliability, zn_priority_t priority, int is_fragment, int is_final, z_zint_t sn);
+int __unsafe_zn_serialize_frame(_z_wbuf_t *dst, const _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_priority_t priority, int *is_fragment, size_t bytes_left, z_zint_t sn);
+int __zn_link_send_frame(const _zn_link_t *link, const _z_wbuf_t *wbf, const uint8_t *bs, size_t len);
+z_bytes_t _zn_zenoh_message_payload(const _zn_zenoh_message_t *z_msg);
+int _zn_zenoh_message_flatten(z_bytes_t *bs, const _zn_zenoh_message_t *z_msg);
+
+/*------------------ Zero-copy helpers ------------------*/
+int __unsafe_zn_unicast_send_frames(_zn_transport_unicast_t *ztu, const _zn_zenoh_message_t *z_msg, const z_bytes_t *bs, zn_reliability_t reliability, zn_priority_t priority, z_zint_t sn);
+int __unsafe_zn_multicast_send_frames(_zn_transport_multicast_t *ztm, const _zn_zenoh_message_t *z_msg, const z_bytes_t *bs, zn_reliability_t reliability, zn_priority_t priority, z_zint_t sn);
 
 /*------------------ Transmission and Reception helpers ------------------*/
-int _zn_unicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl);
-int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl);
+int _zn_unicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority);
+int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority);
 
 int _zn_send_t_msg(_zn_transport_t *zt, const _zn_transport_message_t *t_msg);
 int _zn_unicast_send_t_msg(_zn_transport_unicast_t *ztu, const _zn_transport_message_t *t_msg);
@@ -34,4 +42,32 @@ int _zn_multicast_send_t_msg(_zn_transport_multicast_t *ztm, const _zn_transport
 
 int _zn_link_send_t_msg(const _zn_link_t *zl, const _zn_transport_message_t *t_msg);
 
+/*------------------ TX queue helpers ------------------*/
+int _zn_enqueue_z_msg(zn_session_t *zn, z_ring_queue_t *q, const _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority);
+int __unsafe_zn_unicast_write_encoded(_zn_transport_unicast_t *ztu, const z_bytes_t *msg, zn_reliability_t reliability, zn_priority_t priority, size_t *pos);
+int __unsafe_zn_multicast_write_encoded(_zn_transport_multicast_t *ztm, const z_bytes_t *msg, zn_reliability_t reliability, zn_priority_t priority, size_t *pos);
+
+/*------------------ Batching helpers ------------------*/
+int _zn_flush(_zn_transport_t *zt);
+int _zn_unicast_flush(_zn_transport_unicast_t *ztu);
+int _zn_multicast_flush(_zn_transport_multicast_t *ztm);
+int __unsafe_zn_unicast_flush(_zn_transport_unicast_t *ztu);
+int __unsafe_zn_multicast_flush(_zn_transport_multicast_t *ztm);
+int __unsafe_zn_unicast_flush_expired(_zn_transport_unicast_t *ztu);
+int __unsafe_zn_multicast_flush_expired(_zn_transport_multicast_t *ztm);
+int _zn_unicast_flush_expired(_zn_transport_unicast_t *ztu);
+int _zn_multicast_flush_expired(_zn_transport_multicast_t *ztm);
+int _zn_batch_start(_zn_transport_t *zt);
+int _zn_unicast_batch_start(_zn_transport_unicast_t *ztu);
+int _zn_multicast_batch_start(_zn_transport_multicast_t *ztm);
+int _zn_batch_flush(_zn_transport_t *zt);
+int _zn_unicast_batch_flush(_zn_transport_unicast_t *ztu);
+int _zn_multicast_batch_flush(_zn_transport_multicast_t *ztm);
+
+/*------------------ Reliability helpers ------------------*/
+int _zn_unicast_retransmit(_zn_transport_unicast_t *ztu, z_zint_t sn, z_zint_t mask);
+int _zn_multicast_retransmit(_zn_transport_multicast_t *ztm, z_zint_t sn, z_zint_t mask);
+int _zn_unicast_sync_expired(_zn_transport_unicast_t *ztu);
+int _zn_multicast_sync_expired(_zn_transport_multicast_t *ztm);
+
 #endif /* ZENOH_PICO_TRANSPORT_LINK_TX_H */
\ No newline at end of file
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_TIMER_H
+#define ZENOH_PICO_TRANSPORT_TIMER_H
+
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/system/platform.h"
+
+#define _ZN_TIMER_IDLE SIZE_MAX
+
+struct _zn_timer_t;
+
+/**
+ * The callback signature of the functions called upon the expiration of a timer.
+ * The timer is passed to identify it: unless it is owned by an object that outlives the
+ * timer service, it must only be dereferenced once claimed with _zn_timers_claim.
+ */
+typedef void (*_zn_timer_f)(struct _zn_timer_t *tmr, void *arg);
+
+/**
+ * A deadline of the timer service, embedded in the object it belongs to.
+ *
+ * Members:
+ *   z_zint_t deadline: The expiration time in milliseconds, relative to the start of the timer service.
+ *   _zn_timer_f callback: The function called upon expiration.
+ *   void *arg: The argument passed to the callback.
+ *   size_t idx: The position of the timer in the heap, or _ZN_TIMER_IDLE when not scheduled.
+ */
+typedef struct _zn_timer_t
+{
+    z_zint_t deadline;
+    _zn_timer_f callback;
+    void *arg;
+    size_t idx;
+} _zn_timer_t;
+
+/**
+ * A timer service: the scheduled timers are kept in a binary min-heap ordered by deadline,
+ * so that scheduling, cancelling and expiring a timer is O(log n) and finding the next
+ * deadline is O(1). The callbacks are called with the timer service mutex released.
+ *
+ * Members:
+ *   z_mutex_t mutex: The mutex protecting the heap.
+ *   z_clock_t start: The time origin of the deadlines.
+ *   _zn_timer_t **heap: The scheduled timers.
+ *   size_t len: The number of scheduled timers.
+ *   size_t capacity: The capacity of the heap.
+ *   _zn_timer_t *firing: The expired timer whose callback is being called, until it is claimed or cancelled.
+ */
+typedef struct
+{
+    z_mutex_t mutex;
+    z_clock_t start;
+    _zn_timer_t **heap;
+    size_t len;
+    size_t capacity;
+    _zn_timer_t *firing;
+} _zn_timers_t;
+
+void _zn_timer_init(_zn_timer_t *tmr, _zn_timer_f callback, void *arg);
+int _zn_timer_is_scheduled(const _zn_timer_t *tmr);
+
+int _zn_timers_init(_zn_timers_t *tms);
+void _zn_timers_clear(_zn_timers_t *tms);
+z_zint_t _zn_timers_now(_zn_timers_t *tms);
+
+int _zn_timers_schedule(_zn_timers_t *tms, _zn_timer_t *tmr, z_zint_t delay);
+void _zn_timers_cancel(_zn_timers_t *tms, _zn_timer_t *tmr);
+int _zn_timers_claim(_zn_timers_t *tms, _zn_timer_t *tmr);
+
+z_zint_t _zn_timers_expire(_zn_timers_t *tms);
+void _zn_timers_run(_zn_timers_t *tms, volatile int *running);
+
+#endif /* ZENOH_PICO_TRANSPORT_TIMER_H */
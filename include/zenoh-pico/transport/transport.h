@@ -19,14 +19,79 @@
 #include "zenoh-pico/protocol/msg.h"
 #include "zenoh-pico/link/link.h"
 #include "zenoh-pico/collections/bytes.h"
+#include "zenoh-pico/system/collections.h"
+#include "zenoh-pico/transport/timer.h"
+
+/**
+ * A defragmentation buffer, where the fragments of a zenoh message are reassembled
+ * and then decoded in place. Its memory is only allocated once fragments are received.
+ *
+ * Members:
+ *   _z_zbuf_t zbf: The reassembled fragments, decoded once the final fragment is received.
+ *   int is_dropping: Whether the zenoh message is dropped because it exceeds ZN_FRAG_MAX_SIZE.
+ */
+typedef struct
+{
+    _z_zbuf_t zbf;
+    int is_dropping;
+} _zn_defrag_buf_t;
+
+/**
+ * The retransmission window of a reliable channel, on the links that do not guarantee the delivery.
+ * The serialized reliable frames are kept until the remote peer acknowledges them with an ACK_NACK
+ * message, and are retransmitted when it reports them as missing. When the window is full, the
+ * oldest frame is evicted and can no longer be retransmitted.
+ *
+ * Members:
+ *   z_bytes_t frames[]: The serialized frames with consecutive SNs, the oldest one at position head.
+ *   size_t head: The position of the oldest frame.
+ *   size_t len: The number of frames in the window.
+ *   z_zint_t base: The SN of the oldest frame.
+ *   z_zint_t synced: The next SN announced by the last SYNC message.
+ *   z_clock_t last_sync: The time the last SYNC message was sent.
+ */
+typedef struct
+{
+    z_bytes_t frames[ZN_RELIABILITY_WINDOW_SIZE];
+    size_t head;
+    size_t len;
+    z_zint_t base;
+    z_zint_t synced;
+    z_clock_t last_sync;
+} _zn_tx_window_t;
+
+/**
+ * The reorder buffer of a reliable channel, on the links that do not guarantee the delivery.
+ * The reliable frames received ahead of the next expected SN are kept until the missing ones
+ * are retransmitted, and are then handled in order.
+ *
+ * Members:
+ *   z_bytes_t frames[]: The payloads of the frames received ahead, the frame with SN next + i at position i,
+ *                       where next is the next expected SN. The position 0 is only used while skipping lost frames.
+ *   uint8_t headers[]: The headers of the frames received ahead.
+ *   size_t len: The number of frames received ahead.
+ *   z_zint_t acked: The next expected SN when the last ACK_NACK message was sent.
+ *   z_clock_t gap_start: The time since when the frames received ahead wait for the next expected SN.
+ */
+typedef struct
+{
+    z_bytes_t frames[ZN_RELIABILITY_WINDOW_SIZE];
+    uint8_t headers[ZN_RELIABILITY_WINDOW_SIZE];
+    size_t len;
+    z_zint_t acked;
+    z_clock_t gap_start;
+} _zn_reorder_buf_t;
 
 typedef struct
 {
-    // Defragmentation buffers
-    _z_wbuf_t dbuf_reliable;
-    _z_wbuf_t dbuf_best_effort;
+    // Defragmentation buffers, one per priority
+    _zn_defrag_buf_t dbuf_reliable[ZN_PRIORITIES_NUM];
+    _zn_defrag_buf_t dbuf_best_effort[ZN_PRIORITIES_NUM];
+
+    // Reorder buffer of the reliable channel, on links that do not guarantee the delivery
+    _zn_reorder_buf_t rbuf_reliable;
 
-    // SN numbers
+    // SN numbers, one pair per priority if the remote peer supports QoS
     z_zint_t sn_resolution;
     z_zint_t sn_resolution_half;
     _zn_conduit_sn_list_t sn_rx_sns;
@@ -35,17 +100,75 @@ typedef struct
     z_bytes_t remote_addr;
 
     volatile z_zint_t lease;
-    volatile z_zint_t next_lease;
     volatile int received;
+    _zn_timer_t lease_timer;
 } _zn_transport_peer_entry_t;
 
 size_t _zn_transport_peer_entry_size(const _zn_transport_peer_entry_t *src);
 void _zn_transport_peer_entry_clear(_zn_transport_peer_entry_t *src);
 void _zn_transport_peer_entry_copy(_zn_transport_peer_entry_t *dst, const _zn_transport_peer_entry_t *src);
 int _zn_transport_peer_entry_eq(const _zn_transport_peer_entry_t *left, const _zn_transport_peer_entry_t *right);
+/**
+ * A zenoh message encoded by a publisher and waiting in the TX queue for the
+ * write task. The encoded bytes are allocated together with the job.
+ *
+ * Members:
+ *   z_bytes_t msg: The encoded zenoh message, empty to stop the write task.
+ *   zn_reliability_t reliability: The reliability of the frame carrying the message.
+ *   zn_priority_t priority: The priority of the message.
+ *   size_t pos: The number of bytes of the message already sent, in fragments if it does not fit in a frame.
+ *   struct _zn_tx_job_t *next: The next message with the same priority pending in the write task.
+ */
+typedef struct _zn_tx_job_t
+{
+    z_bytes_t msg;
+    zn_reliability_t reliability;
+    zn_priority_t priority;
+    size_t pos;
+    struct _zn_tx_job_t *next;
+} _zn_tx_job_t;
+
+/**
+ * The messages pulled from the TX queue by the write task and waiting to be sent,
+ * in one FIFO lane per priority. The lanes with the highest priority are sent first.
+ *
+ * Members:
+ *   _zn_tx_job_t *head[]: The oldest message of each lane.
+ *   _zn_tx_job_t *tail[]: The newest message of each lane.
+ *   size_t len: The number of messages in all the lanes.
+ */
+typedef struct
+{
+    _zn_tx_job_t *head[ZN_PRIORITIES_NUM];
+    _zn_tx_job_t *tail[ZN_PRIORITIES_NUM];
+    size_t len;
+} _zn_tx_lanes_t;
+
 _Z_ELEM_DEFINE(_zn_transport_peer_entry, _zn_transport_peer_entry_t, _zn_transport_peer_entry_size, _zn_transport_peer_entry_clear, _zn_transport_peer_entry_copy)
 _Z_LIST_DEFINE(_zn_transport_peer_entry, _zn_transport_peer_entry_t)
 
+/**
+ * The index of the known peers of a multicast transport by remote address, so that the
+ * peer entry of a received datagram is found without walking the whole peer list.
+ *
+ * Members:
+ *   _z_list_t *buckets[]: The peer entries whose remote address hashes to each bucket.
+ *                         The entries are owned by the peer list, not by the table.
+ *   _zn_transport_peer_entry_t *last: The entry of the last lookup, checked before the buckets
+ *                                     since datagrams often come in bursts from the same peer.
+ */
+typedef struct
+{
+    _z_list_t *buckets[ZN_PEER_TABLE_SIZE];
+    _zn_transport_peer_entry_t *last;
+} _zn_transport_peer_table_t;
+
+void _zn_transport_peer_table_init(_zn_transport_peer_table_t *tbl);
+void _zn_transport_peer_table_clear(_zn_transport_peer_table_t *tbl);
+void _zn_transport_peer_table_insert(_zn_transport_peer_table_t *tbl, _zn_transport_peer_entry_t *entry);
+void _zn_transport_peer_table_remove(_zn_transport_peer_table_t *tbl, _zn_transport_peer_entry_t *entry);
+_zn_transport_peer_entry_t *_zn_transport_peer_table_get(_zn_transport_peer_table_t *tbl, const z_bytes_t *remote_addr);
+
 typedef struct
 {
     // Session associated to the transport
@@ -55,17 +178,20 @@ typedef struct
     z_mutex_t mutex_rx;
     z_mutex_t mutex_tx;
 
-    // Defragmentation buffers
-    _z_wbuf_t dbuf_reliable;
-    _z_wbuf_t dbuf_best_effort;
+    // Defragmentation buffers, one per priority
+    _zn_defrag_buf_t dbuf_reliable[ZN_PRIORITIES_NUM];
+    _zn_defrag_buf_t dbuf_best_effort[ZN_PRIORITIES_NUM];
+
+    // Retransmission window and reorder buffer of the reliable channel,
+    // on links that do not guarantee the delivery
+    _zn_tx_window_t tx_window;
+    _zn_reorder_buf_t rbuf_reliable;
 
-    // SN numbers
+    // SN numbers, one pair per priority if the transport supports QoS
     z_zint_t sn_resolution;
     z_zint_t sn_resolution_half;
-    z_zint_t sn_tx_reliable;
-    z_zint_t sn_tx_best_effort;
-    z_zint_t sn_rx_reliable;
-    z_zint_t sn_rx_best_effort;
+    _zn_conduit_sn_list_t sn_tx_sns;
+    _zn_conduit_sn_list_t sn_rx_sns;
 
     z_bytes_t remote_pid;
 
@@ -75,15 +201,46 @@ typedef struct
     _z_wbuf_t wbuf;
     _z_zbuf_t zbuf;
 
+    // TX batching: a FRAME left open in wbuf waiting for more zenoh messages
+    // (batch_depth counts the batch scopes currently opened by the application, shared by all
+    // its threads, and batch_linger is the time in milliseconds a frame may wait for more messages)
+    volatile int batch_is_open;
+    zn_reliability_t batch_reliability;
+    zn_priority_t batch_priority;
+    z_zint_t batch_sn;
+    z_clock_t batch_start;
+    volatile int batch_depth;
+    unsigned int batch_linger;
+
     volatile int received;
     volatile int transmitted;
 
     volatile int read_task_running;
     z_task_t *read_task;
 
+    // Reactor servicing the link instead of the read task
+    void *reactor;
+
     volatile int lease_task_running;
     z_task_t *lease_task;
     volatile z_zint_t lease;
+
+    // Deadlines driven by the lease task: lease expiration, keep alive, and the periodic
+    // flush of the TX batch and synchronization of the reliable channel
+    _zn_timers_t timers;
+    _zn_timer_t lease_timer;
+    _zn_timer_t keep_alive_timer;
+    _zn_timer_t linger_timer;
+    _zn_timer_t sync_timer;
+
+    // TX queue drained by the write task, zenoh messages are sent directly when not running.
+    // The publishers enqueuing a message are counted, so that the queue outlives them.
+    z_ring_queue_t *tx_queue;
+    z_mutex_t mutex_write_task;
+    z_condvar_t write_task_idle;
+    size_t write_task_users;
+    volatile int write_task_running;
+    z_task_t *write_task;
 } _zn_transport_unicast_t;
 
 typedef struct
@@ -98,14 +255,17 @@ typedef struct
     // Peer list mutex
     z_mutex_t mutex_peer;
 
-    // Known valid peers
+    // Known valid peers, indexed by remote address
     _zn_transport_peer_entry_list_t *peers;
+    _zn_transport_peer_table_t peer_table;
 
-    // SN initial numbers
+    // SN initial numbers, one pair per priority if the transport supports QoS
     z_zint_t sn_resolution;
     z_zint_t sn_resolution_half;
-    z_zint_t sn_tx_reliable;
-    z_zint_t sn_tx_best_effort;
+    _zn_conduit_sn_list_t sn_tx_sns;
+
+    // Retransmission window of the reliable channel, on links that do not guarantee the delivery
+    _zn_tx_window_t tx_window;
 
     // ----------- Link related -----------
     // TX and RX buffers
@@ -113,14 +273,45 @@ typedef struct
     _z_wbuf_t wbuf;
     _z_zbuf_t zbuf;
 
+    // TX batching: a FRAME left open in wbuf waiting for more zenoh messages
+    // (batch_depth counts the batch scopes currently opened by the application, shared by all
+    // its threads, and batch_linger is the time in milliseconds a frame may wait for more messages)
+    volatile int batch_is_open;
+    zn_reliability_t batch_reliability;
+    zn_priority_t batch_priority;
+    z_zint_t batch_sn;
+    z_clock_t batch_start;
+    volatile int batch_depth;
+    unsigned int batch_linger;
+
     volatile int transmitted;
 
     volatile int read_task_running;
     z_task_t *read_task;
 
+    // Reactor servicing the link instead of the read task
+    void *reactor;
+
     volatile int lease_task_running;
     z_task_t *lease_task;
     volatile z_zint_t lease;
+
+    // Deadlines driven by the lease task: join, keep alive, and the periodic flush of the
+    // TX batch and synchronization of the reliable channel (the peer leases are in the peer entries)
+    _zn_timers_t timers;
+    _zn_timer_t join_timer;
+    _zn_timer_t keep_alive_timer;
+    _zn_timer_t linger_timer;
+    _zn_timer_t sync_timer;
+
+    // TX queue drained by the write task, zenoh messages are sent directly when not running.
+    // The publishers enqueuing a message are counted, so that the queue outlives them.
+    z_ring_queue_t *tx_queue;
+    z_mutex_t mutex_write_task;
+    z_condvar_t write_task_idle;
+    size_t write_task_users;
+    volatile int write_task_running;
+    z_task_t *write_task;
 } _zn_transport_multicast_t;
 
 typedef struct
@@ -144,6 +335,27 @@ _Z_LIST_DEFINE(_zn_transport, _zn_transport_t)
 _ZN_RESULT_DECLARE(_zn_transport_t, transport)
 _ZN_P_RESULT_DECLARE(_zn_transport_t, transport)
 
+#if Z_REACTOR == 1
+/**
+ * A reactor servicing the links of several transports with a pool of tasks, instead of one
+ * read task per transport. Each task waits for any of the links to be ready to be read, and
+ * handles the transport messages received on it.
+ *
+ * Members:
+ *   z_reactor_t reactor: The readiness multiplexer of the links.
+ *   volatile int running: Whether the tasks keep waiting for ready links.
+ *   size_t len: The number of tasks.
+ *   z_task_t *tasks: The tasks.
+ */
+typedef struct
+{
+    z_reactor_t reactor;
+    volatile int running;
+    size_t len;
+    z_task_t *tasks;
+} _zn_reactor_t;
+#endif
+
 typedef struct
 {
     z_bytes_t remote_pid;
@@ -17,6 +17,7 @@
 
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/msg.h"
+#include "zenoh-pico/transport/transport.h"
 
 /*------------------ SN helpers ------------------*/
 int _zn_sn_precedes(const z_zint_t sn_resolution_half, const z_zint_t sn_left, const z_zint_t sn_right);
@@ -24,5 +25,37 @@ z_zint_t _zn_sn_increment(const z_zint_t sn_resolution, const z_zint_t sn);
 z_zint_t _zn_sn_decrement(const z_zint_t sn_resolution, const z_zint_t sn);
 void _zn_conduit_sn_list_copy(_zn_conduit_sn_list_t *dst, const _zn_conduit_sn_list_t *src);
 void _zn_conduit_sn_list_decrement(const z_zint_t sn_resolution, _zn_conduit_sn_list_t *sns);
+void _zn_conduit_sn_list_init(_zn_conduit_sn_list_t *sns, uint8_t is_qos, const z_zint_t sn);
+_zn_coundit_sn_t *_zn_conduit_sn_list_get(_zn_conduit_sn_list_t *sns, zn_priority_t priority);
+
+/*------------------ Defragmentation helpers ------------------*/
+void _zn_defrag_buf_init(_zn_defrag_buf_t *dbuf);
+int _zn_defrag_buf_push(_zn_defrag_buf_t *dbuf, const z_bytes_t *fragment);
+void _zn_defrag_buf_reset(_zn_defrag_buf_t *dbuf);
+void _zn_defrag_buf_clear(_zn_defrag_buf_t *dbuf);
+void _zn_defrag_buf_copy(_zn_defrag_buf_t *dst, const _zn_defrag_buf_t *src);
+
+/*------------------ Reliability helpers ------------------*/
+z_zint_t _zn_sn_distance(const z_zint_t sn_resolution, const z_zint_t sn_from, const z_zint_t sn_to);
+
+void _zn_tx_window_init(_zn_tx_window_t *win);
+void _zn_tx_window_clear(_zn_tx_window_t *win);
+void _zn_tx_window_push(_zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn, const _z_wbuf_t *wbf, const uint8_t *ext, size_t ext_len);
+void _zn_tx_window_ack(_zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn);
+const z_bytes_t *_zn_tx_window_get(const _zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn);
+
+void _zn_reorder_buf_init(_zn_reorder_buf_t *rbuf);
+void _zn_reorder_buf_clear(_zn_reorder_buf_t *rbuf);
+void _zn_reorder_buf_copy(_zn_reorder_buf_t *dst, const _zn_reorder_buf_t *src);
+int _zn_reorder_buf_put(_zn_reorder_buf_t *rbuf, size_t offset, uint8_t header, const z_bytes_t *payload);
+int _zn_reorder_buf_take(_zn_reorder_buf_t *rbuf, uint8_t *header, z_bytes_t *payload);
+void _zn_reorder_buf_shift(_zn_reorder_buf_t *rbuf);
+z_zint_t _zn_reorder_buf_mask(const _zn_reorder_buf_t *rbuf, size_t len);
+
+/*------------------ TX scheduling helpers ------------------*/
+void _zn_tx_lanes_init(_zn_tx_lanes_t *lanes);
+void _zn_tx_lanes_push(_zn_tx_lanes_t *lanes, _zn_tx_job_t *job);
+_zn_tx_job_t *_zn_tx_lanes_peek(const _zn_tx_lanes_t *lanes);
+_zn_tx_job_t *_zn_tx_lanes_pop(_zn_tx_lanes_t *lanes);
 
 #endif /* ZENOH_PICO_TRANSPORT_UTILS_H */
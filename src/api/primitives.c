@@ -47,7 +47,7 @@ z_zint_t zn_declare_resource(zn_session_t *zn, zn_reskey_t reskey)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -73,7 +73,7 @@ void zn_undeclare_resource(zn_session_t *zn, const z_zint_t rid)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -96,7 +96,7 @@ zn_publisher_t *zn_declare_publisher(zn_session_t *zn, zn_reskey_t reskey)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -114,7 +114,7 @@ void zn_undeclare_publisher(zn_publisher_t *pub)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(pub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(pub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -143,7 +143,7 @@ zn_subscriber_t *zn_declare_subscriber(zn_session_t *zn, zn_reskey_t reskey, zn_
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -177,7 +177,7 @@ void zn_undeclare_subscriber(zn_subscriber_t *sub)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(sub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(sub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -206,7 +206,7 @@ zn_queryable_t *zn_declare_queryable(zn_session_t *zn, zn_reskey_t reskey, unsig
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -240,7 +240,7 @@ void zn_undeclare_queryable(zn_queryable_t *qle)
     // Build the declare message to send on the wire
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_declare(declarations);
 
-    if (_zn_send_z_msg(qle->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(qle->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -276,7 +276,7 @@ void zn_send_reply(zn_query_t *query, const z_str_t key, const uint8_t *payload,
 
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_reply(reskey, di, pld, can_be_dropped, rctx);
 
-    if (_zn_send_z_msg(query->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(query->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -308,15 +308,24 @@ int zn_write(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload,
 
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_data(reskey, info, pld, can_be_dropped);
 
-    return _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, ZN_CONGESTION_CONTROL_DEFAULT);
+    return _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, ZN_CONGESTION_CONTROL_DEFAULT, ZN_PRIORITY_DEFAULT);
 }
 
 int zn_write_ext(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload, const size_t len, uint8_t encoding, const uint8_t kind, const zn_congestion_control_t cong_ctrl)
+{
+    return zn_write_prio(zn, reskey, payload, len, encoding, kind, cong_ctrl, ZN_PRIORITY_DEFAULT);
+}
+
+int zn_write_prio(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payload, const size_t len, uint8_t encoding, const uint8_t kind, const zn_congestion_control_t cong_ctrl, const zn_priority_t priority)
 {
     // @TODO: Need to verify that I have declared a publisher with the same resource key.
     //        Then, need to verify there are active subscriptions matching the publisher.
     // @TODO: Need to check subscriptions to determine the right reliability value.
 
+    // The priority indexes the conduits and the TX lanes
+    if ((unsigned int)priority > (unsigned int)zn_priority_t_BACKGROUND)
+        return -1;
+
     // Data info
     _zn_data_info_t info;
     info.flags = 0;
@@ -336,7 +345,7 @@ int zn_write_ext(zn_session_t *zn, const zn_reskey_t reskey, const uint8_t *payl
 
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_data(reskey, info, pld, can_be_dropped);
 
-    return _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, cong_ctrl);
+    return _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, cong_ctrl, priority);
 }
 
 /*------------------ Query ------------------*/
@@ -358,7 +367,7 @@ void zn_query(zn_session_t *zn, zn_reskey_t reskey, const z_str_t predicate, con
 
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_query(pq->key, pq->predicate, pq->id, pq->target, pq->consolidation);
 
-    int res = _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK);
+    int res = _zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT);
     if (res != 0)
         _zn_unregister_pending_query(zn, pq);
 }
@@ -436,7 +445,7 @@ int zn_pull(const zn_subscriber_t *sub)
 
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_pull(s->key, pull_id, max_samples, is_final);
 
-    if (_zn_send_z_msg(sub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(sub->zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
@@ -16,9 +16,13 @@
 
 #include "zenoh-pico/api/session.h"
 #include "zenoh-pico/api/memory.h"
+#include "zenoh-pico/session/dispatch.h"
 #include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/link/task/lease.h"
+#include "zenoh-pico/transport/link/task/reactor.h"
 #include "zenoh-pico/transport/link/task/read.h"
+#include "zenoh-pico/transport/link/task/write.h"
+#include "zenoh-pico/transport/link/tx.h"
 #include "zenoh-pico/utils/logging.h"
 
 zn_session_t *_zn_open(z_str_t locator, int mode)
@@ -130,6 +134,29 @@ zn_properties_t *zn_info(zn_session_t *zn)
     return ps;
 }
 
+int zn_stats(zn_session_t *zn, zn_stats_t *stats)
+{
+#if ZN_STATS == 1
+    _zn_stats_snapshot(&zn->stats, stats);
+    return 0;
+#else
+    (void)zn;
+    (void)stats;
+    return -1;
+#endif
+}
+
+int zn_stats_reset(zn_session_t *zn)
+{
+#if ZN_STATS == 1
+    _zn_stats_reset(&zn->stats);
+    return 0;
+#else
+    (void)zn;
+    return -1;
+#endif
+}
+
 int znp_read(zn_session_t *zn)
 {
     return _znp_read(zn->tp);
@@ -140,8 +167,23 @@ int znp_send_keep_alive(zn_session_t *zn)
     return _znp_send_keep_alive(zn->tp);
 }
 
+int znp_batch_start(zn_session_t *zn)
+{
+    return _zn_batch_start(zn->tp);
+}
+
+int znp_batch_flush(zn_session_t *zn)
+{
+    return _zn_batch_flush(zn->tp);
+}
+
 int znp_start_read_task(zn_session_t *zn)
 {
+    // The link is serviced either by the read task or by a reactor
+    void *reactor = zn->tp->type == _ZN_TRANSPORT_UNICAST_TYPE ? zn->tp->transport.unicast.reactor : zn->tp->transport.multicast.reactor;
+    if (reactor != NULL)
+        return -1;
+
     z_task_t *task = (z_task_t *)z_malloc(sizeof(z_task_t));
     memset(task, 0, sizeof(z_task_t));
 
@@ -205,3 +247,45 @@ int znp_stop_lease_task(zn_session_t *zn)
 
     return 0;
 }
+
+int znp_start_write_task(zn_session_t *zn)
+{
+    return _znp_start_write_task(zn->tp);
+}
+
+int znp_stop_write_task(zn_session_t *zn)
+{
+    return _znp_stop_write_task(zn->tp);
+}
+
+int znp_start_dispatch_pool(zn_session_t *zn, size_t workers)
+{
+    return _zn_start_dispatch_pool(zn, workers);
+}
+
+int znp_stop_dispatch_pool(zn_session_t *zn)
+{
+    return _zn_stop_dispatch_pool(zn);
+}
+
+#if Z_REACTOR == 1
+znp_reactor_t *znp_reactor_open(size_t tasks)
+{
+    return _zn_reactor_init(tasks);
+}
+
+void znp_reactor_close(znp_reactor_t *reactor)
+{
+    _zn_reactor_free(&reactor);
+}
+
+int znp_reactor_add_session(znp_reactor_t *reactor, zn_session_t *zn)
+{
+    return _zn_reactor_add(reactor, zn->tp);
+}
+
+int znp_reactor_remove_session(znp_reactor_t *reactor, zn_session_t *zn)
+{
+    return _zn_reactor_remove(reactor, zn->tp);
+}
+#endif
@@ -0,0 +1,303 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <stdint.h>
+#include <string.h>
+#include "zenoh-pico/system/collections.h"
+
+#if Z_RING_LOCK_FREE == 1
+#define _Z_RING_LOAD(p, o) atomic_load_explicit(p, o)
+#define _Z_RING_STORE(p, v, o) atomic_store_explicit(p, v, o)
+#define _Z_RING_CAS(p, e, v) atomic_compare_exchange_weak_explicit(p, e, v, memory_order_relaxed, memory_order_relaxed)
+#define _Z_RING_ADD(p, v) atomic_fetch_add(p, v)
+#define _Z_RING_SUB(p, v) atomic_fetch_sub(p, v)
+#define _Z_RING_FENCE() atomic_thread_fence(memory_order_seq_cst)
+#define _Z_RING_INIT(p, v) atomic_init(p, v)
+#define _Z_RING_LOCK(r)
+#define _Z_RING_UNLOCK(r)
+#else
+// Without atomics, the rings are protected by their mutex
+#define _Z_RING_LOAD(p, o) (*(p))
+#define _Z_RING_STORE(p, v, o) (*(p) = (v))
+#define _Z_RING_CAS(p, e, v) (*(p) = (v), 1)
+#define _Z_RING_ADD(p, v) (*(p) += (v))
+#define _Z_RING_SUB(p, v) (*(p) -= (v))
+#define _Z_RING_FENCE()
+#define _Z_RING_INIT(p, v) (*(p) = (v))
+#define _Z_RING_LOCK(r) z_mutex_lock(&(r)->mtx)
+#define _Z_RING_UNLOCK(r) z_mutex_unlock(&(r)->mtx)
+#endif
+
+size_t _z_ring_capacity(size_t capacity)
+{
+    // Round up to a power of two, so that positions are mapped to slots with a mask
+    size_t c = 1;
+    while (c < capacity)
+        c <<= 1;
+    return c;
+}
+
+/*-------- SPSC ring --------*/
+z_spsc_ring_t *z_spsc_ring_make(size_t capacity)
+{
+    size_t c = _z_ring_capacity(capacity);
+
+    z_spsc_ring_t *r = (z_spsc_ring_t *)z_malloc(sizeof(z_spsc_ring_t));
+    r->mask = c - 1;
+    _Z_RING_INIT(&r->head, 0);
+    _Z_RING_INIT(&r->tail, 0);
+    r->elems = (void **)z_malloc(c * sizeof(void *));
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_init(&r->mtx);
+#endif
+
+    return r;
+}
+
+size_t z_spsc_ring_capacity(const z_spsc_ring_t *r)
+{
+    return r->mask + 1;
+}
+
+int z_spsc_ring_push(z_spsc_ring_t *r, void *e)
+{
+    _Z_RING_LOCK(r);
+    size_t tail = _Z_RING_LOAD(&r->tail, memory_order_relaxed);
+    size_t head = _Z_RING_LOAD(&r->head, memory_order_acquire);
+    if (tail - head > r->mask)
+        goto ERR;
+
+    r->elems[tail & r->mask] = e;
+    _Z_RING_STORE(&r->tail, tail + 1, memory_order_release);
+    _Z_RING_UNLOCK(r);
+    return 0;
+
+ERR:
+    _Z_RING_UNLOCK(r);
+    return -1;
+}
+
+void *z_spsc_ring_pull(z_spsc_ring_t *r)
+{
+    _Z_RING_LOCK(r);
+    size_t head = _Z_RING_LOAD(&r->head, memory_order_relaxed);
+    size_t tail = _Z_RING_LOAD(&r->tail, memory_order_acquire);
+    if (head == tail)
+        goto ERR;
+
+    void *e = r->elems[head & r->mask];
+    _Z_RING_STORE(&r->head, head + 1, memory_order_release);
+    _Z_RING_UNLOCK(r);
+    return e;
+
+ERR:
+    _Z_RING_UNLOCK(r);
+    return NULL;
+}
+
+void z_spsc_ring_free(z_spsc_ring_t **r)
+{
+    z_spsc_ring_t *ptr = *r;
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_free(&ptr->mtx);
+#endif
+    z_free(ptr->elems);
+    z_free(ptr);
+    *r = NULL;
+}
+
+/*-------- MPSC ring --------*/
+z_mpsc_ring_t *z_mpsc_ring_make(size_t capacity)
+{
+    size_t c = _z_ring_capacity(capacity);
+
+    z_mpsc_ring_t *r = (z_mpsc_ring_t *)z_malloc(sizeof(z_mpsc_ring_t));
+    r->mask = c - 1;
+    r->head = 0;
+    _Z_RING_INIT(&r->tail, 0);
+    r->cells = (z_mpsc_ring_cell_t *)z_malloc(c * sizeof(z_mpsc_ring_cell_t));
+    // A cell is free for the position equal to its sequence number
+    for (size_t i = 0; i < c; i++)
+    {
+        _Z_RING_INIT(&r->cells[i].seq, i);
+        r->cells[i].elem = NULL;
+    }
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_init(&r->mtx);
+#endif
+
+    return r;
+}
+
+size_t z_mpsc_ring_capacity(const z_mpsc_ring_t *r)
+{
+    return r->mask + 1;
+}
+
+int z_mpsc_ring_push(z_mpsc_ring_t *r, void *e)
+{
+    _Z_RING_LOCK(r);
+    z_mpsc_ring_cell_t *cell;
+    size_t pos = _Z_RING_LOAD(&r->tail, memory_order_relaxed);
+    while (1)
+    {
+        cell = &r->cells[pos & r->mask];
+        size_t seq = _Z_RING_LOAD(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0)
+        {
+            // The cell is free, claim the position
+            if (_Z_RING_CAS(&r->tail, &pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+            goto ERR;
+        else
+            pos = _Z_RING_LOAD(&r->tail, memory_order_relaxed);
+    }
+
+    cell->elem = e;
+    _Z_RING_STORE(&cell->seq, pos + 1, memory_order_release);
+    _Z_RING_UNLOCK(r);
+    return 0;
+
+ERR:
+    _Z_RING_UNLOCK(r);
+    return -1;
+}
+
+void *z_mpsc_ring_pull(z_mpsc_ring_t *r)
+{
+    _Z_RING_LOCK(r);
+    z_mpsc_ring_cell_t *cell = &r->cells[r->head & r->mask];
+    size_t seq = _Z_RING_LOAD(&cell->seq, memory_order_acquire);
+    if (seq != r->head + 1)
+        goto ERR;
+
+    void *e = cell->elem;
+    // Free the cell for the position one lap ahead
+    _Z_RING_STORE(&cell->seq, r->head + r->mask + 1, memory_order_release);
+    r->head++;
+    _Z_RING_UNLOCK(r);
+    return e;
+
+ERR:
+    _Z_RING_UNLOCK(r);
+    return NULL;
+}
+
+void z_mpsc_ring_free(z_mpsc_ring_t **r)
+{
+    z_mpsc_ring_t *ptr = *r;
+#if Z_RING_LOCK_FREE == 0
+    z_mutex_free(&ptr->mtx);
+#endif
+    z_free(ptr->cells);
+    z_free(ptr);
+    *r = NULL;
+}
+
+/*-------- Ring queue --------*/
+z_ring_queue_t *z_ring_queue_make(size_t capacity)
+{
+    z_ring_queue_t *q = (z_ring_queue_t *)z_malloc(sizeof(z_ring_queue_t));
+    q->ring = z_mpsc_ring_make(capacity);
+    _Z_RING_INIT(&q->waiting_put, 0);
+    _Z_RING_INIT(&q->waiting_get, 0);
+    z_mutex_init(&q->mtx);
+    z_condvar_init(&q->can_put);
+    z_condvar_init(&q->can_get);
+    return q;
+}
+
+void _z_ring_queue_wake(z_ring_queue_t *q, z_atomic_size_t *waiting, z_condvar_t *cv)
+{
+    // Order the ring update before reading the number of waiters, the waiters
+    // do the opposite: in both orders, either side sees the other one.
+    _Z_RING_FENCE();
+#if Z_RING_LOCK_FREE == 1
+    if (_Z_RING_LOAD(waiting, memory_order_relaxed) == 0)
+        return;
+#endif
+
+    z_mutex_lock(&q->mtx);
+    if (_Z_RING_LOAD(waiting, memory_order_relaxed) > 0)
+        z_condvar_signal(cv);
+    z_mutex_unlock(&q->mtx);
+}
+
+int z_ring_queue_try_put(z_ring_queue_t *q, void *e)
+{
+    if (z_mpsc_ring_push(q->ring, e) != 0)
+        return -1;
+
+    _z_ring_queue_wake(q, &q->waiting_get, &q->can_get);
+    return 0;
+}
+
+void z_ring_queue_put(z_ring_queue_t *q, void *e)
+{
+    if (z_ring_queue_try_put(q, e) == 0)
+        return;
+
+    z_mutex_lock(&q->mtx);
+    _Z_RING_ADD(&q->waiting_put, 1);
+    _Z_RING_FENCE();
+    while (z_mpsc_ring_push(q->ring, e) != 0)
+        z_condvar_wait(&q->can_put, &q->mtx);
+    _Z_RING_SUB(&q->waiting_put, 1);
+    z_mutex_unlock(&q->mtx);
+
+    _z_ring_queue_wake(q, &q->waiting_get, &q->can_get);
+}
+
+void *z_ring_queue_try_get(z_ring_queue_t *q)
+{
+    void *e = z_mpsc_ring_pull(q->ring);
+    if (e == NULL)
+        return NULL;
+
+    _z_ring_queue_wake(q, &q->waiting_put, &q->can_put);
+    return e;
+}
+
+void *z_ring_queue_get(z_ring_queue_t *q)
+{
+    void *e = z_ring_queue_try_get(q);
+    if (e != NULL)
+        return e;
+
+    z_mutex_lock(&q->mtx);
+    _Z_RING_ADD(&q->waiting_get, 1);
+    _Z_RING_FENCE();
+    while ((e = z_mpsc_ring_pull(q->ring)) == NULL)
+        z_condvar_wait(&q->can_get, &q->mtx);
+    _Z_RING_SUB(&q->waiting_get, 1);
+    z_mutex_unlock(&q->mtx);
+
+    _z_ring_queue_wake(q, &q->waiting_put, &q->can_put);
+    return e;
+}
+
+void z_ring_queue_free(z_ring_queue_t **q)
+{
+    z_ring_queue_t *ptr = *q;
+    z_mpsc_ring_free(&ptr->ring);
+    z_condvar_free(&ptr->can_get);
+    z_condvar_free(&ptr->can_put);
+    z_mutex_free(&ptr->mtx);
+    z_free(ptr);
+    *q = NULL;
+}
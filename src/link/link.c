@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include <string.h>
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/link/link.h"
 #include "zenoh-pico/link/manager.h"
@@ -146,8 +147,158 @@ size_t _zn_link_recv_exact_zbuf(const _zn_link_t *link, _z_zbuf_t *zbf, size_t l
     return rb;
 }
 
+// Datagram links send the whole message in a single write, otherwise it is split across several datagrams
+static int __zn_link_send_datagram(const _zn_link_t *link, const uint8_t *buf, size_t len)
+{
+    size_t wb = link->write_f(link, buf, len);
+    if (wb != len)
+    {
+        _Z_DEBUG("Error while sending data over socket [%zu]\n", wb);
+        return -1;
+    }
+    return 0;
+}
+
+static int __zn_link_send_vec_coalesced(const _zn_link_t *link, const z_bytes_t *bufs, size_t n)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++)
+        len += bufs[i].len;
+
+    uint8_t *buf = (uint8_t *)z_malloc(len);
+    if (buf == NULL)
+        return -1;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        memcpy(buf + pos, bufs[i].val, bufs[i].len);
+        pos += bufs[i].len;
+    }
+
+    int res = __zn_link_send_datagram(link, buf, len);
+    z_free(buf);
+    return res;
+}
+
+static int __zn_link_send_wbuf_coalesced(const _zn_link_t *link, const _z_wbuf_t *wbf)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < _z_wbuf_len_iosli(wbf); i++)
+        len += _z_iosli_readable(_z_wbuf_get_iosli(wbf, i));
+
+    uint8_t *buf = (uint8_t *)z_malloc(len);
+    if (buf == NULL)
+        return -1;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < _z_wbuf_len_iosli(wbf); i++)
+    {
+        z_bytes_t bs = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
+        memcpy(buf + pos, bs.val, bs.len);
+        pos += bs.len;
+    }
+
+    int res = __zn_link_send_datagram(link, buf, len);
+    z_free(buf);
+    return res;
+}
+
+// Whether n slices can be sent by the link without splitting a datagram
+static int __zn_link_is_single_write(const _zn_link_t *link, size_t n)
+{
+    if (link->is_streamed == 1 || n <= 1)
+        return 1;
+    return link->write_vec_f != NULL && n <= ZN_LINK_WRITE_VEC_SIZE;
+}
+
+int _zn_link_send_vec(const _zn_link_t *link, z_bytes_t *bufs, size_t n)
+{
+    // The slices of a datagram that can not be gathered in a single write are coalesced first
+    if (!__zn_link_is_single_write(link, n))
+        return __zn_link_send_vec_coalesced(link, bufs, n);
+
+    // Without gather writes, only stream links can send a message in several writes
+    if (link->write_vec_f == NULL)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t len = bufs[i].len;
+            while (len > 0)
+            {
+                size_t wb = link->write_f(link, bufs[i].val + bufs[i].len - len, len);
+                if (wb == SIZE_MAX)
+                {
+                    _Z_DEBUG("Error while sending data over socket [%zu]\n", wb);
+                    return -1;
+                }
+                len -= wb;
+            }
+        }
+        return 0;
+    }
+
+    size_t first = 0;
+    while (first < n)
+    {
+        size_t count = n - first < ZN_LINK_WRITE_VEC_SIZE ? n - first : ZN_LINK_WRITE_VEC_SIZE;
+        _Z_DEBUG("Sending %zu slices on socket...", count);
+        size_t wb = link->write_vec_f(link, &bufs[first], count);
+        _Z_DEBUG(" sent %zu bytes\n", wb);
+        if (wb == SIZE_MAX)
+        {
+            _Z_DEBUG("Error while sending data over socket [%zu]\n", wb);
+            return -1;
+        }
+
+        // Skip the buffers fully written, and resume from the partially written one
+        while (first < n && wb >= bufs[first].len)
+        {
+            wb -= bufs[first].len;
+            first++;
+        }
+        if (first < n)
+        {
+            bufs[first].val += wb;
+            bufs[first].len -= wb;
+        }
+    }
+
+    return 0;
+}
+
+static int __zn_link_send_wbuf_vec(const _zn_link_t *link, const _z_wbuf_t *wbf)
+{
+    z_bytes_t bufs[ZN_LINK_WRITE_VEC_SIZE];
+    size_t len = _z_wbuf_len_iosli(wbf);
+    size_t i = 0;
+    while (i < len)
+    {
+        // Gather as many non-empty slices as possible
+        size_t n = 0;
+        for (; i < len && n < ZN_LINK_WRITE_VEC_SIZE; i++)
+        {
+            bufs[n] = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
+            if (bufs[n].len > 0)
+                n++;
+        }
+
+        if (_zn_link_send_vec(link, bufs, n) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
 int _zn_link_send_wbuf(const _zn_link_t *link, const _z_wbuf_t *wbf)
 {
+    if (!__zn_link_is_single_write(link, _z_wbuf_len_iosli(wbf)))
+        return __zn_link_send_wbuf_coalesced(link, wbf);
+
+    // Send the whole buffer at once when it is made of multiple slices
+    if (link->write_vec_f != NULL && _z_wbuf_len_iosli(wbf) > 1)
+        return __zn_link_send_wbuf_vec(link, wbf);
+
     for (size_t i = 0; i < _z_wbuf_len_iosli(wbf); i++)
     {
         z_bytes_t bs = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
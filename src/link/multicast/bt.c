@@ -138,8 +138,10 @@ _zn_link_t *_zn_new_link_bt(_zn_endpoint_t endpoint)
 
     lt->write_f = _zn_f_link_write_bt;
     lt->write_all_f = _zn_f_link_write_all_bt;
+    lt->write_vec_f = NULL;
     lt->read_f = _zn_f_link_read_bt;
     lt->read_exact_f = _zn_f_link_read_exact_bt;
+    lt->fd_f = NULL;
 
     return lt;
 }
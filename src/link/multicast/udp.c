@@ -143,6 +143,15 @@ size_t _zn_f_link_write_all_udp_multicast(const void *arg, const uint8_t *ptr, s
     return _zn_send_udp_multicast(self->socket.udp.msock, ptr, len, self->socket.udp.raddr);
 }
 
+#if Z_LINK_WRITE_VEC == 1
+size_t _zn_f_link_write_vec_udp_multicast(const void *arg, const z_bytes_t *bufs, size_t n)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return _zn_send_vec_udp_multicast(self->socket.udp.msock, bufs, n, self->socket.udp.raddr);
+}
+#endif
+
 size_t _zn_f_link_read_udp_multicast(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr)
 {
     const _zn_link_t *self = (const _zn_link_t *)arg;
@@ -157,6 +166,15 @@ size_t _zn_f_link_read_exact_udp_multicast(const void *arg, uint8_t *ptr, size_t
     return _zn_read_exact_udp_multicast(self->socket.udp.sock, ptr, len, self->socket.udp.laddr, addr);
 }
 
+#if Z_REACTOR == 1
+int _zn_f_link_fd_udp_multicast(const void *arg)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return self->socket.udp.sock;
+}
+#endif
+
 uint16_t _zn_get_link_mtu_udp_multicast(void)
 {
     // @TODO: the return value should change depending on the target platform.
@@ -190,8 +208,18 @@ _zn_link_t *_zn_new_link_udp_multicast(_zn_endpoint_t endpoint)
 
     lt->write_f = _zn_f_link_write_udp_multicast;
     lt->write_all_f = _zn_f_link_write_all_udp_multicast;
+#if Z_LINK_WRITE_VEC == 1
+    lt->write_vec_f = _zn_f_link_write_vec_udp_multicast;
+#else
+    lt->write_vec_f = NULL;
+#endif
     lt->read_f = _zn_f_link_read_udp_multicast;
     lt->read_exact_f = _zn_f_link_read_exact_udp_multicast;
+#if Z_REACTOR == 1
+    lt->fd_f = _zn_f_link_fd_udp_multicast;
+#else
+    lt->fd_f = NULL;
+#endif
 
     return lt;
 }
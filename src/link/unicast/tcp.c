@@ -130,6 +130,15 @@ size_t _zn_f_link_write_all_tcp(const void *arg, const uint8_t *ptr, size_t len)
     return _zn_send_tcp(self->socket.tcp.sock, ptr, len);
 }
 
+#if Z_LINK_WRITE_VEC == 1
+size_t _zn_f_link_write_vec_tcp(const void *arg, const z_bytes_t *bufs, size_t n)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return _zn_send_vec_tcp(self->socket.tcp.sock, bufs, n);
+}
+#endif
+
 size_t _zn_f_link_read_tcp(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr)
 {
     (void)(addr);
@@ -146,6 +155,15 @@ size_t _zn_f_link_read_exact_tcp(const void *arg, uint8_t *ptr, size_t len, z_by
     return _zn_read_exact_tcp(self->socket.tcp.sock, ptr, len);
 }
 
+#if Z_REACTOR == 1
+int _zn_f_link_fd_tcp(const void *arg)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return self->socket.tcp.sock;
+}
+#endif
+
 uint16_t _zn_get_link_mtu_tcp(void)
 {
     // Maximum MTU for TCP
@@ -177,8 +195,18 @@ _zn_link_t *_zn_new_link_tcp(_zn_endpoint_t endpoint)
 
     lt->write_f = _zn_f_link_write_tcp;
     lt->write_all_f = _zn_f_link_write_all_tcp;
+#if Z_LINK_WRITE_VEC == 1
+    lt->write_vec_f = _zn_f_link_write_vec_tcp;
+#else
+    lt->write_vec_f = NULL;
+#endif
     lt->read_f = _zn_f_link_read_tcp;
     lt->read_exact_f = _zn_f_link_read_exact_tcp;
+#if Z_REACTOR == 1
+    lt->fd_f = _zn_f_link_fd_tcp;
+#else
+    lt->fd_f = NULL;
+#endif
 
     return lt;
 }
@@ -133,6 +133,15 @@ size_t _zn_f_link_write_all_udp_unicast(const void *arg, const uint8_t *ptr, siz
     return _zn_send_udp_unicast(self->socket.udp.sock, ptr, len, self->socket.udp.raddr);
 }
 
+#if Z_LINK_WRITE_VEC == 1
+size_t _zn_f_link_write_vec_udp_unicast(const void *arg, const z_bytes_t *bufs, size_t n)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return _zn_send_vec_udp_unicast(self->socket.udp.sock, bufs, n, self->socket.udp.raddr);
+}
+#endif
+
 size_t _zn_f_link_read_udp_unicast(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr)
 {
     (void)(addr);
@@ -149,6 +158,15 @@ size_t _zn_f_link_read_exact_udp_unicast(const void *arg, uint8_t *ptr, size_t l
     return _zn_read_exact_udp_unicast(self->socket.udp.sock, ptr, len);
 }
 
+#if Z_REACTOR == 1
+int _zn_f_link_fd_udp_unicast(const void *arg)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+
+    return self->socket.udp.sock;
+}
+#endif
+
 uint16_t _zn_get_link_mtu_udp_unicast(void)
 {
     // @TODO: the return value should change depending on the target platform.
@@ -182,8 +200,18 @@ _zn_link_t *_zn_new_link_udp_unicast(_zn_endpoint_t endpoint)
 
     lt->write_f = _zn_f_link_write_udp_unicast;
     lt->write_all_f = _zn_f_link_write_all_udp_unicast;
+#if Z_LINK_WRITE_VEC == 1
+    lt->write_vec_f = _zn_f_link_write_vec_udp_unicast;
+#else
+    lt->write_vec_f = NULL;
+#endif
     lt->read_f = _zn_f_link_read_udp_unicast;
     lt->read_exact_f = _zn_f_link_read_exact_udp_unicast;
+#if Z_REACTOR == 1
+    lt->fd_f = _zn_f_link_fd_udp_unicast;
+#else
+    lt->fd_f = NULL;
+#endif
 
     return lt;
 }
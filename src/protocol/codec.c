@@ -112,7 +112,25 @@ _z_uint8_result_t _z_uint8_decode(_z_zbuf_t *zbf)
 }
 
 /*------------------ z_zint ------------------*/
-int _z_zint_encode(_z_wbuf_t *wbf, z_zint_t v)
+size_t _z_zint_len(z_zint_t v)
+{
+#if defined(__GNUC__)
+    // Each encoded byte carries 7 bits of the significant ones
+    unsigned int bits = 64 - (unsigned int)__builtin_clzll((uint64_t)v | 1);
+    return (bits + 6) / 7;
+#else
+    size_t len = 1;
+    while (v > 0x7f)
+    {
+        v = v >> 7;
+        len++;
+    }
+    return len;
+#endif
+}
+
+// Byte-at-a-time encoding, used when the zint does not fit in the current ioslice
+static int __z_zint_encode_slow(_z_wbuf_t *wbf, z_zint_t v)
 {
     while (v > 0x7f)
     {
@@ -123,7 +141,28 @@ int _z_zint_encode(_z_wbuf_t *wbf, z_zint_t v)
     return _z_wbuf_write(wbf, (uint8_t)v);
 }
 
-_z_zint_result_t _z_zint_decode(_z_zbuf_t *zbf)
+int _z_zint_encode(_z_wbuf_t *wbf, z_zint_t v)
+{
+    // Write the encoded bytes directly in the current ioslice when they fit
+    _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, wbf->w_idx);
+    size_t len = _z_zint_len(v);
+    if (_z_iosli_writable(ios) < len)
+        return __z_zint_encode_slow(wbf, v);
+
+    uint8_t *ptr = ios->buf + ios->w_pos;
+    for (size_t i = 0; i < len - 1; i++)
+    {
+        ptr[i] = (uint8_t)((v & 0x7f) | 0x80);
+        v = v >> 7;
+    }
+    ptr[len - 1] = (uint8_t)v;
+    ios->w_pos += len;
+
+    return 0;
+}
+
+// Byte-at-a-time decoding, used close to the end of the buffer and for zints longer than 8 bytes
+static _z_zint_result_t __z_zint_decode_slow(_z_zbuf_t *zbf)
 {
     _z_zint_result_t r;
     r.tag = _z_res_t_OK;
@@ -143,6 +182,69 @@ _z_zint_result_t _z_zint_decode(_z_zbuf_t *zbf)
     return r;
 }
 
+static inline unsigned int __z_ctz64(uint64_t v)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctzll(v);
+#else
+    unsigned int n = 0;
+    while ((v & 1) == 0)
+    {
+        v = v >> 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+_z_zint_result_t _z_zint_decode(_z_zbuf_t *zbf)
+{
+    _z_zint_result_t r;
+    r.tag = _z_res_t_OK;
+
+    size_t readable = _z_zbuf_len(zbf);
+    const uint8_t *ptr = _z_zbuf_get_rptr(zbf);
+
+    // Most zints (headers, ids, short lengths) fit in a single byte
+    if (readable > 0 && ptr[0] <= 0x7f)
+    {
+        r.value.zint = ptr[0];
+        _z_zbuf_set_rpos(zbf, _z_zbuf_get_rpos(zbf) + 1);
+        return r;
+    }
+
+    if (readable < sizeof(uint64_t))
+        return __z_zint_decode_slow(zbf);
+
+    // Load 8 bytes at once and look for the first one without the continuation bit
+    uint64_t w = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+        w |= (uint64_t)ptr[i] << (i * 8);
+
+    uint64_t stops = ~w & 0x8080808080808080ULL;
+    if (stops == 0)
+        return __z_zint_decode_slow(zbf);
+
+    size_t len = (__z_ctz64(stops) >> 3) + 1;
+    if (len < sizeof(uint64_t))
+        w &= (1ULL << (len * 8)) - 1;
+
+    // Gather the 7-bit groups without looping on the bytes
+    uint64_t v = (w & 0x7fULL) |
+                 ((w >> 1) & (0x7fULL << 7)) |
+                 ((w >> 2) & (0x7fULL << 14)) |
+                 ((w >> 3) & (0x7fULL << 21)) |
+                 ((w >> 4) & (0x7fULL << 28)) |
+                 ((w >> 5) & (0x7fULL << 35)) |
+                 ((w >> 6) & (0x7fULL << 42)) |
+                 ((w >> 7) & (0x7fULL << 49));
+
+    r.value.zint = (z_zint_t)v;
+    _z_zbuf_set_rpos(zbf, _z_zbuf_get_rpos(zbf) + len);
+
+    return r;
+}
+
 /*------------------ uint8_array ------------------*/
 int _z_bytes_encode(_z_wbuf_t *wbf, const z_bytes_t *bs)
 {
@@ -260,7 +260,7 @@ void _z_zbuf_compact(_z_zbuf_t *zbf)
         return;
 
     size_t len = _z_iosli_readable(&zbf->ios);
-    memcpy(zbf->ios.buf, _z_zbuf_get_rptr(zbf), len * sizeof(uint8_t));
+    memmove(zbf->ios.buf, _z_zbuf_get_rptr(zbf), len * sizeof(uint8_t));
     _z_zbuf_set_rpos(zbf, 0);
     _z_zbuf_set_wpos(zbf, len);
 }
@@ -845,6 +845,8 @@ _zn_transport_message_t _zn_t_msg_make_frame_header(z_zint_t sn, int is_reliable
     _zn_transport_message_t msg;
 
     msg.body.frame.sn = sn;
+    msg.body.frame.is_lazy = 0;
+    msg.body.frame.priority = ZN_PRIORITY_DEFAULT;
 
     // Reset payload content
     memset(&msg.body.frame.payload, 0, sizeof(_zn_frame_payload_t));
@@ -870,6 +872,8 @@ _zn_transport_message_t _zn_t_msg_make_frame(z_zint_t sn, _zn_frame_payload_t pa
 
     msg.body.frame.sn = sn;
     msg.body.frame.payload = payload;
+    msg.body.frame.is_lazy = 0;
+    msg.body.frame.priority = ZN_PRIORITY_DEFAULT;
 
     msg.header = _ZN_MID_FRAME;
     if (is_reliable)
@@ -890,6 +894,8 @@ void _zn_t_msg_clear_frame(_zn_frame_t *msg, uint8_t header)
 {
     if (_ZN_HAS_FLAG(header, _ZN_FLAG_T_F))
         _zn_payload_clear(&msg->payload.fragment);
+    else if (msg->is_lazy)
+        _zn_payload_clear(&msg->payload.encoded);
     else
         _zn_zenoh_message_vec_clear(&msg->payload.messages);
 }
@@ -895,6 +895,19 @@ int _zn_data_encode(_z_wbuf_t *wbf, uint8_t header, const _zn_data_t *msg)
     return 0;
 }
 
+int _zn_data_encode_head(_z_wbuf_t *wbf, uint8_t header, const _zn_data_t *msg)
+{
+    _Z_DEBUG("Encoding _ZN_MID_DATA head\n");
+
+    // Encode the body up to the payload bytes
+    _ZN_EC(_zn_reskey_encode(wbf, header, &msg->key))
+
+    if (_ZN_HAS_FLAG(header, _ZN_FLAG_Z_I))
+        _ZN_EC(_zn_data_info_encode(wbf, &msg->info))
+
+    return _z_zint_encode(wbf, msg->payload.len);
+}
+
 void _zn_data_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_data_result_t *r)
 {
     _Z_DEBUG("Decoding _ZN_MID_DATA\n");
@@ -1167,6 +1180,26 @@ int _zn_zenoh_message_encode(_z_wbuf_t *wbf, const _zn_zenoh_message_t *msg)
     }
 }
 
+int _zn_zenoh_message_encode_head(_z_wbuf_t *wbf, const _zn_zenoh_message_t *msg)
+{
+    // Only data messages have payload bytes to leave out
+    if (_ZN_MID(msg->header) != _ZN_MID_DATA)
+        return _zn_zenoh_message_encode(wbf, msg);
+
+    // Encode the decorators if present
+    if (msg->attachment)
+        _ZN_EC(_zn_attachment_encode(wbf, msg->attachment))
+
+    if (msg->reply_context)
+        _ZN_EC(_zn_reply_context_encode(wbf, msg->reply_context))
+
+    // Encode the header
+    _ZN_EC(_z_wbuf_write(wbf, msg->header))
+
+    // Encode the body up to the payload bytes
+    return _zn_data_encode_head(wbf, msg->header, &msg->body.data);
+}
+
 void _zn_zenoh_message_decode_na(_z_zbuf_t *zbf, _zn_zenoh_message_result_t *r)
 {
     r->tag = _z_res_t_OK;
@@ -1665,6 +1698,10 @@ void _zn_sync_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_sync_result_t *r)
         _ASSURE_P_RESULT(r_zint, r, _z_err_t_PARSE_ZINT)
         r->value.sync.count = r_zint.value.zint;
     }
+    else
+    {
+        r->value.sync.count = 0;
+    }
 }
 
 _zn_sync_result_t _zn_sync_decode(_z_zbuf_t *zbf, uint8_t header)
@@ -1704,6 +1741,10 @@ void _zn_ack_nack_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_ack_nack_result_
         _ASSURE_P_RESULT(r_zint, r, _z_err_t_PARSE_ZINT)
         r->value.ack_nack.mask = r_zint.value.zint;
     }
+    else
+    {
+        r->value.ack_nack.mask = 0;
+    }
 }
 
 _zn_ack_nack_result_t _zn_ack_nack_decode(_z_zbuf_t *zbf, uint8_t header)
@@ -1797,7 +1838,7 @@ int _zn_frame_encode(_z_wbuf_t *wbf, uint8_t header, const _zn_frame_t *msg)
     }
 }
 
-void _zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_frame_result_t *r)
+static void __zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, int is_lazy, _zn_frame_result_t *r)
 {
     _Z_DEBUG("Decoding _ZN_MID_FRAME\n");
     r->tag = _z_res_t_OK;
@@ -1806,6 +1847,7 @@ void _zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_frame_result_t *r)
     _z_zint_result_t r_zint = _z_zint_decode(zbf);
     _ASSURE_P_RESULT(r_zint, r, _z_err_t_PARSE_ZINT)
     r->value.frame.sn = r_zint.value.zint;
+    r->value.frame.is_lazy = 0;
 
     // Decode the payload
     if (_ZN_HAS_FLAG(header, _ZN_FLAG_T_F))
@@ -1816,6 +1858,15 @@ void _zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_frame_result_t *r)
         // We need to manually move the r_pos to w_pos, we have read it all
         _z_zbuf_set_rpos(zbf, _z_zbuf_get_wpos(zbf));
     }
+    else if (is_lazy)
+    {
+        // Refer to the encoded messages, they are decoded one at a time by _zn_frame_messages_decode
+        r->value.frame.payload.encoded = _z_bytes_wrap(_z_zbuf_get_rptr(zbf), _z_zbuf_len(zbf));
+        r->value.frame.is_lazy = 1;
+
+        // We need to manually move the r_pos to w_pos, we have read it all
+        _z_zbuf_set_rpos(zbf, _z_zbuf_get_wpos(zbf));
+    }
     else
     {
         r->value.frame.payload.messages = _zn_zenoh_message_vec_make(_ZENOH_PICO_FRAME_MESSAGES_VEC_SIZE);
@@ -1840,6 +1891,11 @@ void _zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_frame_result_t *r)
     }
 }
 
+void _zn_frame_decode_na(_z_zbuf_t *zbf, uint8_t header, _zn_frame_result_t *r)
+{
+    __zn_frame_decode_na(zbf, header, 0, r);
+}
+
 _zn_frame_result_t _zn_frame_decode(_z_zbuf_t *zbf, uint8_t header)
 {
     _zn_frame_result_t r;
@@ -1853,6 +1909,8 @@ int _zn_transport_message_encode(_z_wbuf_t *wbf, const _zn_transport_message_t *
     // Encode the decorators if present
     if (msg->attachment)
         _ZN_EC(_zn_attachment_encode(wbf, msg->attachment))
+    if (_ZN_MID(msg->header) == _ZN_MID_FRAME && msg->body.frame.priority != ZN_PRIORITY_DEFAULT)
+        _ZN_EC(_z_wbuf_write(wbf, _ZN_MID_PRIORITY | (uint8_t)(msg->body.frame.priority << 5)))
 
     // Encode the header
     _ZN_EC(_z_wbuf_write(wbf, msg->header))
@@ -1888,10 +1946,33 @@ int _zn_transport_message_encode(_z_wbuf_t *wbf, const _zn_transport_message_t *
     }
 }
 
-void _zn_transport_message_decode_na(_z_zbuf_t *zbf, _zn_transport_message_result_t *r)
+int _zn_frame_messages_decode(const _zn_frame_t *frame, _zn_zenoh_message_visitor_t visitor, void *arg)
+{
+    _z_zbuf_t zbf;
+    zbf.ios = _z_iosli_wrap(frame->payload.encoded.val, frame->payload.encoded.len, 0, frame->payload.encoded.len);
+
+    while (_z_zbuf_len(&zbf))
+    {
+        // Decode the next message in the same stack slot, it is released before decoding the following one
+        _zn_zenoh_message_result_t r_zm;
+        _zn_zenoh_message_decode_na(&zbf, &r_zm);
+        if (r_zm.tag != _z_res_t_OK)
+            return -1;
+
+        int res = visitor(&r_zm.value.zenoh_message, arg);
+        _zn_z_msg_clear(&r_zm.value.zenoh_message);
+        if (res != 0)
+            return res;
+    }
+
+    return 0;
+}
+
+static void __zn_transport_message_decode_na(_z_zbuf_t *zbf, int is_lazy, _zn_transport_message_result_t *r)
 {
     r->tag = _z_res_t_OK;
     r->value.transport_message.attachment = NULL;
+    zn_priority_t priority = ZN_PRIORITY_DEFAULT;
 
     do
     {
@@ -1906,9 +1987,11 @@ void _zn_transport_message_decode_na(_z_zbuf_t *zbf, _zn_transport_message_resul
         {
         case _ZN_MID_FRAME:
         {
-            _zn_frame_result_t r_fr = _zn_frame_decode(zbf, r->value.transport_message.header);
+            _zn_frame_result_t r_fr;
+            __zn_frame_decode_na(zbf, r->value.transport_message.header, is_lazy, &r_fr);
             _ASSURE_P_RESULT(r_fr, r, _zn_err_t_PARSE_TRANSPORT_MESSAGE)
             r->value.transport_message.body.frame = r_fr.value.frame;
+            r->value.transport_message.body.frame.priority = priority;
             return;
         }
         case _ZN_MID_ATTACHMENT:
@@ -1990,10 +2073,9 @@ void _zn_transport_message_decode_na(_z_zbuf_t *zbf, _zn_transport_message_resul
         }
         case _ZN_MID_PRIORITY:
         {
-            _Z_DEBUG("WARNING: Priorities are not supported in zenoh-pico\n");
-            r->tag = _z_res_t_ERR;
-            r->value.error = _zn_err_t_PARSE_TRANSPORT_MESSAGE;
-            return;
+            // The priority is carried by the flags of the decorator, it applies to the following frame
+            priority = (zn_priority_t)(_ZN_FLAGS(r->value.transport_message.header) >> 5);
+            break;
         }
         default:
         {
@@ -2006,6 +2088,23 @@ void _zn_transport_message_decode_na(_z_zbuf_t *zbf, _zn_transport_message_resul
     } while (1);
 }
 
+void _zn_transport_message_decode_na(_z_zbuf_t *zbf, _zn_transport_message_result_t *r)
+{
+    __zn_transport_message_decode_na(zbf, 0, r);
+}
+
+void _zn_transport_message_decode_lazy_na(_z_zbuf_t *zbf, _zn_transport_message_result_t *r)
+{
+    __zn_transport_message_decode_na(zbf, 1, r);
+}
+
+_zn_transport_message_result_t _zn_transport_message_decode_lazy(_z_zbuf_t *zbf)
+{
+    _zn_transport_message_result_t r;
+    _zn_transport_message_decode_lazy_na(zbf, &r);
+    return r;
+}
+
 _zn_transport_message_result_t _zn_transport_message_decode(_z_zbuf_t *zbf)
 {
     _zn_transport_message_result_t r;
@@ -65,3 +65,8 @@ z_str_t next(const z_str_t str)
 }
 
 DEFINE_INTERSECT(zn_rname_intersect, END, WILD, next, chunk_intersect)
+
+int _zn_rname_chunk_intersect(const z_str_t left, const z_str_t right)
+{
+    return chunk_intersect(left, right);
+}
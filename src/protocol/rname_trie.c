@@ -0,0 +1,363 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <string.h>
+#include "zenoh-pico/protocol/rname_trie.h"
+#include "zenoh-pico/protocol/utils.h"
+
+#define END(str) (str[0] == 0)
+#define WILD(str) (str[0] == '*' && str[1] == '*' && (str[2] == '/' || str[2] == 0))
+#define CHUNK_LEN(str) strcspn(str, "/")
+#define CHUNK_HAS_WILD(str, len) (memchr(str, '*', len) != NULL)
+
+typedef struct
+{
+    size_t epoch;
+    _zn_rname_trie_visit_f f;
+    void *arg;
+    size_t count;
+} _zn_rname_trie_match_ctx_t;
+
+const char *__zn_rname_trie_next(const char *str)
+{
+    const char *res = strchr(str, '/');
+    if (res != NULL)
+        return res + 1;
+    return strchr(str, 0);
+}
+
+int __zn_rname_trie_ptr_eq(const void *left, const void *right)
+{
+    return left == right;
+}
+
+/*------------------ Nodes ------------------*/
+_zn_rname_trie_node_t *__zn_rname_trie_node_make(const char *chunk, size_t len)
+{
+    _zn_rname_trie_node_t *node = (_zn_rname_trie_node_t *)z_malloc(sizeof(_zn_rname_trie_node_t));
+    node->chunk = (z_str_t)z_malloc(len + 1);
+    memcpy(node->chunk, chunk, len);
+    node->chunk[len] = '\0';
+    node->len = len;
+    node->is_wild = CHUNK_HAS_WILD(chunk, len);
+    node->vals = NULL;
+    node->literals = NULL;
+    node->literals_len = 0;
+    node->literals_cap = 0;
+    node->wilds = NULL;
+    node->mark = 0;
+
+    return node;
+}
+
+int __zn_rname_trie_node_is_empty(const _zn_rname_trie_node_t *node)
+{
+    return node->vals == NULL && node->literals_len == 0 && node->wilds == NULL;
+}
+
+void __zn_rname_trie_node_free(_zn_rname_trie_node_t **node)
+{
+    _zn_rname_trie_node_t *ptr = *node;
+
+    for (size_t i = 0; i < ptr->literals_len; i++)
+        __zn_rname_trie_node_free(&ptr->literals[i]);
+    z_free(ptr->literals);
+
+    while (ptr->wilds != NULL)
+    {
+        _zn_rname_trie_node_t *child = (_zn_rname_trie_node_t *)_z_list_head(ptr->wilds);
+        __zn_rname_trie_node_free(&child);
+        ptr->wilds = _z_list_pop(ptr->wilds, _zn_noop_free);
+    }
+
+    _z_list_free(&ptr->vals, _zn_noop_free);
+    z_free(ptr->chunk);
+    z_free(ptr);
+    *node = NULL;
+}
+
+int __zn_rname_trie_node_cmp(const _zn_rname_trie_node_t *node, const char *chunk, size_t len)
+{
+    size_t min = node->len < len ? node->len : len;
+    int res = memcmp(node->chunk, chunk, min);
+    if (res != 0)
+        return res;
+
+    return (node->len > len) - (node->len < len);
+}
+
+/**
+ * Look for a literal child by binary search. Returns the position of the child
+ * if found, or the position where it should be inserted otherwise.
+ */
+size_t __zn_rname_trie_literal_search(const _zn_rname_trie_node_t *node, const char *chunk, size_t len, int *found)
+{
+    size_t lo = 0;
+    size_t hi = node->literals_len;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        int res = __zn_rname_trie_node_cmp(node->literals[mid], chunk, len);
+        if (res == 0)
+        {
+            *found = 1;
+            return mid;
+        }
+
+        if (res < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    *found = 0;
+    return lo;
+}
+
+_zn_rname_trie_node_t *__zn_rname_trie_child_get(_zn_rname_trie_node_t *node, const char *chunk, size_t len, int create)
+{
+    _zn_rname_trie_node_t *child = NULL;
+
+    if (CHUNK_HAS_WILD(chunk, len))
+    {
+        _z_list_t *xs = node->wilds;
+        while (xs != NULL)
+        {
+            child = (_zn_rname_trie_node_t *)_z_list_head(xs);
+            if (__zn_rname_trie_node_cmp(child, chunk, len) == 0)
+                return child;
+
+            xs = _z_list_tail(xs);
+        }
+
+        if (create == 0)
+            return NULL;
+
+        child = __zn_rname_trie_node_make(chunk, len);
+        node->wilds = _z_list_push(node->wilds, child);
+        return child;
+    }
+
+    int found = 0;
+    size_t pos = __zn_rname_trie_literal_search(node, chunk, len, &found);
+    if (found == 1)
+        return node->literals[pos];
+
+    if (create == 0)
+        return NULL;
+
+    if (node->literals_len == node->literals_cap)
+    {
+        // z_realloc is not available on all platforms
+        node->literals_cap = node->literals_cap == 0 ? 4 : node->literals_cap * 2;
+        _zn_rname_trie_node_t **literals = (_zn_rname_trie_node_t **)z_malloc(node->literals_cap * sizeof(_zn_rname_trie_node_t *));
+        if (node->literals != NULL)
+        {
+            memcpy(literals, node->literals, node->literals_len * sizeof(_zn_rname_trie_node_t *));
+            z_free(node->literals);
+        }
+        node->literals = literals;
+    }
+
+    // Keep the literal children sorted
+    memmove(&node->literals[pos + 1], &node->literals[pos], (node->literals_len - pos) * sizeof(_zn_rname_trie_node_t *));
+    child = __zn_rname_trie_node_make(chunk, len);
+    node->literals[pos] = child;
+    node->literals_len++;
+
+    return child;
+}
+
+void __zn_rname_trie_child_drop(_zn_rname_trie_node_t *node, _zn_rname_trie_node_t *child)
+{
+    if (child->is_wild)
+    {
+        node->wilds = _z_list_drop_filter(node->wilds, _zn_noop_free, __zn_rname_trie_ptr_eq, child);
+    }
+    else
+    {
+        int found = 0;
+        size_t pos = __zn_rname_trie_literal_search(node, child->chunk, child->len, &found);
+        if (found == 0)
+            return;
+
+        memmove(&node->literals[pos], &node->literals[pos + 1], (node->literals_len - pos - 1) * sizeof(_zn_rname_trie_node_t *));
+        node->literals_len--;
+    }
+
+    __zn_rname_trie_node_free(&child);
+}
+
+/*------------------ Trie ------------------*/
+void _zn_rname_trie_init(_zn_rname_trie_t *trie)
+{
+    trie->root = NULL;
+    trie->epoch = 0;
+}
+
+int _zn_rname_trie_insert(_zn_rname_trie_t *trie, const z_str_t rname, void *val)
+{
+    if (rname == NULL)
+        return -1;
+
+    if (trie->root == NULL)
+        trie->root = __zn_rname_trie_node_make("", 0);
+
+    _zn_rname_trie_node_t *node = trie->root;
+    for (const char *c = rname; !END(c); c = __zn_rname_trie_next(c))
+        node = __zn_rname_trie_child_get(node, c, CHUNK_LEN(c), 1);
+
+    node->vals = _z_list_push(node->vals, val);
+    return 0;
+}
+
+int __zn_rname_trie_remove(_zn_rname_trie_node_t *node, const char *c, z_element_eq_f f, void *val)
+{
+    if (END(c))
+    {
+        if (_z_list_find(node->vals, f, val) == NULL)
+            return -1;
+
+        node->vals = _z_list_drop_filter(node->vals, _zn_noop_free, f, val);
+        return 0;
+    }
+
+    _zn_rname_trie_node_t *child = __zn_rname_trie_child_get(node, c, CHUNK_LEN(c), 0);
+    if (child == NULL)
+        return -1;
+
+    int res = __zn_rname_trie_remove(child, __zn_rname_trie_next(c), f, val);
+
+    // Prune the branches that are no longer used
+    if (res == 0 && __zn_rname_trie_node_is_empty(child))
+        __zn_rname_trie_child_drop(node, child);
+
+    return res;
+}
+
+int _zn_rname_trie_remove(_zn_rname_trie_t *trie, const z_str_t rname, z_element_eq_f f, void *val)
+{
+    if (rname == NULL || trie->root == NULL)
+        return -1;
+
+    int res = __zn_rname_trie_remove(trie->root, rname, f, val);
+    if (__zn_rname_trie_node_is_empty(trie->root))
+        __zn_rname_trie_node_free(&trie->root);
+
+    return res;
+}
+
+int __zn_rname_trie_is_all_wild(const char *c)
+{
+    while (!END(c))
+    {
+        if (!WILD(c))
+            return 0;
+        c = __zn_rname_trie_next(c);
+    }
+
+    return 1;
+}
+
+void __zn_rname_trie_match_node(_zn_rname_trie_node_t *node, const char *c, _zn_rname_trie_match_ctx_t *ctx);
+
+/**
+ * Match the chunk of a child node, not yet consumed, against the remaining chunks.
+ * This follows the same recursion of zn_rname_intersect.
+ */
+void __zn_rname_trie_match_child(_zn_rname_trie_node_t *child, const char *c, _zn_rname_trie_match_ctx_t *ctx)
+{
+    if (END(c))
+    {
+        if (WILD(child->chunk))
+            __zn_rname_trie_match_node(child, c, ctx);
+        return;
+    }
+
+    if (WILD(child->chunk) || WILD(c))
+    {
+        __zn_rname_trie_match_node(child, c, ctx);
+        __zn_rname_trie_match_child(child, __zn_rname_trie_next(c), ctx);
+        return;
+    }
+
+    if (_zn_rname_chunk_intersect(child->chunk, (const z_str_t)c))
+        __zn_rname_trie_match_node(child, __zn_rname_trie_next(c), ctx);
+}
+
+/**
+ * Match the children of a node, whose chunk has been consumed, against the remaining chunks.
+ */
+void __zn_rname_trie_match_node(_zn_rname_trie_node_t *node, const char *c, _zn_rname_trie_match_ctx_t *ctx)
+{
+    // Report each node at most once per matching operation
+    if (node->vals != NULL && node->mark != ctx->epoch && __zn_rname_trie_is_all_wild(c))
+    {
+        node->mark = ctx->epoch;
+        for (_z_list_t *xs = node->vals; xs != NULL; xs = _z_list_tail(xs))
+        {
+            ctx->f(_z_list_head(xs), ctx->arg);
+            ctx->count++;
+        }
+    }
+
+    if (END(c))
+    {
+        // Only the ** children can match an empty resource name
+        for (_z_list_t *xs = node->wilds; xs != NULL; xs = _z_list_tail(xs))
+            __zn_rname_trie_match_child((_zn_rname_trie_node_t *)_z_list_head(xs), c, ctx);
+        return;
+    }
+
+    size_t len = CHUNK_LEN(c);
+    if (CHUNK_HAS_WILD(c, len))
+    {
+        // A wildcard chunk may match any literal child
+        for (size_t i = 0; i < node->literals_len; i++)
+            __zn_rname_trie_match_child(node->literals[i], c, ctx);
+    }
+    else
+    {
+        int found = 0;
+        size_t pos = __zn_rname_trie_literal_search(node, c, len, &found);
+        if (found == 1)
+            __zn_rname_trie_match_node(node->literals[pos], __zn_rname_trie_next(c), ctx);
+    }
+
+    for (_z_list_t *xs = node->wilds; xs != NULL; xs = _z_list_tail(xs))
+        __zn_rname_trie_match_child((_zn_rname_trie_node_t *)_z_list_head(xs), c, ctx);
+}
+
+size_t _zn_rname_trie_match(_zn_rname_trie_t *trie, const z_str_t rname, _zn_rname_trie_visit_f f, void *arg)
+{
+    if (rname == NULL || trie->root == NULL)
+        return 0;
+
+    _zn_rname_trie_match_ctx_t ctx;
+    ctx.epoch = ++trie->epoch;
+    ctx.f = f;
+    ctx.arg = arg;
+    ctx.count = 0;
+
+    __zn_rname_trie_match_node(trie->root, rname, &ctx);
+
+    return ctx.count;
+}
+
+void _zn_rname_trie_clear(_zn_rname_trie_t *trie)
+{
+    if (trie->root != NULL)
+        __zn_rname_trie_node_free(&trie->root);
+}
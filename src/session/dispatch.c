@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include "zenoh-pico/session/dispatch.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/utils/logging.h"
+
+void *_zn_dispatch_worker_task(void *arg)
+{
+    _zn_dispatch_worker_t *w = (_zn_dispatch_worker_t *)arg;
+    zn_session_t *zn = (zn_session_t *)w->session;
+
+    z_mutex_lock(&w->mutex);
+    while (1)
+    {
+        // Wait for a sample, the pending samples are still delivered once stopped
+        while (w->running && w->len == 0)
+            z_condvar_wait(&w->can_pop, &w->mutex);
+        if (w->len == 0)
+            break;
+
+        _zn_dispatch_job_t job = w->jobs[w->head];
+        w->head = (w->head + 1) % ZN_DISPATCH_QUEUE_SIZE;
+        w->len--;
+        z_condvar_signal(&w->can_push);
+        z_mutex_unlock(&w->mutex);
+
+        _zn_activate_subscriptions(zn, job.entry);
+        _zn_deliver_subscriptions(zn, job.entry, job.payload);
+        _zn_deactivate_subscriptions(zn, job.entry);
+        _z_bytes_clear(&job.payload);
+
+        z_mutex_lock(&w->mutex);
+    }
+    z_mutex_unlock(&w->mutex);
+
+    return 0;
+}
+
+_zn_dispatch_pool_t *_zn_dispatch_pool_init(zn_session_t *zn, size_t workers)
+{
+    if (workers == 0)
+        return NULL;
+
+    _zn_dispatch_pool_t *pool = (_zn_dispatch_pool_t *)z_malloc(sizeof(_zn_dispatch_pool_t));
+    pool->users = 0;
+    z_condvar_init(&pool->idle);
+    pool->len = 0;
+    pool->workers = (_zn_dispatch_worker_t *)z_malloc(workers * sizeof(_zn_dispatch_worker_t));
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        _zn_dispatch_worker_t *w = &pool->workers[i];
+        w->session = zn;
+        w->running = 1;
+        w->head = 0;
+        w->len = 0;
+        z_mutex_init(&w->mutex);
+        z_condvar_init(&w->can_push);
+        z_condvar_init(&w->can_pop);
+
+        w->task = (z_task_t *)z_malloc(sizeof(z_task_t));
+        memset(w->task, 0, sizeof(z_task_t));
+        if (z_task_init(w->task, NULL, _zn_dispatch_worker_task, w) != 0)
+        {
+            _Z_DEBUG("Unable to start the dispatch worker %zu\n", i);
+            z_task_free(&w->task);
+            z_condvar_free(&w->can_pop);
+            z_condvar_free(&w->can_push);
+            z_mutex_free(&w->mutex);
+            goto ERR;
+        }
+        pool->len++;
+    }
+
+    return pool;
+
+ERR:
+    _zn_dispatch_pool_free(&pool);
+    return NULL;
+}
+
+int _zn_dispatch_pool_push(_zn_dispatch_pool_t *pool, _zn_subscriber_cache_entry_t *entry, const z_bytes_t payload)
+{
+    // Samples for the same resource name are always handled by the same worker
+    _zn_dispatch_worker_t *w = &pool->workers[entry->hash % pool->len];
+
+    z_mutex_lock(&w->mutex);
+
+    // Apply backpressure on the read task when the worker falls behind
+    while (w->running && w->len == ZN_DISPATCH_QUEUE_SIZE)
+        z_condvar_wait(&w->can_push, &w->mutex);
+    if (!w->running)
+        goto ERR;
+
+    _zn_dispatch_job_t *job = &w->jobs[(w->head + w->len) % ZN_DISPATCH_QUEUE_SIZE];
+    job->entry = entry;
+    _z_bytes_copy(&job->payload, &payload);
+    w->len++;
+    z_condvar_signal(&w->can_pop);
+
+    z_mutex_unlock(&w->mutex);
+    return 0;
+
+ERR:
+    z_mutex_unlock(&w->mutex);
+    _zn_release_subscriptions((zn_session_t *)w->session, entry);
+    return -1;
+}
+
+void _zn_dispatch_pool_free(_zn_dispatch_pool_t **pool)
+{
+    _zn_dispatch_pool_t *ptr = *pool;
+
+    for (size_t i = 0; i < ptr->len; i++)
+    {
+        _zn_dispatch_worker_t *w = &ptr->workers[i];
+
+        z_mutex_lock(&w->mutex);
+        w->running = 0;
+        z_condvar_signal(&w->can_pop);
+        z_condvar_signal(&w->can_push);
+        z_mutex_unlock(&w->mutex);
+
+        // The worker delivers its pending samples before terminating
+        z_task_join(w->task);
+        z_task_free(&w->task);
+
+        z_condvar_free(&w->can_pop);
+        z_condvar_free(&w->can_push);
+        z_mutex_free(&w->mutex);
+    }
+
+    z_condvar_free(&ptr->idle);
+    z_free(ptr->workers);
+    z_free(ptr);
+    *pool = NULL;
+}
+
+int _zn_start_dispatch_pool(zn_session_t *zn, size_t workers)
+{
+    z_mutex_lock(&zn->mutex_inner);
+    if (zn->dispatch_pool != NULL)
+        goto ERR;
+
+    zn->dispatch_pool = _zn_dispatch_pool_init(zn, workers);
+    if (zn->dispatch_pool == NULL)
+        goto ERR;
+
+    z_mutex_unlock(&zn->mutex_inner);
+    return 0;
+
+ERR:
+    z_mutex_unlock(&zn->mutex_inner);
+    return -1;
+}
+
+int _zn_stop_dispatch_pool(zn_session_t *zn)
+{
+    z_mutex_lock(&zn->mutex_inner);
+    _zn_dispatch_pool_t *pool = zn->dispatch_pool;
+    if (pool == NULL)
+        goto ERR;
+
+    // New samples are delivered by the caller, wait for the pushes in progress
+    zn->dispatch_pool = NULL;
+    while (pool->users > 0)
+        z_condvar_wait(&pool->idle, &zn->mutex_inner);
+    z_mutex_unlock(&zn->mutex_inner);
+
+    _zn_dispatch_pool_free(&pool);
+    return 0;
+
+ERR:
+    z_mutex_unlock(&zn->mutex_inner);
+    return -1;
+}
@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include <stddef.h>
 #include "zenoh-pico/protocol/utils.h"
 #include "zenoh-pico/session/query.h"
 #include "zenoh-pico/session/resource.h"
@@ -100,9 +101,83 @@ _zn_pending_query_t *_zn_get_pending_query_by_id(zn_session_t *zn, const z_zint_
     return pql;
 }
 
+static void __zn_call_query_callback(zn_session_t *zn, _zn_pending_query_t *pen_qry, const zn_reply_t reply)
+{
+    _ZN_STATS_CLOCK(start);
+    pen_qry->callback(reply, pen_qry->arg);
+    _ZN_STATS_RECORD(zn, callback_us, start);
+}
+
+static _zn_timers_t *__zn_get_timers(zn_session_t *zn)
+{
+    if (zn->tp->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return &zn->tp->transport.unicast.timers;
+    else
+        return &zn->tp->transport.multicast.timers;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+static void __unsafe_zn_complete_pending_query(zn_session_t *zn, _zn_pending_query_t *pen_qry)
+{
+    // Apply consolidation if needed
+    if (pen_qry->consolidation.reception == zn_consolidation_mode_t_FULL)
+    {
+        z_str_t rname = __unsafe_zn_get_resource_name_from_key(zn, _ZN_RESOURCE_REMOTE, &pen_qry->key);
+
+        _zn_pending_reply_list_t *pen_rps = pen_qry->pending_replies;
+        _zn_pending_reply_t *pen_rep = NULL;
+        while (pen_rps != NULL)
+        {
+            pen_rep = _zn_pending_reply_list_head(pen_rps);
+
+            // Check if this is the same resource key
+            // Trigger the query handler
+            if (zn_rname_intersect(rname, pen_rep->reply->data.data.key.val))
+                __zn_call_query_callback(zn, pen_qry, *pen_rep->reply);
+
+            pen_rps = _zn_pending_reply_list_tail(pen_rps);
+        }
+
+        _z_str_clear(rname);
+    }
+
+    // Trigger the final query handler
+    zn_reply_t freply;
+    memset(&freply, 0, sizeof(zn_reply_t));
+    freply.tag = zn_reply_t_Tag_FINAL;
+    __zn_call_query_callback(zn, pen_qry, freply);
+
+    _zn_timers_cancel(__zn_get_timers(zn), &pen_qry->timer);
+    zn->pending_queries = _zn_pending_query_list_drop_filter(zn->pending_queries, _zn_pending_query_eq, pen_qry);
+}
+
+static void __zn_pending_query_expired(_zn_timer_t *tmr, void *arg)
+{
+    zn_session_t *zn = (zn_session_t *)arg;
+
+    z_mutex_lock(&zn->mutex_inner);
+
+    // The final reply might have been received in the meantime
+    if (_zn_timers_claim(__zn_get_timers(zn), tmr) == 0)
+        goto EXIT;
+
+    _zn_pending_query_t *pen_qry = (_zn_pending_query_t *)((uint8_t *)tmr - offsetof(_zn_pending_query_t, timer));
+    _Z_INFO("Completing query %zu because its final reply has not been received after %dms\n", pen_qry->id, ZN_QUERY_TIMEOUT);
+    __unsafe_zn_complete_pending_query(zn, pen_qry);
+
+EXIT:
+    z_mutex_unlock(&zn->mutex_inner);
+}
+
 int _zn_register_pending_query(zn_session_t *zn, _zn_pending_query_t *pen_qry)
 {
     _Z_DEBUG(">>> Allocating query for (%lu,%s,%s)\n", pen_qry->key.rid, pen_qry->key.rname, pen_qry->predicate);
+    _zn_timer_init(&pen_qry->timer, __zn_pending_query_expired, zn);
+
     z_mutex_lock(&zn->mutex_inner);
 
     _zn_pending_query_t *pql = __unsafe_zn_get_pending_query_by_id(zn, pen_qry->id);
@@ -112,10 +187,16 @@ int _zn_register_pending_query(zn_session_t *zn, _zn_pending_query_t *pen_qry)
     // Register the query
     zn->pending_queries = _zn_pending_query_list_push(zn->pending_queries, pen_qry);
 
+    // Bound the time to wait for the final reply
+#if ZN_QUERY_TIMEOUT > 0
+    _zn_timers_schedule(__zn_get_timers(zn), &pen_qry->timer, ZN_QUERY_TIMEOUT);
+#endif
+
     z_mutex_unlock(&zn->mutex_inner);
     return 0;
 
 ERR:
+    z_mutex_unlock(&zn->mutex_inner);
     return -1;
 }
 
@@ -187,13 +268,13 @@ int _zn_trigger_query_reply_partial(zn_session_t *zn,
 
         // Trigger the handler
         if (pen_qry->consolidation.reception == zn_consolidation_mode_t_LAZY)
-            pen_qry->callback(*pen_rep->reply, pen_qry->arg);
+            __zn_call_query_callback(zn, pen_qry, *pen_rep->reply);
         else
             pen_qry->pending_replies = _zn_pending_reply_list_push(pen_qry->pending_replies, pen_rep);
     }
     else if (pen_qry->consolidation.reception == zn_consolidation_mode_t_NONE)
     {
-        pen_qry->callback(*reply, pen_qry->arg);
+        __zn_call_query_callback(zn, pen_qry, *reply);
         _zn_reply_free(&reply);
     }
 
@@ -224,35 +305,8 @@ int _zn_trigger_query_reply_final(zn_session_t *zn, const _zn_reply_context_t *r
     if (pen_qry->target.kind != ZN_QUERYABLE_ALL_KINDS && (pen_qry->target.kind & reply_context->replier_kind) == 0)
         goto ERR;
 
-    // The reply is the final one, apply consolidation if needed
-    if (pen_qry->consolidation.reception == zn_consolidation_mode_t_FULL)
-    {
-        z_str_t rname = __unsafe_zn_get_resource_name_from_key(zn, _ZN_RESOURCE_REMOTE, &pen_qry->key);
-
-        _zn_pending_reply_list_t *pen_rps = pen_qry->pending_replies;
-        _zn_pending_reply_t *pen_rep = NULL;
-        while (pen_rps != NULL)
-        {
-            pen_rep = _zn_pending_reply_list_head(pen_rps);
-
-            // Check if this is the same resource key
-            // Trigger the query handler
-            if (zn_rname_intersect(rname, pen_rep->reply->data.data.key.val))
-                pen_qry->callback(*pen_rep->reply, pen_qry->arg);
-
-            pen_rps = _zn_pending_reply_list_tail(pen_rps);
-        }
-
-        _z_str_clear(rname);
-    }
-
-    // Trigger the final query handler
-    zn_reply_t freply;
-    memset(&freply, 0, sizeof(zn_reply_t));
-    freply.tag = zn_reply_t_Tag_FINAL;
-    pen_qry->callback(freply, pen_qry->arg);
-
-    zn->pending_queries = _zn_pending_query_list_drop_filter(zn->pending_queries, _zn_pending_query_eq, pen_qry);
+    // The reply is the final one
+    __unsafe_zn_complete_pending_query(zn, pen_qry);
 
     z_mutex_unlock(&zn->mutex_inner);
     return 0;
@@ -265,6 +319,7 @@ ERR:
 void _zn_unregister_pending_query(zn_session_t *zn, _zn_pending_query_t *pen_qry)
 {
     z_mutex_lock(&zn->mutex_inner);
+    _zn_timers_cancel(__zn_get_timers(zn), &pen_qry->timer);
     zn->pending_queries = _zn_pending_query_list_drop_filter(zn->pending_queries, _zn_pending_query_eq, pen_qry);
     z_mutex_unlock(&zn->mutex_inner);
 }
@@ -113,11 +113,51 @@ int _zn_register_queryable(zn_session_t *zn, _zn_queryable_t *qle)
     z_mutex_lock(&zn->mutex_inner);
 
     zn->local_queryables = _zn_queryable_list_push(zn->local_queryables, qle);
+    _zn_rname_trie_insert(&zn->local_queryables_index, qle->rname, qle);
 
     z_mutex_unlock(&zn->mutex_inner);
     return 0;
 }
 
+/**
+ * A snapshot of a matching local queryable, copied from the queryable so that
+ * it can be invoked without holding the session lock.
+ */
+typedef struct
+{
+    zn_queryable_handler_t callback;
+    void *arg;
+    unsigned int kind;
+} _zn_queryable_handler_t;
+
+typedef struct
+{
+    unsigned int target_kind;
+    size_t len;
+    _zn_queryable_handler_t *handlers;
+} __zn_trigger_queryable_ctx_t;
+
+void __zn_trigger_queryable_count(void *val, void *arg)
+{
+    _zn_queryable_t *qle = (_zn_queryable_t *)val;
+    __zn_trigger_queryable_ctx_t *ctx = (__zn_trigger_queryable_ctx_t *)arg;
+    if (((ctx->target_kind & ZN_QUERYABLE_ALL_KINDS) | (ctx->target_kind & qle->kind)) != 0)
+        ctx->len++;
+}
+
+void __zn_trigger_queryable_collect(void *val, void *arg)
+{
+    _zn_queryable_t *qle = (_zn_queryable_t *)val;
+    __zn_trigger_queryable_ctx_t *ctx = (__zn_trigger_queryable_ctx_t *)arg;
+    if (((ctx->target_kind & ZN_QUERYABLE_ALL_KINDS) | (ctx->target_kind & qle->kind)) != 0)
+    {
+        ctx->handlers[ctx->len].callback = qle->callback;
+        ctx->handlers[ctx->len].arg = qle->arg;
+        ctx->handlers[ctx->len].kind = qle->kind;
+        ctx->len++;
+    }
+}
+
 int _zn_trigger_queryables(zn_session_t *zn, const _zn_query_t *query)
 {
     z_mutex_lock(&zn->mutex_inner);
@@ -126,6 +166,22 @@ int _zn_trigger_queryables(zn_session_t *zn, const _zn_query_t *query)
     if (rname == NULL)
         goto ERR;
 
+    // Take a snapshot of the matching local queryables
+    __zn_trigger_queryable_ctx_t ctx;
+    ctx.target_kind = query->target.kind;
+    ctx.len = 0;
+    ctx.handlers = NULL;
+    _zn_rname_trie_match(&zn->local_queryables_index, rname, __zn_trigger_queryable_count, &ctx);
+    if (ctx.len > 0)
+    {
+        ctx.handlers = (_zn_queryable_handler_t *)z_malloc(ctx.len * sizeof(_zn_queryable_handler_t));
+        ctx.len = 0;
+        _zn_rname_trie_match(&zn->local_queryables_index, rname, __zn_trigger_queryable_collect, &ctx);
+    }
+
+    // The callbacks and the final reply do not need the session lock
+    z_mutex_unlock(&zn->mutex_inner);
+
     // Build the query
     zn_query_t q;
     q.zn = zn;
@@ -133,20 +189,17 @@ int _zn_trigger_queryables(zn_session_t *zn, const _zn_query_t *query)
     q.rname = rname;
     q.predicate = query->predicate;
 
-    _zn_queryable_list_t *qles = __unsafe_zn_get_queryables_by_name(zn, rname);
-    _zn_queryable_list_t *xs = qles;
-    while (xs != NULL)
+    for (size_t i = 0; i < ctx.len; i++)
     {
-        _zn_queryable_t *qle = _zn_queryable_list_head(xs);
-        if (((query->target.kind & ZN_QUERYABLE_ALL_KINDS) | (query->target.kind & qle->kind)) != 0)
-        {
-            q.kind = qle->kind;
-            qle->callback(&q, qle->arg);
-        }
-
-        xs = _zn_queryable_list_tail(xs);
+        q.kind = ctx.handlers[i].kind;
+        _ZN_STATS_CLOCK(start);
+        ctx.handlers[i].callback(&q, ctx.handlers[i].arg);
+        _ZN_STATS_RECORD(zn, callback_us, start);
     }
 
+    if (ctx.handlers != NULL)
+        z_free(ctx.handlers);
+
     // Send the final reply
     // Final flagged reply context does not encode the PID or replier kind
     z_bytes_t pid;
@@ -162,15 +215,13 @@ int _zn_trigger_queryables(zn_session_t *zn, const _zn_query_t *query)
     _zn_zenoh_message_t z_msg = _zn_z_msg_make_unit(can_be_dropped);
     z_msg.reply_context = rctx;
 
-    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK) != 0)
+    if (_zn_send_z_msg(zn, &z_msg, zn_reliability_t_RELIABLE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) != 0)
     {
         // @TODO: retransmission
     }
     _zn_z_msg_clear(&z_msg);
 
     _z_str_clear(rname);
-    _z_list_free(&qles, _zn_noop_free);
-    z_mutex_unlock(&zn->mutex_inner);
     return 0;
 
 ERR:
@@ -181,6 +232,7 @@ ERR:
 void _zn_unregister_queryable(zn_session_t *zn, _zn_queryable_t *qle)
 {
     z_mutex_lock(&zn->mutex_inner);
+    _zn_rname_trie_remove(&zn->local_queryables_index, qle->rname, (z_element_eq_f)_zn_queryable_eq, qle);
     zn->local_queryables = _zn_queryable_list_drop_filter(zn->local_queryables, _zn_queryable_eq, qle);
     z_mutex_unlock(&zn->mutex_inner);
 }
@@ -188,6 +240,7 @@ void _zn_unregister_queryable(zn_session_t *zn, _zn_queryable_t *qle)
 void _zn_flush_queryables(zn_session_t *zn)
 {
     z_mutex_lock(&zn->mutex_inner);
+    _zn_rname_trie_clear(&zn->local_queryables_index);
     _zn_queryable_list_free(&zn->local_queryables);
     z_mutex_unlock(&zn->mutex_inner);
 }
@@ -13,6 +13,7 @@
 //
 
 #include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
 #include "zenoh-pico/utils/logging.h"
 
 int _zn_resource_eq(const _zn_resource_t *other, const _zn_resource_t *this)
@@ -37,26 +38,97 @@ z_zint_t _zn_get_resource_id(zn_session_t *zn)
 }
 
 /*------------------ Resource ------------------*/
-_zn_resource_t *__zn_get_resource_by_id(_zn_resource_list_t *xs, const z_zint_t id)
+size_t _zn_reskey_hash(const zn_reskey_t *reskey)
 {
-    while (xs != NULL)
+    size_t hash = (size_t)reskey->rid;
+    if (reskey->rname != NULL)
     {
-        _zn_resource_t *r = _zn_resource_list_head(xs);
-        if (r->id == id)
-            return r;
+        for (const char *c = reskey->rname; *c != '\0'; c++)
+            hash = hash * 31 + (unsigned char)*c;
+    }
 
-        xs = _zn_resource_list_tail(xs);
+    return hash;
+}
+
+int _zn_reskey_eq(const zn_reskey_t *left, const zn_reskey_t *right)
+{
+    if (left->rid != right->rid)
+        return 0;
+
+    if (left->rname == NULL || right->rname == NULL)
+        return left->rname == right->rname;
+
+    return _z_str_eq(left->rname, right->rname);
+}
+
+int __zn_resource_ptr_eq(const void *left, const void *right)
+{
+    return left == right;
+}
+
+/**
+ * The key index maps the hash of a resource key into the list of resources
+ * whose key has such hash. The resources are owned by the id index.
+ */
+void __zn_resource_key_index_entry_free(void **e)
+{
+    _z_int_void_map_entry_t *entry = (_z_int_void_map_entry_t *)*e;
+    _zn_resource_list_t *xs = (_zn_resource_list_t *)entry->val;
+    _z_list_free(&xs, _zn_noop_free);
+
+    z_free(entry);
+    *e = NULL;
+}
+
+void __zn_resource_key_index_insert(_z_int_void_map_t *index, _zn_resource_t *res)
+{
+    size_t hash = _zn_reskey_hash(&res->key);
+    _zn_resource_list_t *xs = (_zn_resource_list_t *)_z_int_void_map_get(index, hash);
+    if (xs == NULL)
+    {
+        _z_int_void_map_insert(index, hash, _zn_resource_list_push(NULL, res), __zn_resource_key_index_entry_free);
+        return;
     }
 
-    return NULL;
+    // Colliding keys are chained after the head of the list, so the map entry does not change
+    xs->tail = _zn_resource_list_push(xs->tail, res);
+}
+
+void __zn_resource_key_index_remove(_z_int_void_map_t *index, _zn_resource_t *res)
+{
+    size_t hash = _zn_reskey_hash(&res->key);
+    _zn_resource_list_t *xs = (_zn_resource_list_t *)_z_int_void_map_get(index, hash);
+    if (xs == NULL)
+        return;
+
+    if (_zn_resource_list_head(xs) != res)
+    {
+        xs->tail = _z_list_drop_filter(xs->tail, _zn_noop_free, __zn_resource_ptr_eq, res);
+    }
+    else if (xs->tail == NULL)
+    {
+        _z_int_void_map_remove(index, hash, __zn_resource_key_index_entry_free);
+    }
+    else
+    {
+        // Replace the head of the list in place with the next colliding resource
+        xs->val = _zn_resource_list_head(xs->tail);
+        xs->tail = _z_list_pop(xs->tail, _zn_noop_free);
+    }
 }
 
-_zn_resource_t *__zn_get_resource_by_key(_zn_resource_list_t *xs, const zn_reskey_t *reskey)
+_zn_resource_t *__zn_get_resource_by_id(_zn_resource_intmap_t *rs, const z_zint_t id)
 {
+    return _zn_resource_intmap_get(rs, (size_t)id);
+}
+
+_zn_resource_t *__zn_get_resource_by_key(_z_int_void_map_t *index, const zn_reskey_t *reskey)
+{
+    _zn_resource_list_t *xs = (_zn_resource_list_t *)_z_int_void_map_get(index, _zn_reskey_hash(reskey));
     while (xs != NULL)
     {
         _zn_resource_t *r = _zn_resource_list_head(xs);
-        if (r->key.rid == reskey->rid && _z_str_eq(r->key.rname, reskey->rname) == 1)
+        if (_zn_reskey_eq(&r->key, reskey))
             return r;
 
         xs = _zn_resource_list_tail(xs);
@@ -65,55 +137,51 @@ _zn_resource_t *__zn_get_resource_by_key(_zn_resource_list_t *xs, const zn_reske
     return NULL;
 }
 
-z_str_t __zn_get_resource_name_from_key(_zn_resource_list_t *xs, const zn_reskey_t *reskey)
+z_str_t __zn_get_resource_name_from_key(_zn_resource_intmap_t *rs, const zn_reskey_t *reskey)
 {
     // Need to build the complete resource name, by recursively look at RIDs
-    // Resource names are looked up from right to left
-    _z_str_list_t *strs = NULL;
-    size_t len = 0;
-
-    // Append suffix as the right-most segment
-    if (reskey->rname != NULL)
-    {
-        len += strlen(reskey->rname);
-        strs = _z_str_list_push(strs, reskey->rname);
-    }
-
-    // Recursevely go through all the RIDs
+    // Compute first the length of the complete resource name, so that it can be
+    // written in a single allocation without any intermediate list of segments
+    size_t len = reskey->rname != NULL ? strlen(reskey->rname) : 0;
     z_zint_t id = reskey->rid;
     while (id != ZN_RESOURCE_ID_NONE)
     {
-        _zn_resource_t *res = __zn_get_resource_by_id(xs, id);
+        _zn_resource_t *res = __zn_get_resource_by_id(rs, id);
         if (res == NULL)
-            goto ERR;
+            return NULL;
 
         if (res->key.rname != NULL)
-        {
             len += strlen(res->key.rname);
-            strs = _z_str_list_push(strs, res->key.rname);
-        }
 
         id = res->key.rid;
     }
 
-    // Concatenate all the partial resource names
     z_str_t rname = (z_str_t)z_malloc(len + 1);
-    rname[0] = '\0'; // NULL terminator must be set (required to strcat)
+    rname[len] = '\0';
 
-    _z_str_list_t *xstr = strs;
-    while (xstr != NULL)
+    // Resource names are written from right to left, starting with the suffix
+    size_t pos = len;
+    if (reskey->rname != NULL)
     {
-        z_str_t s = _z_str_list_head(xstr);
-        strcat(rname, s);
-        xstr = _z_str_list_tail(xstr);
+        pos -= strlen(reskey->rname);
+        memcpy(&rname[pos], reskey->rname, len - pos);
     }
 
-    _z_list_free(&strs, _zn_noop_free);
-    return rname;
+    id = reskey->rid;
+    while (id != ZN_RESOURCE_ID_NONE)
+    {
+        _zn_resource_t *res = __zn_get_resource_by_id(rs, id);
+        if (res->key.rname != NULL)
+        {
+            size_t seg = strlen(res->key.rname);
+            pos -= seg;
+            memcpy(&rname[pos], res->key.rname, seg);
+        }
 
-ERR:
-    _z_list_free(&strs, _zn_noop_free);
-    return NULL;
+        id = res->key.rid;
+    }
+
+    return rname;
 }
 
 /**
@@ -123,7 +191,7 @@ ERR:
  */
 _zn_resource_t *__unsafe_zn_get_resource_by_id(zn_session_t *zn, int is_local, z_zint_t id)
 {
-    _zn_resource_list_t *decls = is_local ? zn->local_resources : zn->remote_resources;
+    _zn_resource_intmap_t *decls = is_local ? &zn->local_resources : &zn->remote_resources;
     return __zn_get_resource_by_id(decls, id);
 }
 
@@ -134,8 +202,8 @@ _zn_resource_t *__unsafe_zn_get_resource_by_id(zn_session_t *zn, int is_local, z
  */
 _zn_resource_t *__unsafe_zn_get_resource_by_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey)
 {
-    _zn_resource_list_t *decls = is_local ? zn->local_resources : zn->remote_resources;
-    return __zn_get_resource_by_key(decls, reskey);
+    _z_int_void_map_t *index = is_local ? &zn->local_resources_by_key : &zn->remote_resources_by_key;
+    return __zn_get_resource_by_key(index, reskey);
 }
 
 /**
@@ -145,7 +213,7 @@ _zn_resource_t *__unsafe_zn_get_resource_by_key(zn_session_t *zn, int is_local,
  */
 z_str_t __unsafe_zn_get_resource_name_from_key(zn_session_t *zn, int is_local, const zn_reskey_t *reskey)
 {
-    _zn_resource_list_t *decls = is_local ? zn->local_resources : zn->remote_resources;
+    _zn_resource_intmap_t *decls = is_local ? &zn->local_resources : &zn->remote_resources;
     return __zn_get_resource_name_from_key(decls, reskey);
 }
 
@@ -184,9 +252,18 @@ int _zn_register_resource(zn_session_t *zn, int is_local, _zn_resource_t *res)
 
     // Register the resource
     if (is_local)
-        zn->local_resources = _zn_resource_list_push(zn->local_resources, res);
+    {
+        _zn_resource_intmap_insert(&zn->local_resources, (size_t)res->id, res);
+        __zn_resource_key_index_insert(&zn->local_resources_by_key, res);
+    }
     else
-        zn->remote_resources = _zn_resource_list_push(zn->remote_resources, res);
+    {
+        _zn_resource_intmap_insert(&zn->remote_resources, (size_t)res->id, res);
+        __zn_resource_key_index_insert(&zn->remote_resources_by_key, res);
+    }
+
+    // The resource names resolved so far may no longer be valid
+    __unsafe_zn_invalidate_subscriptions_cache(zn);
 
     z_mutex_unlock(&zn->mutex_inner);
     return 0;
@@ -200,10 +277,19 @@ void _zn_unregister_resource(zn_session_t *zn, int is_local, _zn_resource_t *res
 {
     z_mutex_lock(&zn->mutex_inner);
 
-    if (is_local)
-        zn->local_resources = _zn_resource_list_drop_filter(zn->local_resources, _zn_resource_eq, res);
-    else
-        zn->remote_resources = _zn_resource_list_drop_filter(zn->remote_resources, _zn_resource_eq, res);
+    _zn_resource_intmap_t *decls = is_local ? &zn->local_resources : &zn->remote_resources;
+    _z_int_void_map_t *index = is_local ? &zn->local_resources_by_key : &zn->remote_resources_by_key;
+
+    // The resource is owned by the id index, drop it from the key index first
+    _zn_resource_t *r = __zn_get_resource_by_id(decls, res->id);
+    if (r != NULL)
+    {
+        __zn_resource_key_index_remove(index, r);
+        _zn_resource_intmap_remove(decls, (size_t)r->id);
+    }
+
+    // The resource names resolved so far may no longer be valid
+    __unsafe_zn_invalidate_subscriptions_cache(zn);
 
     z_mutex_unlock(&zn->mutex_inner);
 }
@@ -212,8 +298,11 @@ void _zn_flush_resources(zn_session_t *zn)
 {
     z_mutex_lock(&zn->mutex_inner);
 
-    _zn_resource_list_free(&zn->local_resources);
-    _zn_resource_list_free(&zn->remote_resources);
+    _z_int_void_map_clear(&zn->local_resources_by_key, __zn_resource_key_index_entry_free);
+    _z_int_void_map_clear(&zn->remote_resources_by_key, __zn_resource_key_index_entry_free);
+    _zn_resource_intmap_clear(&zn->local_resources);
+    _zn_resource_intmap_clear(&zn->remote_resources);
+    __unsafe_zn_invalidate_subscriptions_cache(zn);
 
     z_mutex_unlock(&zn->mutex_inner);
 }
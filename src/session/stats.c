@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/session/stats.h"
+
+#if defined(__GNUC__)
+#define _ZN_STATS_LOAD(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+#define _ZN_STATS_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+#else
+#define _ZN_STATS_LOAD(p) (*(p))
+#define _ZN_STATS_STORE(p, v) (*(p) = (v))
+#endif
+
+/*------------------ Counters ------------------*/
+void _zn_stats_add(size_t *counter, size_t n)
+{
+    // Counters are not used for synchronization, relaxed atomics are enough.
+    // Without compiler support, concurrent updates may be lost.
+#if defined(__GNUC__)
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+#else
+    *counter += n;
+#endif
+}
+
+static void __zn_stats_max(size_t *max, size_t v)
+{
+#if defined(__GNUC__)
+    size_t cur = __atomic_load_n(max, __ATOMIC_RELAXED);
+    while (v > cur && !__atomic_compare_exchange_n(max, &cur, v, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+#else
+    if (v > *max)
+        *max = v;
+#endif
+}
+
+void _zn_stats_traffic(zn_stats_traffic_t *t, uint8_t header, size_t bytes)
+{
+    _zn_stats_add(&t->bytes, bytes);
+    _zn_stats_add(&t->t_msgs, 1);
+    _zn_stats_add(&t->msgs_by_mid[_ZN_MID(header)], 1);
+    if (_ZN_MID(header) == _ZN_MID_FRAME)
+        _zn_stats_add(&t->frames[_ZN_HAS_FLAG(header, _ZN_FLAG_T_R) ? zn_reliability_t_RELIABLE : zn_reliability_t_BEST_EFFORT], 1);
+}
+
+void _zn_stats_z_msg(zn_stats_traffic_t *t, uint8_t header, zn_reliability_t reliability)
+{
+    _zn_stats_add(&t->z_msgs, 1);
+    _zn_stats_add(&t->z_msgs_by_reliability[reliability], 1);
+    _zn_stats_add(&t->msgs_by_mid[_ZN_MID(header)], 1);
+}
+
+void _zn_stats_snapshot(const zn_stats_t *src, zn_stats_t *dst)
+{
+    // The statistics are only made of size_t counters, read them one by one
+    const size_t *s = (const size_t *)src;
+    size_t *d = (size_t *)dst;
+    for (size_t i = 0; i < sizeof(zn_stats_t) / sizeof(size_t); i++)
+        d[i] = _ZN_STATS_LOAD(&s[i]);
+}
+
+void _zn_stats_reset(zn_stats_t *stats)
+{
+    size_t *s = (size_t *)stats;
+    for (size_t i = 0; i < sizeof(zn_stats_t) / sizeof(size_t); i++)
+        _ZN_STATS_STORE(&s[i], 0);
+}
+
+/*------------------ Histograms ------------------*/
+static size_t __zn_histogram_bucket(size_t v)
+{
+    if (v >= ((size_t)1 << ZN_STATS_HIST_MAX_BITS))
+        v = ((size_t)1 << ZN_STATS_HIST_MAX_BITS) - 1;
+    if (v < ((size_t)1 << ZN_STATS_HIST_SUB_BITS))
+        return v;
+
+    // Each power of two above the first buckets is split in buckets of the same width
+#if defined(__GNUC__)
+    size_t msb = 63 - (size_t)__builtin_clzll((unsigned long long)v);
+#else
+    size_t msb = 0;
+    while ((v >> msb) > 1)
+        msb++;
+#endif
+    size_t shift = msb - ZN_STATS_HIST_SUB_BITS;
+    return ((shift + 1) << ZN_STATS_HIST_SUB_BITS) + ((v >> shift) - ((size_t)1 << ZN_STATS_HIST_SUB_BITS));
+}
+
+size_t zn_histogram_bucket_upper(size_t bucket)
+{
+    if (bucket < ((size_t)1 << ZN_STATS_HIST_SUB_BITS))
+        return bucket + 1;
+
+    size_t shift = (bucket >> ZN_STATS_HIST_SUB_BITS) - 1;
+    size_t sub = bucket & (((size_t)1 << ZN_STATS_HIST_SUB_BITS) - 1);
+    return ((((size_t)1 << ZN_STATS_HIST_SUB_BITS) + sub) << shift) + ((size_t)1 << shift);
+}
+
+void _zn_histogram_record(zn_histogram_t *h, z_clock_t *start)
+{
+    // The clock may go backwards, count such durations as null
+    clock_t elapsed = z_clock_elapsed_us(start);
+    size_t v = elapsed > 0 ? (size_t)elapsed : 0;
+
+    _zn_stats_add(&h->count, 1);
+    _zn_stats_add(&h->sum, v);
+    _zn_stats_add(&h->buckets[__zn_histogram_bucket(v)], 1);
+    __zn_stats_max(&h->max, v);
+}
+
+size_t zn_histogram_percentile(const zn_histogram_t *h, double percentile)
+{
+    if (h->count == 0)
+        return 0;
+
+    // Rank of the percentile among the recorded values, starting from 1
+    double rank = percentile / 100.0 * (double)h->count;
+    size_t target = rank < 1.0 ? 1 : (size_t)rank;
+    if ((double)target < rank)
+        target++;
+
+    size_t seen = 0;
+    for (size_t i = 0; i < ZN_STATS_HIST_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if (seen >= target)
+        {
+            // Values are integers, the largest one of the bucket is below its upper bound
+            size_t upper = zn_histogram_bucket_upper(i) - 1;
+            return upper < h->max ? upper : h->max;
+        }
+    }
+
+    return h->max;
+}
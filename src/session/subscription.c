@@ -13,10 +13,15 @@
 //
 
 #include "zenoh-pico/protocol/utils.h"
+#include "zenoh-pico/session/dispatch.h"
 #include "zenoh-pico/session/subscription.h"
 #include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/utils/logging.h"
 
+// The dead flag of the subscriptions is read by the deliveries without the session lock
+#define _ZN_SUB_IS_DEAD(sub) __atomic_load_n(&(sub)->dead, __ATOMIC_ACQUIRE)
+#define _ZN_SUB_SET_DEAD(sub) __atomic_store_n(&(sub)->dead, 1, __ATOMIC_RELEASE)
+
 int _zn_subscriber_eq(const _zn_subscriber_t *other, const _zn_subscriber_t *this)
 {
     return this->id == other->id;
@@ -30,6 +35,144 @@ void _zn_subscriber_clear(_zn_subscriber_t *sub)
         z_free(sub->info.period);
 }
 
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+void __unsafe_zn_release_subscription(_zn_subscriber_t *sub)
+{
+    sub->refcount--;
+    if (sub->refcount > 0)
+        return;
+
+    _zn_subscriber_clear(sub);
+    z_free(sub);
+}
+
+/*------------------ Dispatch cache ------------------*/
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+void __unsafe_zn_release_subscriptions_cache_entry(_zn_subscriber_cache_entry_t *entry)
+{
+    entry->refcount--;
+    if (entry->refcount > 0)
+        return;
+
+    for (size_t i = 0; i < entry->len; i++)
+        __unsafe_zn_release_subscription(entry->handlers[i].sub);
+
+    // Unlink the snapshot from the ones alive
+    *entry->pprev = entry->next;
+    if (entry->next != NULL)
+        entry->next->pprev = entry->pprev;
+
+    z_condvar_free(&entry->idle);
+    _zn_reskey_clear(&entry->key);
+    _z_str_clear(entry->rname);
+    if (entry->handlers != NULL)
+        z_free(entry->handlers);
+    z_free(entry);
+}
+
+void __zn_subscriber_cache_entry_free(void **e)
+{
+    _z_int_void_map_entry_t *entry = (_z_int_void_map_entry_t *)*e;
+
+    // Drop the reference held by the cache, the snapshot might still be in use
+    __unsafe_zn_release_subscriptions_cache_entry((_zn_subscriber_cache_entry_t *)entry->val);
+
+    z_free(entry);
+    *e = NULL;
+}
+
+void __zn_subscriber_cache_count(void *val, void *arg)
+{
+    (void)(val);
+    (void)(arg);
+}
+
+void __zn_subscriber_cache_collect(void *val, void *arg)
+{
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)val;
+    _zn_subscriber_cache_entry_t *entry = (_zn_subscriber_cache_entry_t *)arg;
+
+    sub->refcount++;
+    entry->handlers[entry->len].sub = sub;
+    entry->len++;
+}
+
+size_t __zn_rname_hash(const z_str_t rname)
+{
+    // FNV-1a
+    size_t hash = 2166136261u;
+    for (const char *c = rname; *c != '\0'; c++)
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    return hash;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+void __unsafe_zn_invalidate_subscriptions_cache(zn_session_t *zn)
+{
+    _z_int_void_map_clear(&zn->local_subscriptions_cache, __zn_subscriber_cache_entry_free);
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+_zn_subscriber_cache_entry_t *__unsafe_zn_get_subscriptions_cache_entry(zn_session_t *zn, const zn_reskey_t *reskey)
+{
+    size_t hash = _zn_reskey_hash(reskey);
+    _zn_subscriber_cache_entry_t *entry = (_zn_subscriber_cache_entry_t *)_z_int_void_map_get(&zn->local_subscriptions_cache, hash);
+    if (entry != NULL && _zn_reskey_eq(&entry->key, reskey))
+        return entry;
+
+    // Cache miss: resolve the resource name and look up the matching subscriptions
+    z_str_t rname = __unsafe_zn_get_resource_name_from_key(zn, _ZN_RESOURCE_REMOTE, reskey);
+    if (rname == NULL)
+        return NULL;
+
+    entry = (_zn_subscriber_cache_entry_t *)z_malloc(sizeof(_zn_subscriber_cache_entry_t));
+    entry->refcount = 1;
+    entry->active = 0;
+    z_condvar_init(&entry->idle);
+    entry->key = _zn_reskey_duplicate(reskey);
+    entry->hash = __zn_rname_hash(rname);
+    entry->rname = rname;
+    entry->len = 0;
+    entry->handlers = NULL;
+
+    size_t len = _zn_rname_trie_match(&zn->local_subscriptions_index, rname, __zn_subscriber_cache_count, NULL);
+    if (len > 0)
+    {
+        entry->handlers = (_zn_subscriber_handler_t *)z_malloc(len * sizeof(_zn_subscriber_handler_t));
+        _zn_rname_trie_match(&zn->local_subscriptions_index, rname, __zn_subscriber_cache_collect, entry);
+    }
+
+    // Link the snapshot to the ones alive
+    entry->next = zn->local_subscriptions_snapshots;
+    if (entry->next != NULL)
+        entry->next->pprev = &entry->next;
+    entry->pprev = &zn->local_subscriptions_snapshots;
+    zn->local_subscriptions_snapshots = entry;
+
+    // Keep the cache bounded, colliding entries are simply replaced
+    if (_z_int_void_map_len(&zn->local_subscriptions_cache) >= ZN_SUBSCRIPTIONS_CACHE_SIZE)
+        __unsafe_zn_invalidate_subscriptions_cache(zn);
+    _z_int_void_map_insert(&zn->local_subscriptions_cache, hash, entry, __zn_subscriber_cache_entry_free);
+
+    return entry;
+}
+
 /*------------------ Pull ------------------*/
 z_zint_t _zn_get_pull_id(zn_session_t *zn)
 {
@@ -126,7 +269,13 @@ int _zn_register_subscription(zn_session_t *zn, int is_local, _zn_subscriber_t *
 
     // Register the subscription
     if (is_local)
+    {
+        sub->refcount = 1;
+        sub->dead = 0;
         zn->local_subscriptions = _zn_subscriber_list_push(zn->local_subscriptions, sub);
+        _zn_rname_trie_insert(&zn->local_subscriptions_index, sub->rname, sub);
+        __unsafe_zn_invalidate_subscriptions_cache(zn);
+    }
     else
         zn->remote_subscriptions = _zn_subscriber_list_push(zn->remote_subscriptions, sub);
 
@@ -138,46 +287,152 @@ ERR:
     return -1;
 }
 
-int _zn_trigger_subscriptions(zn_session_t *zn, const zn_reskey_t reskey, const z_bytes_t payload)
+void _zn_deliver_subscriptions(zn_session_t *zn, const _zn_subscriber_cache_entry_t *entry, const z_bytes_t payload)
 {
-    z_mutex_lock(&zn->mutex_inner);
-
-    z_str_t rname = __unsafe_zn_get_resource_name_from_key(zn, _ZN_RESOURCE_REMOTE, &reskey);
-    if (rname == NULL)
-        goto ERR;
-
     // Build the sample
     zn_sample_t s;
-    s.key.val = rname;
+    s.key.val = entry->rname;
     s.key.len = strlen(s.key.val);
     s.value = payload;
 
-    _zn_subscriber_list_t *subs = __unsafe_zn_get_subscriptions_by_name(zn, _ZN_RESOURCE_IS_LOCAL, rname);
-    _zn_subscriber_list_t *xs = subs;
-    while (xs != NULL)
+    for (size_t i = 0; i < entry->len; i++)
     {
-        _zn_subscriber_t *sub = _zn_subscriber_list_head(xs);
+        // Skip the subscriptions undeclared since the snapshot has been taken,
+        // undeclaring waits for the snapshot to be deactivated otherwise
+        _zn_subscriber_t *sub = entry->handlers[i].sub;
+        if (_ZN_SUB_IS_DEAD(sub))
+            continue;
+
+        _ZN_STATS_CLOCK(start);
         sub->callback(&s, sub->arg);
-        xs = _zn_subscriber_list_tail(xs);
+        _ZN_STATS_RECORD(zn, callback_us, start);
     }
+}
 
-    _z_str_clear(rname);
-    _z_list_free(&subs, _zn_noop_free);
+void _zn_activate_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry)
+{
+    z_mutex_lock(&zn->mutex_inner);
+    entry->active++;
     z_mutex_unlock(&zn->mutex_inner);
+}
+
+void _zn_deactivate_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry)
+{
+    z_mutex_lock(&zn->mutex_inner);
+    entry->active--;
+    if (entry->active == 0)
+        z_condvar_signal(&entry->idle);
+    __unsafe_zn_release_subscriptions_cache_entry(entry);
+    z_mutex_unlock(&zn->mutex_inner);
+}
+
+void _zn_release_subscriptions(zn_session_t *zn, _zn_subscriber_cache_entry_t *entry)
+{
+    z_mutex_lock(&zn->mutex_inner);
+    __unsafe_zn_release_subscriptions_cache_entry(entry);
+    z_mutex_unlock(&zn->mutex_inner);
+}
+
+int _zn_trigger_subscriptions(zn_session_t *zn, const zn_reskey_t reskey, const z_bytes_t payload)
+{
+    z_mutex_lock(&zn->mutex_inner);
+
+    // In steady state, the resource name and the subscriptions are retrieved from the cache
+    _zn_subscriber_cache_entry_t *entry = __unsafe_zn_get_subscriptions_cache_entry(zn, &reskey);
+    if (entry == NULL)
+        goto ERR;
+
+    // Hold a reference on the snapshot, so that the callbacks run without the session lock
+    entry->refcount++;
+
+    // Keep the dispatch pool alive until the sample has been pushed
+    _zn_dispatch_pool_t *pool = entry->len > 0 ? zn->dispatch_pool : NULL;
+    if (pool != NULL)
+        pool->users++;
+    else
+        entry->active++;
+    z_mutex_unlock(&zn->mutex_inner);
+
+    // Hand the sample over to the dispatch pool, which takes the reference
+    if (pool != NULL)
+    {
+        int res = _zn_dispatch_pool_push(pool, entry, payload);
+
+        z_mutex_lock(&zn->mutex_inner);
+        pool->users--;
+        if (pool->users == 0 && zn->dispatch_pool != pool)
+            z_condvar_signal(&pool->idle);
+        z_mutex_unlock(&zn->mutex_inner);
+        return res;
+    }
+
+    _zn_deliver_subscriptions(zn, entry, payload);
+    _zn_deactivate_subscriptions(zn, entry);
     return 0;
 
 ERR:
-    _z_str_clear(rname);
     z_mutex_unlock(&zn->mutex_inner);
     return -1;
 }
 
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+_zn_subscriber_cache_entry_t *__unsafe_zn_get_active_snapshot(zn_session_t *zn, const _zn_subscriber_t *sub)
+{
+    for (_zn_subscriber_cache_entry_t *entry = zn->local_subscriptions_snapshots; entry != NULL; entry = entry->next)
+    {
+        if (entry->active == 0)
+            continue;
+
+        for (size_t i = 0; i < entry->len; i++)
+        {
+            if (entry->handlers[i].sub == sub)
+                return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->mutex_inner
+ */
+void __unsafe_zn_kill_subscription(zn_session_t *zn, _zn_subscriber_t *sub)
+{
+    // The snapshots still in flight skip the subscription from now on,
+    // wait for the deliveries already in progress on the snapshots pointing to it
+    _ZN_SUB_SET_DEAD(sub);
+    _zn_subscriber_cache_entry_t *entry;
+    while ((entry = __unsafe_zn_get_active_snapshot(zn, sub)) != NULL)
+    {
+        entry->refcount++;
+        while (entry->active > 0)
+            z_condvar_wait(&entry->idle, &zn->mutex_inner);
+
+        // Wake up the next undeclaration waiting on the same snapshot, if any
+        z_condvar_signal(&entry->idle);
+        __unsafe_zn_release_subscriptions_cache_entry(entry);
+    }
+
+    __unsafe_zn_release_subscription(sub);
+}
+
 void _zn_unregister_subscription(zn_session_t *zn, int is_local, _zn_subscriber_t *sub)
 {
     z_mutex_lock(&zn->mutex_inner);
 
     if (is_local)
-        zn->local_subscriptions = _zn_subscriber_list_drop_filter(zn->local_subscriptions, _zn_subscriber_eq, sub);
+    {
+        _zn_rname_trie_remove(&zn->local_subscriptions_index, sub->rname, (z_element_eq_f)_zn_subscriber_eq, sub);
+        __unsafe_zn_invalidate_subscriptions_cache(zn);
+        zn->local_subscriptions = _z_list_drop_filter(zn->local_subscriptions, _zn_noop_free, (z_element_eq_f)_zn_subscriber_eq, sub);
+
+        __unsafe_zn_kill_subscription(zn, sub);
+    }
     else
         zn->remote_subscriptions = _zn_subscriber_list_drop_filter(zn->remote_subscriptions, _zn_subscriber_eq, sub);
 
@@ -188,7 +443,14 @@ void _zn_flush_subscriptions(zn_session_t *zn)
 {
     z_mutex_lock(&zn->mutex_inner);
 
-    _zn_subscriber_list_free(&zn->local_subscriptions);
+    _zn_rname_trie_clear(&zn->local_subscriptions_index);
+    __unsafe_zn_invalidate_subscriptions_cache(zn);
+    while (zn->local_subscriptions != NULL)
+    {
+        _zn_subscriber_t *sub = _zn_subscriber_list_head(zn->local_subscriptions);
+        zn->local_subscriptions = _z_list_pop(zn->local_subscriptions, _zn_noop_free);
+        __unsafe_zn_kill_subscription(zn, sub);
+    }
     _zn_subscriber_list_free(&zn->remote_subscriptions);
 
     z_mutex_unlock(&zn->mutex_inner);
@@ -15,14 +15,19 @@
 #include "zenoh-pico/transport/link/tx.h"
 #include "zenoh-pico/utils/logging.h"
 
-int _zn_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl)
+int _zn_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority)
 {
     _Z_DEBUG(">> send zenoh message\n");
 
+    _ZN_STATS_CLOCK(start);
+
+    int res = -1;
     if (zn->tp->type == _ZN_TRANSPORT_UNICAST_TYPE)
-        return _zn_unicast_send_z_msg(zn, z_msg, reliability, cong_ctrl);
+        res = _zn_unicast_send_z_msg(zn, z_msg, reliability, cong_ctrl, priority);
     else if (zn->tp->type == _ZN_TRANSPORT_MULTICAST_TYPE)
-        return _zn_multicast_send_z_msg(zn, z_msg, reliability, cong_ctrl);
-    else
-        return -1;
+        res = _zn_multicast_send_z_msg(zn, z_msg, reliability, cong_ctrl, priority);
+
+    _ZN_STATS_RECORD(zn, send_us, start);
+
+    return res;
 }
@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include "zenoh-pico/session/dispatch.h"
 #include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/session/subscription.h"
 #include "zenoh-pico/session/queryable.h"
@@ -52,12 +53,22 @@ zn_session_t *_zn_session_init(void)
     zn->pull_id = 1;
 
     // Initialize the data structs
-    zn->local_resources = NULL;
-    zn->remote_resources = NULL;
+    _z_int_void_map_init(&zn->local_resources, ZN_RESOURCES_MAP_CAPACITY);
+    _z_int_void_map_init(&zn->remote_resources, ZN_RESOURCES_MAP_CAPACITY);
+    _z_int_void_map_init(&zn->local_resources_by_key, ZN_RESOURCES_MAP_CAPACITY);
+    _z_int_void_map_init(&zn->remote_resources_by_key, ZN_RESOURCES_MAP_CAPACITY);
     zn->local_subscriptions = NULL;
     zn->remote_subscriptions = NULL;
     zn->local_queryables = NULL;
     zn->pending_queries = NULL;
+    _zn_rname_trie_init(&zn->local_subscriptions_index);
+    _z_int_void_map_init(&zn->local_subscriptions_cache, ZN_SUBSCRIPTIONS_CACHE_SIZE);
+    zn->local_subscriptions_snapshots = NULL;
+    _zn_rname_trie_init(&zn->local_queryables_index);
+    zn->dispatch_pool = NULL;
+#if ZN_STATS == 1
+    _zn_stats_reset(&zn->stats);
+#endif
 
     // Associate a transport with the session
     zn->tp = NULL;
@@ -73,6 +84,9 @@ void _zn_session_free(zn_session_t **zn)
 {
     zn_session_t *ptr = *zn;
 
+    // Deliver the pending samples and stop the dispatch pool
+    _zn_stop_dispatch_pool(ptr);
+
     // Clean up transports and manager
     _zn_transport_manager_free(&ptr->tp_manager);
     if (ptr->tp != NULL)
@@ -47,17 +47,17 @@ void z_random_fill(void *buf, size_t len)
 }
 
 /*------------------ Memory ------------------*/
-void *z_malloc(size_t size)
+void *z_sys_malloc(size_t size)
 {
     return heap_caps_malloc(size, MALLOC_CAP_8BIT);
 }
 
-void *z_realloc(void *ptr, size_t size)
+void *z_sys_realloc(void *ptr, size_t size)
 {
     return heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT);
 }
 
-void z_free(void *ptr)
+void z_sys_free(void *ptr)
 {
     heap_caps_free(ptr);
 }
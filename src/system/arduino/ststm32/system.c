@@ -47,18 +47,18 @@ void z_random_fill(void *buf, size_t len)
 }
 
 /*------------------ Memory ------------------*/
-void *z_malloc(size_t size)
+void *z_sys_malloc(size_t size)
 {
     return pvPortMalloc(size);
 }
 
-void *z_realloc(void *ptr, size_t size)
+void *z_sys_realloc(void *ptr, size_t size)
 {
     // TODO: not implemented
     return NULL;
 }
 
-void z_free(void *ptr)
+void z_sys_free(void *ptr)
 {
     vPortFree(ptr);
 }
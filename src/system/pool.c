@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <string.h>
+#include "zenoh-pico/system/platform.h"
+
+/*------------------ Platform allocator ------------------*/
+#if ZN_MEMORY_POOL == 0
+void *z_malloc(size_t size)
+{
+    return z_sys_malloc(size);
+}
+
+void *z_realloc(void *ptr, size_t size)
+{
+    return z_sys_realloc(ptr, size);
+}
+
+void z_free(void *ptr)
+{
+    z_sys_free(ptr);
+}
+#endif
+
+/*------------------ Memory pool ------------------*/
+// The header of each block, it links the free blocks of a size class together
+typedef union __z_pool_block_t
+{
+    struct
+    {
+        size_t size;
+        uint8_t size_class;
+        uint8_t subsystem;
+    } info;
+    union __z_pool_block_t *next;
+    long double align;
+} _z_pool_block_t;
+
+// The pool is initialized once, by the first allocation, whatever the task performing it
+#define _Z_POOL_UNINIT 0
+#define _Z_POOL_INITIALIZING 1
+#define _Z_POOL_READY 2
+
+static int _z_pool_state = _Z_POOL_UNINIT;
+static z_mutex_t _z_pool_mutex;
+static _z_pool_block_t *_z_pool_free_lists[Z_POOL_CLASSES_NUM];
+static z_pool_stats_t _z_pool_stats;
+
+static void __z_pool_init(void)
+{
+    int expected = _Z_POOL_UNINIT;
+    if (__atomic_compare_exchange_n(&_z_pool_state, &expected, _Z_POOL_INITIALIZING, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+    {
+        z_mutex_init(&_z_pool_mutex);
+        memset(&_z_pool_stats, 0, sizeof(z_pool_stats_t));
+        for (uint8_t c = 0; c < Z_POOL_CLASSES_NUM; c++)
+        {
+            _z_pool_free_lists[c] = NULL;
+            _z_pool_stats.classes[c].block_size = (size_t)Z_POOL_MIN_BLOCK_SIZE << c;
+        }
+        __atomic_store_n(&_z_pool_state, _Z_POOL_READY, __ATOMIC_RELEASE);
+        return;
+    }
+
+    // Another task is initializing the pool, wait for it
+    while (__atomic_load_n(&_z_pool_state, __ATOMIC_ACQUIRE) != _Z_POOL_READY)
+        z_sleep_us(1);
+}
+
+static void __z_pool_lock(void)
+{
+    if (__atomic_load_n(&_z_pool_state, __ATOMIC_ACQUIRE) != _Z_POOL_READY)
+        __z_pool_init();
+
+    z_mutex_lock(&_z_pool_mutex);
+}
+
+static void __z_pool_unlock(void)
+{
+    z_mutex_unlock(&_z_pool_mutex);
+}
+
+uint8_t __z_pool_size_class(size_t size)
+{
+    uint8_t c = 0;
+    while (c < Z_POOL_CLASSES_NUM && ((size_t)Z_POOL_MIN_BLOCK_SIZE << c) < size)
+        c++;
+
+    return c;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - _z_pool_mutex
+ */
+int __unsafe_z_pool_refill(uint8_t c)
+{
+    // Carve as many blocks as fit in a chunk, and at least one
+    size_t block_size = sizeof(_z_pool_block_t) + ((size_t)Z_POOL_MIN_BLOCK_SIZE << c);
+    size_t n = ZN_MEMORY_POOL_CHUNK_SIZE / block_size;
+    if (n == 0)
+        n = 1;
+
+    uint8_t *chunk = (uint8_t *)z_sys_malloc(n * block_size);
+    if (chunk == NULL)
+        return -1;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        _z_pool_block_t *block = (_z_pool_block_t *)(chunk + i * block_size);
+        block->next = _z_pool_free_lists[c];
+        _z_pool_free_lists[c] = block;
+    }
+    _z_pool_stats.classes[c].blocks += n;
+    _z_pool_stats.reserved += n * block_size;
+
+    return 0;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - _z_pool_mutex
+ */
+void __unsafe_z_pool_account_alloc(const _z_pool_block_t *block)
+{
+    z_pool_class_stats_t *cs = &_z_pool_stats.classes[block->info.size_class];
+    cs->in_use++;
+    cs->allocs++;
+    if (cs->in_use > cs->peak)
+        cs->peak = cs->in_use;
+
+    z_pool_subsystem_stats_t *ss = &_z_pool_stats.subsystems[block->info.subsystem];
+    ss->in_use += block->info.size;
+    ss->allocs++;
+    if (ss->in_use > ss->peak)
+        ss->peak = ss->in_use;
+}
+
+void *_z_pool_malloc(size_t size, z_mem_subsystem_t subsystem)
+{
+    uint8_t c = __z_pool_size_class(size);
+    _z_pool_block_t *block = NULL;
+
+    __z_pool_lock();
+    if (c == Z_POOL_CLASSES_NUM)
+    {
+        // Larger allocations are served by the platform allocator
+        block = (_z_pool_block_t *)z_sys_malloc(sizeof(_z_pool_block_t) + size);
+        if (block == NULL)
+            goto EXIT_POOL_MALLOC;
+    }
+    else
+    {
+        if (_z_pool_free_lists[c] == NULL && __unsafe_z_pool_refill(c) != 0)
+            goto EXIT_POOL_MALLOC;
+
+        block = _z_pool_free_lists[c];
+        _z_pool_free_lists[c] = block->next;
+    }
+
+    block->info.size = size;
+    block->info.size_class = c;
+    block->info.subsystem = (uint8_t)subsystem;
+    __unsafe_z_pool_account_alloc(block);
+
+EXIT_POOL_MALLOC:
+    __z_pool_unlock();
+
+    return block == NULL ? NULL : (void *)(block + 1);
+}
+
+void _z_pool_free(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    _z_pool_block_t *block = (_z_pool_block_t *)ptr - 1;
+    uint8_t c = block->info.size_class;
+
+    __z_pool_lock();
+    _z_pool_stats.classes[c].in_use--;
+    z_pool_subsystem_stats_t *ss = &_z_pool_stats.subsystems[block->info.subsystem];
+    ss->in_use -= block->info.size;
+    ss->frees++;
+
+    if (c == Z_POOL_CLASSES_NUM)
+    {
+        z_sys_free(block);
+    }
+    else
+    {
+        block->next = _z_pool_free_lists[c];
+        _z_pool_free_lists[c] = block;
+    }
+    __z_pool_unlock();
+}
+
+void *_z_pool_realloc(void *ptr, size_t size, z_mem_subsystem_t subsystem)
+{
+    if (ptr == NULL)
+        return _z_pool_malloc(size, subsystem);
+
+    _z_pool_block_t *block = (_z_pool_block_t *)ptr - 1;
+    uint8_t c = block->info.size_class;
+
+    // Keep the block if it is large enough
+    if (c < Z_POOL_CLASSES_NUM && size <= ((size_t)Z_POOL_MIN_BLOCK_SIZE << c))
+    {
+        __z_pool_lock();
+        z_pool_subsystem_stats_t *ss = &_z_pool_stats.subsystems[block->info.subsystem];
+        ss->in_use = ss->in_use - block->info.size + size;
+        if (ss->in_use > ss->peak)
+            ss->peak = ss->in_use;
+        block->info.size = size;
+        __z_pool_unlock();
+
+        return ptr;
+    }
+
+    void *new_ptr = _z_pool_malloc(size, subsystem);
+    if (new_ptr == NULL)
+        return NULL;
+
+    memcpy(new_ptr, ptr, block->info.size < size ? block->info.size : size);
+    _z_pool_free(ptr);
+
+    return new_ptr;
+}
+
+void z_pool_stats(z_pool_stats_t *stats)
+{
+    __z_pool_lock();
+    *stats = _z_pool_stats;
+    __z_pool_unlock();
+}
@@ -21,12 +21,38 @@
 #include <netdb.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/system/platform.h"
 #include "zenoh-pico/collections/string.h"
 #include "zenoh-pico/utils/logging.h"
 
+/*------------------ Gather writes ------------------*/
+#if ZN_LINK_TCP == 1 || ZN_LINK_UDP_UNICAST == 1 || ZN_LINK_UDP_MULTICAST == 1
+static size_t _zn_sendmsg(int sock, const z_bytes_t *bufs, size_t n, struct sockaddr *addr, socklen_t addrlen, int flags)
+{
+    struct iovec iov[ZN_LINK_WRITE_VEC_SIZE];
+    if (n > ZN_LINK_WRITE_VEC_SIZE)
+        n = ZN_LINK_WRITE_VEC_SIZE;
+    for (size_t i = 0; i < n; i++)
+    {
+        iov[i].iov_base = (void *)bufs[i].val;
+        iov[i].iov_len = bufs[i].len;
+    }
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = addr;
+    msg.msg_namelen = addrlen;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n;
+
+    return sendmsg(sock, &msg, flags);
+}
+#endif
+
 #if ZN_LINK_TCP == 1
 
 /*------------------ TCP sockets ------------------*/
@@ -150,6 +176,15 @@ size_t _zn_send_tcp(int sock, const uint8_t *ptr, size_t len)
     return send(sock, ptr, len, 0);
 #endif
 }
+
+size_t _zn_send_vec_tcp(int sock, const z_bytes_t *bufs, size_t n)
+{
+#if defined(ZENOH_LINUX)
+    return _zn_sendmsg(sock, bufs, n, NULL, 0, MSG_NOSIGNAL);
+#else
+    return _zn_sendmsg(sock, bufs, n, NULL, 0, 0);
+#endif
+}
 #endif
 
 #if ZN_LINK_UDP_UNICAST == 1 || ZN_LINK_UDP_MULTICAST == 1
@@ -253,6 +288,13 @@ size_t _zn_send_udp_unicast(int sock, const uint8_t *ptr, size_t len, void *arg)
 
     return sendto(sock, ptr, len, 0, raddr->ai_addr, raddr->ai_addrlen);
 }
+
+size_t _zn_send_vec_udp_unicast(int sock, const z_bytes_t *bufs, size_t n, void *arg)
+{
+    struct addrinfo *raddr = (struct addrinfo *)arg;
+
+    return _zn_sendmsg(sock, bufs, n, raddr->ai_addr, raddr->ai_addrlen, 0);
+}
 #endif
 
 #if ZN_LINK_UDP_MULTICAST == 1
@@ -465,9 +507,10 @@ size_t _zn_read_udp_multicast(int sock, uint8_t *ptr, size_t len, void *arg, z_b
     unsigned int raddrlen = sizeof(struct sockaddr_storage);
 
     ssize_t rb = 0;
+    int flags = 0;
     do
     {
-        rb = recvfrom(sock, ptr, len, 0,
+        rb = recvfrom(sock, ptr, len, flags,
                       (struct sockaddr *)&raddr, &raddrlen);
 
         if (rb < 0)
@@ -505,6 +548,10 @@ size_t _zn_read_udp_multicast(int sock, uint8_t *ptr, size_t len, void *arg, z_b
                 break;
             }
         }
+
+        // Our own messages are looped back: skip them without waiting for a message of another
+        // peer, so that a reactor task servicing the socket is never blocked
+        flags = MSG_DONTWAIT;
     } while (1);
 
     return rb;
@@ -535,6 +582,13 @@ size_t _zn_send_udp_multicast(int sock, const uint8_t *ptr, size_t len, void *ar
     return sendto(sock, ptr, len, 0, raddr->ai_addr, raddr->ai_addrlen);
 }
 
+size_t _zn_send_vec_udp_multicast(int sock, const z_bytes_t *bufs, size_t n, void *arg)
+{
+    struct addrinfo *raddr = (struct addrinfo *)arg;
+
+    return _zn_sendmsg(sock, bufs, n, raddr->ai_addr, raddr->ai_addrlen, 0);
+}
+
 #endif
 
 #if ZN_LINK_BLUETOOTH == 1
@@ -0,0 +1,252 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/epoll.h>
+
+#include "zenoh-pico/system/platform.h"
+
+#if Z_REACTOR == 1
+
+#define _Z_REACTOR_DEFAULT_CAPACITY 16
+
+/**
+ * A file descriptor registered in a reactor. It is armed in one-shot mode, so that its callback
+ * is called by a single task at a time, and it is armed again once the callback has returned.
+ *
+ * Members:
+ *   int fd: The file descriptor.
+ *   uint32_t gen: The generation of the registration, to ignore the events of a previous
+ *                 registration of the same file descriptor.
+ *   z_reactor_f callback: The function called when the file descriptor is ready to be read.
+ *   void *arg: The argument passed to the callback.
+ *   int busy: Whether the callback is being called.
+ *   pthread_t owner: The task calling the callback, if busy.
+ *   int removed: Whether the callback removed its own file descriptor, the handler is then
+ *                freed once the callback has returned.
+ */
+struct z_reactor_handler_t
+{
+    int fd;
+    uint32_t gen;
+    z_reactor_f callback;
+    void *arg;
+    int busy;
+    pthread_t owner;
+    int removed;
+};
+
+static int __z_reactor_arm(z_reactor_t *r, struct z_reactor_handler_t *h, int op)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(struct epoll_event));
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.u64 = ((uint64_t)h->gen << 32) | (uint32_t)h->fd;
+
+    return epoll_ctl(r->epfd, op, h->fd, &ev);
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - r->mutex
+ */
+static struct z_reactor_handler_t *__unsafe_z_reactor_get(z_reactor_t *r, int fd)
+{
+    if (fd < 0 || (size_t)fd >= r->capacity)
+        return NULL;
+
+    return r->handlers[fd];
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - r->mutex
+ */
+static void __unsafe_z_reactor_unlink(z_reactor_t *r, struct z_reactor_handler_t *h)
+{
+    epoll_ctl(r->epfd, EPOLL_CTL_DEL, h->fd, NULL);
+    r->handlers[h->fd] = NULL;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - r->mutex
+ */
+static void __unsafe_z_reactor_drop(z_reactor_t *r, struct z_reactor_handler_t *h)
+{
+    __unsafe_z_reactor_unlink(r, h);
+    z_free(h);
+}
+
+int z_reactor_init(z_reactor_t *r)
+{
+    r->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (r->epfd < 0)
+        return -1;
+
+    r->handlers = NULL;
+    r->capacity = 0;
+    r->gen = 0;
+    pthread_mutex_init(&r->mutex, 0);
+    pthread_cond_init(&r->idle, 0);
+
+    return 0;
+}
+
+int z_reactor_free(z_reactor_t *r)
+{
+    for (size_t i = 0; i < r->capacity; i++)
+        z_free(r->handlers[i]);
+    z_free(r->handlers);
+    r->handlers = NULL;
+    r->capacity = 0;
+
+    pthread_cond_destroy(&r->idle);
+    pthread_mutex_destroy(&r->mutex);
+
+    return close(r->epfd);
+}
+
+int z_reactor_add(z_reactor_t *r, int fd, z_reactor_f callback, void *arg)
+{
+    if (fd < 0)
+        return -1;
+
+    pthread_mutex_lock(&r->mutex);
+
+    // The handlers are indexed by file descriptor
+    if ((size_t)fd >= r->capacity)
+    {
+        size_t capacity = r->capacity == 0 ? _Z_REACTOR_DEFAULT_CAPACITY : r->capacity;
+        while (capacity <= (size_t)fd)
+            capacity *= 2;
+
+        struct z_reactor_handler_t **handlers = (struct z_reactor_handler_t **)z_realloc(r->handlers, capacity * sizeof(struct z_reactor_handler_t *));
+        if (handlers == NULL)
+            goto ERR;
+
+        memset(&handlers[r->capacity], 0, (capacity - r->capacity) * sizeof(struct z_reactor_handler_t *));
+        r->handlers = handlers;
+        r->capacity = capacity;
+    }
+
+    if (r->handlers[fd] != NULL)
+        goto ERR;
+
+    struct z_reactor_handler_t *h = (struct z_reactor_handler_t *)z_malloc(sizeof(struct z_reactor_handler_t));
+    if (h == NULL)
+        goto ERR;
+
+    h->fd = fd;
+    h->gen = r->gen++;
+    h->callback = callback;
+    h->arg = arg;
+    h->busy = 0;
+    h->removed = 0;
+    if (__z_reactor_arm(r, h, EPOLL_CTL_ADD) < 0)
+    {
+        z_free(h);
+        goto ERR;
+    }
+    r->handlers[fd] = h;
+
+    pthread_mutex_unlock(&r->mutex);
+    return 0;
+
+ERR:
+    pthread_mutex_unlock(&r->mutex);
+    return -1;
+}
+
+int z_reactor_remove(z_reactor_t *r, int fd)
+{
+    pthread_mutex_lock(&r->mutex);
+
+    // The callback removes its own file descriptor, the handler is freed once it returns
+    struct z_reactor_handler_t *h = __unsafe_z_reactor_get(r, fd);
+    if (h != NULL && h->busy && pthread_equal(h->owner, pthread_self()))
+    {
+        __unsafe_z_reactor_unlink(r, h);
+        h->removed = 1;
+        goto EXIT;
+    }
+
+    // Wait for the callback being called by another task to return, it might remove the
+    // file descriptor itself
+    while (h != NULL && h->busy)
+    {
+        pthread_cond_wait(&r->idle, &r->mutex);
+        h = __unsafe_z_reactor_get(r, fd);
+    }
+    if (h == NULL)
+        goto ERR;
+
+    __unsafe_z_reactor_drop(r, h);
+
+EXIT:
+    pthread_mutex_unlock(&r->mutex);
+    return 0;
+
+ERR:
+    pthread_mutex_unlock(&r->mutex);
+    return -1;
+}
+
+int z_reactor_wait(z_reactor_t *r, unsigned int tout)
+{
+    // A single event is taken at a time, so that the ready file descriptors are spread
+    // over all the tasks waiting on the reactor
+    struct epoll_event ev;
+    int n = epoll_wait(r->epfd, &ev, 1, (int)tout);
+    if (n < 0)
+        return errno == EINTR ? 0 : -1;
+    if (n == 0)
+        return 0;
+
+    int fd = (int)(uint32_t)ev.data.u64;
+    uint32_t gen = (uint32_t)(ev.data.u64 >> 32);
+
+    pthread_mutex_lock(&r->mutex);
+
+    // The file descriptor might have been removed, or even registered again, in the meantime
+    struct z_reactor_handler_t *h = __unsafe_z_reactor_get(r, fd);
+    if (h == NULL || h->gen != gen)
+    {
+        pthread_mutex_unlock(&r->mutex);
+        return 0;
+    }
+    h->busy = 1;
+    h->owner = pthread_self();
+
+    pthread_mutex_unlock(&r->mutex);
+    int ret = h->callback(h->arg);
+    pthread_mutex_lock(&r->mutex);
+
+    h->busy = 0;
+    if (h->removed)
+        z_free(h);
+    else if (ret < 0 || __z_reactor_arm(r, h, EPOLL_CTL_MOD) < 0)
+        __unsafe_z_reactor_drop(r, h);
+    pthread_cond_broadcast(&r->idle);
+
+    pthread_mutex_unlock(&r->mutex);
+    return 1;
+}
+
+#endif
@@ -78,17 +78,17 @@ void z_random_fill(void *buf, size_t len)
 }
 
 /*------------------ Memory ------------------*/
-void *z_malloc(size_t size)
+void *z_sys_malloc(size_t size)
 {
     return malloc(size);
 }
 
-void *z_realloc(void *ptr, size_t size)
+void *z_sys_realloc(void *ptr, size_t size)
 {
     return realloc(ptr, size);
 }
 
-void z_free(void *ptr)
+void z_sys_free(void *ptr)
 {
     free(ptr);
 }
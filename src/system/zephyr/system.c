@@ -55,18 +55,18 @@ void z_random_fill(void *buf, size_t len)
 }
 
 /*------------------ Memory ------------------*/
-void *z_malloc(size_t size)
+void *z_sys_malloc(size_t size)
 {
     return k_malloc(size);
 }
 
-void *z_realloc(void *ptr, size_t size)
+void *z_sys_realloc(void *ptr, size_t size)
 {
     // k_realloc not implemented in Zephyr
     return NULL;
 }
 
-void z_free(void *ptr)
+void z_sys_free(void *ptr)
 {
     k_free(ptr);
 }
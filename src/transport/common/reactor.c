@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/transport/link/task/reactor.h"
+#include "zenoh-pico/transport/link/task/read.h"
+#include "zenoh-pico/utils/logging.h"
+
+#if Z_REACTOR == 1
+void *_znp_reactor_task(void *arg)
+{
+    _zn_reactor_t *reactor = (_zn_reactor_t *)arg;
+
+    // The ready links are handled by whichever task is waiting
+    while (reactor->running)
+        z_reactor_wait(&reactor->reactor, ZN_REACTOR_TIMEOUT);
+
+    return 0;
+}
+
+_zn_reactor_t *_zn_reactor_init(size_t tasks)
+{
+    if (tasks == 0)
+        return NULL;
+
+    _zn_reactor_t *reactor = (_zn_reactor_t *)z_malloc(sizeof(_zn_reactor_t));
+    if (reactor == NULL)
+        return NULL;
+
+    if (z_reactor_init(&reactor->reactor) != 0)
+    {
+        z_free(reactor);
+        return NULL;
+    }
+
+    reactor->running = 1;
+    reactor->len = 0;
+    reactor->tasks = (z_task_t *)z_malloc(tasks * sizeof(z_task_t));
+    if (reactor->tasks == NULL)
+        goto ERR;
+
+    for (size_t i = 0; i < tasks; i++)
+    {
+        if (z_task_init(&reactor->tasks[i], NULL, _znp_reactor_task, reactor) != 0)
+        {
+            _Z_DEBUG("Unable to start the reactor task %zu\n", i);
+            goto ERR;
+        }
+        reactor->len++;
+    }
+
+    return reactor;
+
+ERR:
+    _zn_reactor_free(&reactor);
+    return NULL;
+}
+
+void _zn_reactor_free(_zn_reactor_t **reactor)
+{
+    _zn_reactor_t *ptr = *reactor;
+
+    // The tasks notice it within ZN_REACTOR_TIMEOUT
+    ptr->running = 0;
+    for (size_t i = 0; i < ptr->len; i++)
+        z_task_join(&ptr->tasks[i]);
+    z_free(ptr->tasks);
+
+    z_reactor_free(&ptr->reactor);
+
+    z_free(ptr);
+    *reactor = NULL;
+}
+
+int _zn_reactor_add(_zn_reactor_t *reactor, _zn_transport_t *zt)
+{
+    if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return _zn_reactor_unicast_add(reactor, &zt->transport.unicast);
+    else if (zt->type == _ZN_TRANSPORT_MULTICAST_TYPE)
+        return _zn_reactor_multicast_add(reactor, &zt->transport.multicast);
+    else
+        return -1;
+}
+
+int _zn_reactor_unicast_add(_zn_reactor_t *reactor, _zn_transport_unicast_t *ztu)
+{
+    // The link is serviced either by the read task or by a reactor
+    if (ztu->read_task != NULL || ztu->reactor != NULL || ztu->link->fd_f == NULL)
+        return -1;
+
+    // Prepare the buffer
+    z_mutex_lock(&ztu->mutex_rx);
+    _z_zbuf_reset(&ztu->zbuf);
+    z_mutex_unlock(&ztu->mutex_rx);
+
+    if (z_reactor_add(&reactor->reactor, ztu->link->fd_f(ztu->link), _znp_unicast_read_ready, ztu) != 0)
+        return -1;
+
+    ztu->reactor = reactor;
+    return 0;
+}
+
+int _zn_reactor_multicast_add(_zn_reactor_t *reactor, _zn_transport_multicast_t *ztm)
+{
+    // The link is serviced either by the read task or by a reactor
+    if (ztm->read_task != NULL || ztm->reactor != NULL || ztm->link->fd_f == NULL)
+        return -1;
+
+    // Prepare the buffer
+    z_mutex_lock(&ztm->mutex_rx);
+    _z_zbuf_reset(&ztm->zbuf);
+    z_mutex_unlock(&ztm->mutex_rx);
+
+    if (z_reactor_add(&reactor->reactor, ztm->link->fd_f(ztm->link), _znp_multicast_read_ready, ztm) != 0)
+        return -1;
+
+    ztm->reactor = reactor;
+    return 0;
+}
+
+int _zn_reactor_remove(_zn_reactor_t *reactor, _zn_transport_t *zt)
+{
+    if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return _zn_reactor_unicast_remove(reactor, &zt->transport.unicast);
+    else if (zt->type == _ZN_TRANSPORT_MULTICAST_TYPE)
+        return _zn_reactor_multicast_remove(reactor, &zt->transport.multicast);
+    else
+        return -1;
+}
+
+int _zn_reactor_unicast_remove(_zn_reactor_t *reactor, _zn_transport_unicast_t *ztu)
+{
+    if (ztu->reactor != reactor)
+        return -1;
+
+    // It waits for the messages being handled, the link might have already been removed
+    // by the reactor when closed by the other end
+    z_reactor_remove(&reactor->reactor, ztu->link->fd_f(ztu->link));
+    ztu->reactor = NULL;
+
+    return 0;
+}
+
+int _zn_reactor_multicast_remove(_zn_reactor_t *reactor, _zn_transport_multicast_t *ztm)
+{
+    if (ztm->reactor != reactor)
+        return -1;
+
+    // It waits for the messages being handled, the link might have already been removed
+    // by the reactor when closed by the other end
+    z_reactor_remove(&reactor->reactor, ztm->link->fd_f(ztm->link));
+    ztm->reactor = NULL;
+
+    return 0;
+}
+#endif
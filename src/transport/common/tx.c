@@ -40,21 +40,34 @@ void __unsafe_zn_prepare_wbuf(_z_wbuf_t *buf, int is_streamed)
  *  - ztu->mutex_tx
  */
 void __unsafe_zn_finalize_wbuf(_z_wbuf_t *buf, int is_streamed)
+{
+    __unsafe_zn_finalize_frame(buf, is_streamed, 0);
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->mutex_tx
+ */
+void __unsafe_zn_finalize_frame(_z_wbuf_t *buf, int is_streamed, size_t ext_len)
 {
     if (is_streamed == 1)
     {
-        size_t len = _z_wbuf_len(buf) - _ZN_MSG_LEN_ENC_SIZE;
+        // The message length also accounts for the bytes sent right after the buffer
+        size_t len = _z_wbuf_len(buf) - _ZN_MSG_LEN_ENC_SIZE + ext_len;
         for (size_t i = 0; i < _ZN_MSG_LEN_ENC_SIZE; i++)
             _z_wbuf_put(buf, (uint8_t)((len >> 8 * i) & 0xFF), i);
     }
 }
 
-_zn_transport_message_t __zn_frame_header(zn_reliability_t reliability, int is_fragment, int is_final, z_zint_t sn)
+_zn_transport_message_t __zn_frame_header(zn_reliability_t reliability, zn_priority_t priority, int is_fragment, int is_final, z_zint_t sn)
 {
     // Create the frame session message that carries the zenoh message
     int is_reliable = reliability == zn_reliability_t_RELIABLE;
 
     _zn_transport_message_t t_msg = _zn_t_msg_make_frame_header(sn, is_reliable, is_fragment, is_final);
+    // The priority decorator is encoded in front of the frame unless it is the default one
+    t_msg.body.frame.priority = priority;
 
     return t_msg;
 }
@@ -64,42 +77,140 @@ _zn_transport_message_t __zn_frame_header(zn_reliability_t reliability, int is_f
  * Make sure that the following mutexes are locked before calling this function:
  *  - ztu->mutex_tx
  */
-int __unsafe_zn_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, zn_reliability_t reliability, size_t sn)
+int __unsafe_zn_serialize_frame(_z_wbuf_t *dst, const _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_priority_t priority, int *is_fragment, size_t bytes_left, z_zint_t sn)
 {
-    // Assume first that this is not the final fragment
+    // Mark the buffer for the writing operation
+    size_t w_pos = _z_wbuf_get_wpos(dst);
     int is_final = 0;
     do
     {
-        // Mark the buffer for the writing operation
-        size_t w_pos = _z_wbuf_get_wpos(dst);
-        // Get the frame header
-        _zn_transport_message_t f_hdr = __zn_frame_header(reliability, 1, is_final, sn);
         // Encode the frame header
+        _zn_transport_message_t f_hdr = __zn_frame_header(reliability, priority, *is_fragment, is_final, sn);
         int res = _zn_transport_message_encode(dst, &f_hdr);
-        if (res == 0)
+        if (res != 0)
+            return res;
+
+        // Encode the zenoh message up to its payload bytes, if any
+        if (z_msg != NULL)
         {
-            size_t space_left = _z_wbuf_space_left(dst);
-            size_t bytes_left = _z_wbuf_len(src);
-            // Check if it is really the final fragment
-            if (!is_final && (bytes_left <= space_left))
-            {
-                // Revert the buffer
-                _z_wbuf_set_wpos(dst, w_pos);
-                // It is really the finally fragment, reserialize the header
-                is_final = 1;
-                continue;
-            }
-            // Write the fragment
-            size_t to_copy = bytes_left <= space_left ? bytes_left : space_left;
-            return _z_wbuf_siphon(dst, src, to_copy);
+            res = _zn_zenoh_message_encode_head(dst, z_msg);
+            if (res != 0)
+                return res;
         }
+
+        size_t space_left = _z_wbuf_space_left(dst);
+        if (!*is_fragment && bytes_left > space_left)
+            // The zenoh message does not fit in a single frame, let's fragment it
+            *is_fragment = 1;
+        else if (*is_fragment && !is_final && bytes_left <= space_left)
+            // It is really the final fragment
+            is_final = 1;
         else
-        {
             return 0;
-        }
+
+        // Revert the buffer and reserialize the frame
+        _z_wbuf_set_wpos(dst, w_pos);
     } while (1);
 }
 
+int __zn_link_send_frame(const _zn_link_t *link, const _z_wbuf_t *wbf, const uint8_t *bs, size_t len)
+{
+    // The serialized frame goes first, followed by the referenced bytes
+    _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, wbf->r_idx);
+    z_bytes_t bufs[2];
+    bufs[0] = _z_bytes_wrap(ios->buf + ios->r_pos, _z_iosli_readable(ios));
+    bufs[1] = _z_bytes_wrap(bs, len);
+
+    return _zn_link_send_vec(link, bufs, len > 0 ? 2 : 1);
+}
+
+z_bytes_t _zn_zenoh_message_payload(const _zn_zenoh_message_t *z_msg)
+{
+    if (_ZN_MID(z_msg->header) == _ZN_MID_DATA)
+        return _z_bytes_wrap(z_msg->body.data.payload.val, z_msg->body.data.payload.len);
+
+    return _z_bytes_wrap(NULL, 0);
+}
+
+int _zn_zenoh_message_flatten(z_bytes_t *bs, const _zn_zenoh_message_t *z_msg)
+{
+    // Encode the message on an expandable wbuf, then copy it in a single buffer
+    _z_wbuf_t wbf = _z_wbuf_make(ZN_IOSLICE_SIZE, 1);
+    int res = _zn_zenoh_message_encode(&wbf, z_msg);
+    if (res == 0)
+    {
+        size_t len = _z_wbuf_len(&wbf);
+        *bs = _z_bytes_make(len);
+        size_t pos = 0;
+        for (size_t i = wbf.r_idx; i <= wbf.w_idx; i++)
+        {
+            _z_iosli_t *ios = _z_wbuf_get_iosli(&wbf, i);
+            size_t readable = _z_iosli_readable(ios);
+            memcpy((uint8_t *)bs->val + pos, ios->buf + ios->r_pos, readable);
+            pos += readable;
+        }
+    }
+    _z_wbuf_clear(&wbf);
+
+    return res;
+}
+
+/*------------------ TX queue helpers ------------------*/
+int _zn_enqueue_z_msg(zn_session_t *zn, z_ring_queue_t *q, const _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority)
+{
+    // Encode the message, payloads are wrapped and not copied by the expandable wbuf
+    _z_wbuf_t wbf = _z_wbuf_make(ZN_IOSLICE_SIZE, 1);
+    int res = _zn_zenoh_message_encode(&wbf, z_msg);
+    if (res != 0)
+    {
+        _Z_INFO("Dropping zenoh message because it can not be encoded\n");
+        goto EXIT_ENQ_PROC;
+    }
+
+    // Copy the encoded message right after the job, the publisher regains ownership of the payload
+    size_t len = _z_wbuf_len(&wbf);
+    _zn_tx_job_t *job = (_zn_tx_job_t *)z_malloc(sizeof(_zn_tx_job_t) + len);
+    if (job == NULL)
+    {
+        _Z_INFO("Dropping zenoh message because it can not be copied\n");
+        res = -1;
+        goto EXIT_ENQ_PROC;
+    }
+    uint8_t *val = (uint8_t *)(job + 1);
+    size_t pos = 0;
+    for (size_t i = 0; i < _z_wbuf_len_iosli(&wbf); i++)
+    {
+        _z_iosli_t *ios = _z_wbuf_get_iosli(&wbf, i);
+        size_t readable = _z_iosli_readable(ios);
+        memcpy(val + pos, ios->buf + ios->r_pos, readable);
+        pos += readable;
+    }
+    job->msg = _z_bytes_wrap(val, len);
+    job->reliability = reliability;
+    job->priority = priority;
+    job->pos = 0;
+    job->next = NULL;
+
+    if (cong_ctrl == zn_congestion_control_t_BLOCK)
+    {
+        // Wait for the write task to free some space
+        z_ring_queue_put(q, job);
+    }
+    else if (z_ring_queue_try_put(q, job) != 0)
+    {
+        _Z_INFO("Dropping zenoh message because of congestion control\n");
+        _ZN_STATS_INC(zn, dropped_congestion);
+        z_free(job);
+        goto EXIT_ENQ_PROC;
+    }
+    _ZN_STATS_Z_MSG(zn, tx, z_msg->header, reliability);
+
+EXIT_ENQ_PROC:
+    _z_wbuf_clear(&wbf);
+
+    return res;
+}
+
 int _zn_send_t_msg(_zn_transport_t *zt, const _zn_transport_message_t *t_msg)
 {
     if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
@@ -110,6 +221,36 @@ int _zn_send_t_msg(_zn_transport_t *zt, const _zn_transport_message_t *t_msg)
         return -1;
 }
 
+int _zn_flush(_zn_transport_t *zt)
+{
+    if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return _zn_unicast_flush(&zt->transport.unicast);
+    else if (zt->type == _ZN_TRANSPORT_MULTICAST_TYPE)
+        return _zn_multicast_flush(&zt->transport.multicast);
+    else
+        return -1;
+}
+
+int _zn_batch_start(_zn_transport_t *zt)
+{
+    if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return _zn_unicast_batch_start(&zt->transport.unicast);
+    else if (zt->type == _ZN_TRANSPORT_MULTICAST_TYPE)
+        return _zn_multicast_batch_start(&zt->transport.multicast);
+    else
+        return -1;
+}
+
+int _zn_batch_flush(_zn_transport_t *zt)
+{
+    if (zt->type == _ZN_TRANSPORT_UNICAST_TYPE)
+        return _zn_unicast_batch_flush(&zt->transport.unicast);
+    else if (zt->type == _ZN_TRANSPORT_MULTICAST_TYPE)
+        return _zn_multicast_batch_flush(&zt->transport.multicast);
+    else
+        return -1;
+}
+
 int _zn_link_send_t_msg(const _zn_link_t *zl, const _zn_transport_message_t *t_msg)
 {
     // Create and prepare the buffer to serialize the message on
@@ -15,14 +15,13 @@
 #include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/link/tx.h"
 #include "zenoh-pico/transport/link/task/join.h"
+#include "zenoh-pico/transport/utils.h"
 
 int _znp_multicast_send_join(_zn_transport_multicast_t *ztm)
 {
-    // FIXME: make transport aware of qos configuration
+    // Announce the next SN of each conduit, one pair per priority if QoS is supported
     _zn_conduit_sn_list_t next_sns;
-    next_sns.is_qos = 0;
-    next_sns.val.plain.best_effort = ztm->sn_tx_best_effort;
-    next_sns.val.plain.reliable = ztm->sn_tx_reliable;
+    _zn_conduit_sn_list_copy(&next_sns, &ztm->sn_tx_sns);
 
     z_bytes_t pid = _z_bytes_wrap(((zn_session_t *)ztm->session)->tp_manager->local_pid.val, ((zn_session_t *)ztm->session)->tp_manager->local_pid.len);
     _zn_transport_message_t jsm = _zn_t_msg_make_join(ZN_PROTO_VERSION, ZN_PEER, ZN_TRANSPORT_LEASE, ZN_SN_RESOLUTION, pid, next_sns);
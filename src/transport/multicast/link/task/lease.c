@@ -12,7 +12,9 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include <stddef.h>
 #include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/rx.h"
 #include "zenoh-pico/transport/link/tx.h"
 #include "zenoh-pico/transport/link/task/join.h"
 #include "zenoh-pico/transport/link/task/lease.h"
@@ -35,29 +37,84 @@ z_zint_t _zn_get_minimum_lease(_zn_transport_peer_entry_list_t *peers, z_zint_t
     return ret;
 }
 
-z_zint_t _zn_get_next_lease(_zn_transport_peer_entry_list_t *peers)
+int _znp_multicast_send_keep_alive(_zn_transport_multicast_t *ztm)
 {
-    z_zint_t ret = SIZE_MAX;
+    z_bytes_t pid = _z_bytes_wrap(((zn_session_t *)ztm->session)->tp_manager->local_pid.val, ((zn_session_t *)ztm->session)->tp_manager->local_pid.len);
+    _zn_transport_message_t t_msg = _zn_t_msg_make_keep_alive(pid);
 
-    _zn_transport_peer_entry_list_t *it = peers;
-    while (it != NULL)
-    {
-        z_zint_t next_lease = ((_zn_transport_peer_entry_t *)it->val)->next_lease;
-        if (next_lease < ret)
-            ret = next_lease;
+    return _zn_multicast_send_t_msg(ztm, &t_msg);
+}
 
-        it = it->tail;
+void _znp_multicast_peer_lease_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+
+    z_mutex_lock(&ztm->mutex_peer);
+
+    // The peer might have left in the meantime
+    if (_zn_timers_claim(&ztm->timers, tmr) == 0)
+        goto EXIT;
+
+    _zn_transport_peer_entry_t *entry = (_zn_transport_peer_entry_t *)((uint8_t *)tmr - offsetof(_zn_transport_peer_entry_t, lease_timer));
+    if (entry->received == 1)
+    {
+        // Reset the lease parameters
+        entry->received = 0;
+        _zn_timers_schedule(&ztm->timers, tmr, entry->lease);
+    }
+    else
+    {
+        _Z_INFO("Remove peer from know list because it has expired after %zums\n", entry->lease);
+        __unsafe_zn_multicast_drop_peer(ztm, entry);
     }
 
-    return ret;
+EXIT:
+    z_mutex_unlock(&ztm->mutex_peer);
 }
 
-int _znp_multicast_send_keep_alive(_zn_transport_multicast_t *ztm)
+static void __znp_multicast_join_expired(_zn_timer_t *tmr, void *arg)
 {
-    z_bytes_t pid = _z_bytes_wrap(((zn_session_t *)ztm->session)->tp_manager->local_pid.val, ((zn_session_t *)ztm->session)->tp_manager->local_pid.len);
-    _zn_transport_message_t t_msg = _zn_t_msg_make_keep_alive(pid);
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
 
-    return _zn_multicast_send_t_msg(ztm, &t_msg);
+    _znp_multicast_send_join(ztm);
+    ztm->transmitted = 1;
+
+    // Reset the join parameters
+    _zn_timers_schedule(&ztm->timers, tmr, ZN_JOIN_INTERVAL);
+}
+
+static void __znp_multicast_keep_alive_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+
+    // Check if need to send a keep alive
+    if (ztm->transmitted == 0)
+        _znp_multicast_send_keep_alive(ztm);
+
+    // Reset the keep alive parameters, according to the shortest lease of the group
+    ztm->transmitted = 0;
+    z_mutex_lock(&ztm->mutex_peer);
+    z_zint_t lease = _zn_get_minimum_lease(ztm->peers, ztm->lease);
+    z_mutex_unlock(&ztm->mutex_peer);
+    _zn_timers_schedule(&ztm->timers, tmr, lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR);
+}
+
+static void __znp_multicast_linger_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+
+    // Flush the TX batch if it has been lingering for too long
+    _zn_multicast_flush_expired(ztm);
+    _zn_timers_schedule(&ztm->timers, tmr, ztm->batch_linger);
+}
+
+static void __znp_multicast_sync_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+
+    // Announce the reliable frames waiting to be acknowledged
+    _zn_multicast_sync_expired(ztm);
+    _zn_timers_schedule(&ztm->timers, tmr, ZN_RELIABILITY_SYNC_PERIOD);
 }
 
 void *_znp_multicast_lease_task(void *arg)
@@ -67,93 +124,32 @@ void *_znp_multicast_lease_task(void *arg)
     ztm->lease_task_running = 1;
     ztm->transmitted = 0;
 
-    // From all peers, get the next lease time (minimum)
-    z_zint_t next_lease = _zn_get_minimum_lease(ztm->peers, ztm->lease);
-    z_zint_t next_keep_alive = next_lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR;
-    z_zint_t next_join = ZN_JOIN_INTERVAL;
-
-    _zn_transport_peer_entry_list_t *it = NULL;
-    while (ztm->lease_task_running)
-    {
-        z_mutex_lock(&ztm->mutex_peer);
-        if (next_lease <= 0)
-        {
-            it = ztm->peers;
-            while (it != NULL)
-            {
-                _zn_transport_peer_entry_t *entry = it->val;
-                if (entry->received == 1)
-                {
-                    // Reset the lease parameters
-                    entry->received = 0;
-                    entry->next_lease = entry->lease;
-                    it = it->tail;
-                }
-                else
-                {
-                    _Z_INFO("Remove peer from know list because it has expired after %zums\n", entry->lease);
-                    ztm->peers = _zn_transport_peer_entry_list_drop_filter(ztm->peers, _zn_transport_peer_entry_eq, entry);
-                    it = ztm->peers;
-                }
-            }
-        }
-
-        if (next_join <= 0)
-        {
-            _znp_multicast_send_join(ztm);
-            ztm->transmitted = 1;
-
-            // Reset the join parameters
-            next_join = ZN_JOIN_INTERVAL;
-        }
-
-        if (next_keep_alive <= 0)
-        {
-            // Check if need to send a keep alive
-            if (ztm->transmitted == 0)
-                _znp_multicast_send_keep_alive(ztm);
-
-            // Reset the keep alive parameters
-            ztm->transmitted = 0;
-            next_keep_alive = _zn_get_minimum_lease(ztm->peers, ztm->lease) / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR;
-        }
-
-        // Compute the target interval to sleep
-        z_zint_t interval;
-        if (next_lease > 0)
-        {
-            interval = next_lease;
-            if (next_keep_alive < interval)
-                interval = next_keep_alive;
-            if (next_join < interval)
-                interval = next_join;
-        }
-        else
-        {
-            interval = next_keep_alive;
-            if (next_join < interval)
-                interval = next_join;
-        }
-
-        z_mutex_unlock(&ztm->mutex_peer);
-
-        // The keep alive and lease intervals are expressed in milliseconds
-        z_sleep_ms(interval);
-
-        // Decrement all intervals
-        z_mutex_lock(&ztm->mutex_peer);
-        it = ztm->peers;
-        while (it != NULL)
-        {
-            _zn_transport_peer_entry_t *entry = it->val;
-            entry->next_lease -= interval;
-            it = it->tail;
-        }
-        next_lease = _zn_get_next_lease(ztm->peers);
-        next_keep_alive -= interval;
-        next_join -= interval;
-        z_mutex_unlock(&ztm->mutex_peer);
-    }
+    // The keep alive and join intervals are expressed in milliseconds, the peer leases are
+    // scheduled upon their JOIN messages
+    z_mutex_lock(&ztm->mutex_peer);
+    z_zint_t lease = _zn_get_minimum_lease(ztm->peers, ztm->lease);
+    z_mutex_unlock(&ztm->mutex_peer);
+    _zn_timer_init(&ztm->keep_alive_timer, __znp_multicast_keep_alive_expired, ztm);
+    _zn_timers_schedule(&ztm->timers, &ztm->keep_alive_timer, lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR);
+    _zn_timer_init(&ztm->join_timer, __znp_multicast_join_expired, ztm);
+    _zn_timers_schedule(&ztm->timers, &ztm->join_timer, ZN_JOIN_INTERVAL);
+
+    _zn_timer_init(&ztm->linger_timer, __znp_multicast_linger_expired, ztm);
+    if (ztm->batch_linger > 0)
+        _zn_timers_schedule(&ztm->timers, &ztm->linger_timer, ztm->batch_linger);
+
+    // Only the links that do not guarantee the delivery synchronize the reliable channel
+    _zn_timer_init(&ztm->sync_timer, __znp_multicast_sync_expired, ztm);
+    if (ztm->link->is_reliable == 0)
+        _zn_timers_schedule(&ztm->timers, &ztm->sync_timer, ZN_RELIABILITY_SYNC_PERIOD);
+
+    // Drive the deadlines of the transport, and the ones of the session like the query timeouts
+    _zn_timers_run(&ztm->timers, &ztm->lease_task_running);
+
+    _zn_timers_cancel(&ztm->timers, &ztm->keep_alive_timer);
+    _zn_timers_cancel(&ztm->timers, &ztm->join_timer);
+    _zn_timers_cancel(&ztm->timers, &ztm->linger_timer);
+    _zn_timers_cancel(&ztm->timers, &ztm->sync_timer);
 
     return 0;
-}
\ No newline at end of file
+}
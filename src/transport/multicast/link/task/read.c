@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include "zenoh-pico/api/session.h"
 #include "zenoh-pico/transport/link/task/read.h"
 #include "zenoh-pico/transport/link/rx.h"
 #include "zenoh-pico/utils/logging.h"
@@ -32,14 +33,108 @@ ERR:
     return _z_res_t_ERR;
 }
 
+/**
+ * Handle the transport messages of a batch of to_read bytes received from addr, located at
+ * the read position of the main buffer, and move the read position past them.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_rx
+ */
+static int __unsafe_znp_multicast_handle_batch(_zn_transport_multicast_t *ztm, size_t to_read, z_bytes_t *addr)
+{
+    _zn_transport_message_result_t r;
+
+    // Wrap the main buffer for to_read bytes
+    _z_zbuf_t zbuf = _z_zbuf_view(&ztm->zbuf, to_read);
+    _ZN_STATS_ADD(ztm->session, rx.bytes, ztm->link->is_streamed == 1 ? to_read + _ZN_MSG_LEN_ENC_SIZE : to_read);
+
+    while (_z_zbuf_len(&zbuf) > 0)
+    {
+        // Decode one session message
+        _zn_transport_message_decode_lazy_na(&zbuf, &r);
+
+        if (r.tag == _z_res_t_OK)
+        {
+            int res = _zn_multicast_handle_transport_message(ztm, &r.value.transport_message, addr);
+            if (res == _z_res_t_OK)
+                _zn_t_msg_clear(&r.value.transport_message);
+            else
+                return _z_res_t_ERR;
+        }
+        else
+        {
+            _Z_ERROR("Connection closed due to malformed message\n");
+            _ZN_STATS_INC(ztm->session, malformed);
+            return _z_res_t_ERR;
+        }
+    }
+
+    // Move the read position of the read buffer
+    _z_zbuf_set_rpos(&ztm->zbuf, _z_zbuf_get_rpos(&ztm->zbuf) + to_read);
+
+    return _z_res_t_OK;
+}
+
+int _znp_multicast_read_ready(void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+    int res = _z_res_t_OK;
+
+    z_mutex_lock(&ztm->mutex_rx);
+
+    // The link is ready: this does not block
+    z_bytes_t addr = _z_bytes_wrap(NULL, 0);
+    size_t rb = _zn_link_recv_zbuf(ztm->link, &ztm->zbuf, &addr);
+    if (rb == SIZE_MAX)
+        goto EXIT;
+
+    if (ztm->link->is_streamed == 1)
+    {
+        // Reading nothing from a ready stream means that it has been closed by the other end
+        if (rb == 0)
+        {
+            res = _z_res_t_ERR;
+            goto EXIT;
+        }
+
+        // Handle the complete messages, a partial one is kept until the rest of it is received
+        while (_z_zbuf_len(&ztm->zbuf) >= _ZN_MSG_LEN_ENC_SIZE)
+        {
+            size_t to_read = 0;
+            for (int i = 0; i < _ZN_MSG_LEN_ENC_SIZE; i++)
+                to_read |= _z_zbuf_read(&ztm->zbuf) << (i * 8);
+
+            if (_z_zbuf_len(&ztm->zbuf) < to_read)
+            {
+                _z_zbuf_set_rpos(&ztm->zbuf, _z_zbuf_get_rpos(&ztm->zbuf) - _ZN_MSG_LEN_ENC_SIZE);
+                break;
+            }
+
+            res = __unsafe_znp_multicast_handle_batch(ztm, to_read, &addr);
+            if (res != _z_res_t_OK)
+                goto EXIT;
+        }
+    }
+    else
+    {
+        res = __unsafe_znp_multicast_handle_batch(ztm, rb, &addr);
+    }
+
+EXIT:
+    _z_bytes_clear(&addr);
+    _z_zbuf_compact(&ztm->zbuf);
+    z_mutex_unlock(&ztm->mutex_rx);
+
+    return res;
+}
+
 void *_znp_multicast_read_task(void *arg)
 {
     _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
 
     ztm->read_task_running = 1;
 
-    _zn_transport_message_result_t r;
-
     // Acquire and keep the lock
     z_mutex_lock(&ztm->mutex_rx);
 
@@ -83,35 +178,12 @@ void *_znp_multicast_read_task(void *arg)
                 continue;
         }
 
-        // Wrap the main buffer for to_read bytes
-        _z_zbuf_t zbuf = _z_zbuf_view(&ztm->zbuf, to_read);
-
-        while (_z_zbuf_len(&zbuf) > 0)
-        {
-            // Decode one session message
-            _zn_transport_message_decode_na(&zbuf, &r);
-
-            if (r.tag == _z_res_t_OK)
-            {
-                int res = _zn_multicast_handle_transport_message(ztm, &r.value.transport_message, &addr);
-
-                if (res == _z_res_t_OK)
-                {
-                    _zn_t_msg_clear(&r.value.transport_message);
-                    _z_bytes_clear(&addr);
-                }
-                else
-                    goto EXIT_RECV_LOOP;
-            }
-            else
-            {
-                _Z_ERROR("Connection closed due to malformed message\n");
-                goto EXIT_RECV_LOOP;
-            }
-        }
+        // All the messages of the batch have been received from addr
+        int res = __unsafe_znp_multicast_handle_batch(ztm, to_read, &addr);
+        _z_bytes_clear(&addr);
+        if (res != _z_res_t_OK)
+            goto EXIT_RECV_LOOP;
 
-        // Move the read position of the read buffer
-        _z_zbuf_set_rpos(&ztm->zbuf, _z_zbuf_get_rpos(&ztm->zbuf) + to_read);
         _z_zbuf_compact(&ztm->zbuf);
     }
 
@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include "zenoh-pico/transport/link/task/write.h"
+#include "zenoh-pico/transport/link/tx.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zenoh-pico/utils/logging.h"
+
+void *_znp_multicast_write_task(void *arg)
+{
+    _zn_transport_multicast_t *ztm = (_zn_transport_multicast_t *)arg;
+
+    // The messages pulled from the queue, sorted by priority
+    _zn_tx_lanes_t lanes;
+    _zn_tx_lanes_init(&lanes);
+
+    int stop = 0;
+    while (!stop || lanes.len > 0)
+    {
+        // Wait for the publishers to enqueue a message, unless some are still pending
+        _zn_tx_job_t *job = NULL;
+        if (!stop)
+            job = (_zn_tx_job_t *)(lanes.len == 0 ? z_ring_queue_get(ztm->tx_queue) : z_ring_queue_try_get(ztm->tx_queue));
+
+        // Sort the queued messages by priority. At most ZN_TX_QUEUE_SIZE messages are pending,
+        // so that the publishers keep being subject to the congestion control.
+        while (job != NULL)
+        {
+            // An empty message stops the task after the previous ones have been sent
+            if (job->msg.len == 0)
+            {
+                stop = 1;
+                z_free(job);
+                break;
+            }
+
+            _zn_tx_lanes_push(&lanes, job);
+            if (lanes.len >= ZN_TX_QUEUE_SIZE)
+                break;
+            job = (_zn_tx_job_t *)z_ring_queue_try_get(ztm->tx_queue);
+        }
+
+        z_mutex_lock(&ztm->mutex_tx);
+
+        // Pack the pending messages in as few frames as possible, the highest priority first
+        while ((job = _zn_tx_lanes_peek(&lanes)) != NULL)
+        {
+            int res = __unsafe_zn_multicast_write_encoded(ztm, &job->msg, job->reliability, job->priority, &job->pos);
+            if (res == 0 && job->pos < job->msg.len)
+            {
+                // A fragment has been sent. With QoS, the messages with a higher priority enqueued in the
+                // meantime are sent before the next one. Without QoS, the fragments are sent in a row since
+                // all the priorities share the same conduit.
+                if (ztm->sn_tx_sns.is_qos == 1)
+                    break;
+                continue;
+            }
+
+            _zn_tx_lanes_pop(&lanes);
+            z_free(job);
+        }
+
+        // The lanes are empty, send the batch unless the linger time or a batch scope keeps it open
+        if (stop && lanes.len == 0)
+            __unsafe_zn_multicast_flush(ztm);
+        else
+            __unsafe_zn_multicast_flush_expired(ztm);
+
+        z_mutex_unlock(&ztm->mutex_tx);
+    }
+
+    return 0;
+}
+
+int _znp_multicast_start_write_task(_zn_transport_multicast_t *ztm)
+{
+    if (ztm->write_task != NULL)
+        return -1;
+
+    ztm->tx_queue = z_ring_queue_make(ZN_TX_QUEUE_SIZE);
+    ztm->write_task = (z_task_t *)z_malloc(sizeof(z_task_t));
+    memset(ztm->write_task, 0, sizeof(z_task_t));
+    if (z_task_init(ztm->write_task, NULL, _znp_multicast_write_task, ztm) != 0)
+        goto ERR;
+
+    // Publishers enqueue their messages from now on
+    z_mutex_lock(&ztm->mutex_write_task);
+    ztm->write_task_running = 1;
+    z_mutex_unlock(&ztm->mutex_write_task);
+
+    return 0;
+
+ERR:
+    z_task_free(&ztm->write_task);
+    z_ring_queue_free(&ztm->tx_queue);
+    return -1;
+}
+
+int _znp_multicast_stop_write_task(_zn_transport_multicast_t *ztm)
+{
+    if (ztm->write_task == NULL)
+        return -1;
+
+    // Publishers send directly from now on, wait for the ones enqueuing a message
+    z_mutex_lock(&ztm->mutex_write_task);
+    ztm->write_task_running = 0;
+    while (ztm->write_task_users > 0)
+        z_condvar_wait(&ztm->write_task_idle, &ztm->mutex_write_task);
+    z_mutex_unlock(&ztm->mutex_write_task);
+
+    // The task sends what is already queued, no publisher enqueues after the empty message
+    _zn_tx_job_t *job = (_zn_tx_job_t *)z_malloc(sizeof(_zn_tx_job_t));
+    _z_bytes_reset(&job->msg);
+    z_ring_queue_put(ztm->tx_queue, job);
+
+    z_task_join(ztm->write_task);
+    z_task_free(&ztm->write_task);
+
+    z_ring_queue_free(&ztm->tx_queue);
+
+    return 0;
+}
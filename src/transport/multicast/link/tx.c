@@ -14,6 +14,7 @@
 
 #include "zenoh-pico/protocol/msgcodec.h"
 #include "zenoh-pico/transport/link/tx.h"
+#include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/utils/logging.h"
 
 /*------------------ SN helper ------------------*/
@@ -22,23 +23,132 @@
  * Make sure that the following mutexes are locked before calling this function:
  *  - ztm->mutex_inner
  */
-z_zint_t __unsafe_zn_multicast_get_sn(_zn_transport_multicast_t *ztm, zn_reliability_t reliability)
+z_zint_t __unsafe_zn_multicast_get_sn(_zn_transport_multicast_t *ztm, zn_reliability_t reliability, zn_priority_t priority)
 {
+    // Each priority has its own conduit if the transport supports QoS
+    _zn_coundit_sn_t *sns = _zn_conduit_sn_list_get(&ztm->sn_tx_sns, priority);
+
     z_zint_t sn;
     // Get the sequence number and update it in modulo operation
     if (reliability == zn_reliability_t_RELIABLE)
     {
-        sn = ztm->sn_tx_reliable;
-        ztm->sn_tx_reliable = (ztm->sn_tx_reliable + 1) % ztm->sn_resolution;
+        sn = sns->reliable;
+        sns->reliable = (sns->reliable + 1) % ztm->sn_resolution;
     }
     else
     {
-        sn = ztm->sn_tx_best_effort;
-        ztm->sn_tx_best_effort = (ztm->sn_tx_best_effort + 1) % ztm->sn_resolution;
+        sn = sns->best_effort;
+        sns->best_effort = (sns->best_effort + 1) % ztm->sn_resolution;
     }
     return sn;
 }
 
+static int __zn_multicast_is_retransmitted(const _zn_transport_multicast_t *ztm)
+{
+    // Only the reliable frames of the links that do not guarantee the delivery are retransmitted,
+    // and only without QoS: the frames of all the priorities would share the same window otherwise
+    return ztm->link->is_reliable == 0 && ztm->sn_tx_sns.is_qos == 0;
+}
+
+/*------------------ Batching helpers ------------------*/
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+int __unsafe_zn_multicast_flush(_zn_transport_multicast_t *ztm)
+{
+    if (ztm->batch_is_open == 0)
+        return 0;
+
+    ztm->batch_is_open = 0;
+
+    // Write the message length in the reserved space if needed
+    __unsafe_zn_finalize_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+
+    // Keep the reliable frame for retransmission if the link does not guarantee the delivery
+    if (ztm->batch_reliability == zn_reliability_t_RELIABLE && __zn_multicast_is_retransmitted(ztm))
+        _zn_tx_window_push(&ztm->tx_window, ztm->sn_resolution, ztm->batch_sn, &ztm->wbuf, NULL, 0);
+
+    // Send the wbuf on the socket
+    int res = _zn_link_send_wbuf(ztm->link, &ztm->wbuf);
+    if (res == 0)
+    {
+        ztm->transmitted = 1;
+        _ZN_STATS_TRAFFIC(ztm->session, tx, _ZN_STATS_FRAME_HEADER(ztm->batch_reliability), _z_wbuf_len(&ztm->wbuf));
+    }
+
+    return res;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+int __unsafe_zn_multicast_flush_expired(_zn_transport_multicast_t *ztm)
+{
+    if (ztm->batch_is_open == 0)
+        return 0;
+
+    // Keep the frame open while the application holds a batch scope
+    if (ztm->batch_depth > 0)
+        return 0;
+
+    // Keep the frame open until the linger time expires
+    if (z_clock_elapsed_ms(&ztm->batch_start) < ztm->batch_linger)
+        return 0;
+
+    return __unsafe_zn_multicast_flush(ztm);
+}
+
+int _zn_multicast_flush(_zn_transport_multicast_t *ztm)
+{
+    z_mutex_lock(&ztm->mutex_tx);
+    int res = __unsafe_zn_multicast_flush(ztm);
+    z_mutex_unlock(&ztm->mutex_tx);
+
+    return res;
+}
+
+int _zn_multicast_flush_expired(_zn_transport_multicast_t *ztm)
+{
+    // Avoid contending the lock when there is nothing to flush
+    if (ztm->batch_is_open == 0)
+        return 0;
+
+    z_mutex_lock(&ztm->mutex_tx);
+    int res = __unsafe_zn_multicast_flush_expired(ztm);
+    z_mutex_unlock(&ztm->mutex_tx);
+
+    return res;
+}
+
+int _zn_multicast_batch_start(_zn_transport_multicast_t *ztm)
+{
+    z_mutex_lock(&ztm->mutex_tx);
+    ztm->batch_depth++;
+    z_mutex_unlock(&ztm->mutex_tx);
+
+    return 0;
+}
+
+int _zn_multicast_batch_flush(_zn_transport_multicast_t *ztm)
+{
+    int res = 0;
+
+    z_mutex_lock(&ztm->mutex_tx);
+    if (ztm->batch_depth > 0)
+        ztm->batch_depth--;
+
+    // Only the outermost batch scope sends the frame
+    if (ztm->batch_depth == 0)
+        res = __unsafe_zn_multicast_flush(ztm);
+    z_mutex_unlock(&ztm->mutex_tx);
+
+    return res;
+}
+
 int _zn_multicast_send_t_msg(_zn_transport_multicast_t *ztm, const _zn_transport_message_t *t_msg)
 {
     _Z_DEBUG(">> send session message\n");
@@ -46,6 +156,9 @@ int _zn_multicast_send_t_msg(_zn_transport_multicast_t *ztm, const _zn_transport
     // Acquire the lock
     z_mutex_lock(&ztm->mutex_tx);
 
+    // Transport messages can not be appended to a frame, flush the open batch first
+    __unsafe_zn_multicast_flush(ztm);
+
     // Prepare the buffer eventually reserving space for the message length
     __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
 
@@ -59,6 +172,8 @@ int _zn_multicast_send_t_msg(_zn_transport_multicast_t *ztm, const _zn_transport
         res = _zn_link_send_wbuf(ztm->link, &ztm->wbuf);
         // Mark the session that we have transmitted data
         ztm->transmitted = 1;
+        if (res == 0)
+            _ZN_STATS_TRAFFIC(ztm->session, tx, t_msg->header, _z_wbuf_len(&ztm->wbuf));
     }
     else
     {
@@ -71,12 +186,226 @@ int _zn_multicast_send_t_msg(_zn_transport_multicast_t *ztm, const _zn_transport
     return res;
 }
 
-int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl)
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+static int __unsafe_zn_multicast_send_serialized(_zn_transport_multicast_t *ztm, const z_bytes_t *bs, zn_reliability_t reliability, z_zint_t sn, size_t *pos)
+{
+    // Without gather writes, datagram links need the bytes to be copied in the frames
+    int is_zero_copy = ztm->link->is_streamed == 1 || ztm->link->write_vec_f != NULL;
+
+    // The serialized frame carries the bytes from pos on, as many as fit
+    size_t space_left = _z_wbuf_space_left(&ztm->wbuf);
+    size_t to_send = bs->len - *pos <= space_left ? bs->len - *pos : space_left;
+
+    int res;
+    int is_kept = reliability == zn_reliability_t_RELIABLE && __zn_multicast_is_retransmitted(ztm);
+    if (is_zero_copy)
+    {
+        // Write the frame length in the reserved space if needed
+        __unsafe_zn_finalize_frame(&ztm->wbuf, ztm->link->is_streamed, to_send);
+        // Keep the reliable frame for retransmission if the link does not guarantee the delivery
+        if (is_kept)
+            _zn_tx_window_push(&ztm->tx_window, ztm->sn_resolution, sn, &ztm->wbuf, bs->val + *pos, to_send);
+        // Send the frame along with the referenced bytes
+        res = __zn_link_send_frame(ztm->link, &ztm->wbuf, bs->val + *pos, to_send);
+    }
+    else
+    {
+        // Copy the bytes right after the frame
+        _z_wbuf_write_bytes(&ztm->wbuf, bs->val, *pos, to_send);
+        // Write the message length in the reserved space if needed
+        __unsafe_zn_finalize_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+        // Keep the reliable frame for retransmission if the link does not guarantee the delivery
+        if (is_kept)
+            _zn_tx_window_push(&ztm->tx_window, ztm->sn_resolution, sn, &ztm->wbuf, NULL, 0);
+        // Send the wbuf on the socket
+        res = _zn_link_send_wbuf(ztm->link, &ztm->wbuf);
+    }
+    if (res != 0)
+    {
+        _Z_INFO("Dropping zenoh message because it can not sent\n");
+        return res;
+    }
+    _ZN_STATS_TRAFFIC(ztm->session, tx, _ZN_STATS_FRAME_HEADER(reliability), _z_wbuf_len(&ztm->wbuf) + (is_zero_copy ? to_send : 0));
+    *pos += to_send;
+
+    // Mark the session that we have transmitted data
+    ztm->transmitted = 1;
+
+    return 0;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+static int __unsafe_zn_multicast_send_fragment(_zn_transport_multicast_t *ztm, const z_bytes_t *bs, zn_reliability_t reliability, zn_priority_t priority, z_zint_t sn, int *is_fragment, size_t *pos)
+{
+    // Clear the buffer for serialization
+    __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+
+    // Serialize the frame carrying the bytes from pos on
+    int res = __unsafe_zn_serialize_frame(&ztm->wbuf, NULL, reliability, priority, is_fragment, bs->len - *pos, sn);
+    if (res != 0)
+    {
+        _Z_INFO("Dropping zenoh message because the session frame can not be encoded\n");
+        return res;
+    }
+
+    return __unsafe_zn_multicast_send_serialized(ztm, bs, reliability, sn, pos);
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+int __unsafe_zn_multicast_send_frames(_zn_transport_multicast_t *ztm, const _zn_zenoh_message_t *z_msg, const z_bytes_t *bs, zn_reliability_t reliability, zn_priority_t priority, z_zint_t sn)
+{
+    int is_fragment = 0;
+    size_t pos = 0;
+
+    // Clear the buffer for serialization
+    __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+
+    // Serialize the first frame along with the head of the zenoh message, if any.
+    // The message is fragmented if it does not fit in a single frame.
+    int res = __unsafe_zn_serialize_frame(&ztm->wbuf, z_msg, reliability, priority, &is_fragment, bs->len, sn);
+    if (res != 0 && z_msg != NULL)
+    {
+        // The head does not fit in a frame, fragment the whole encoded zenoh message instead
+        z_bytes_t msg;
+        res = _zn_zenoh_message_flatten(&msg, z_msg);
+        if (res == 0)
+        {
+            res = __unsafe_zn_multicast_send_frames(ztm, NULL, &msg, reliability, priority, sn);
+            _z_bytes_clear(&msg);
+        }
+        else
+        {
+            _Z_INFO("Dropping zenoh message because it can not be encoded\n");
+        }
+        return res;
+    }
+    else if (res != 0)
+    {
+        _Z_INFO("Dropping zenoh message because the session frame can not be encoded\n");
+        return res;
+    }
+
+    res = __unsafe_zn_multicast_send_serialized(ztm, bs, reliability, sn, &pos);
+    while (res == 0 && pos < bs->len)
+    {
+        // Get the fragment sequence number
+        sn = __unsafe_zn_multicast_get_sn(ztm, reliability, priority);
+        res = __unsafe_zn_multicast_send_fragment(ztm, bs, reliability, priority, sn, &is_fragment, &pos);
+    }
+
+    return res;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->mutex_tx
+ */
+int __unsafe_zn_multicast_write_encoded(_zn_transport_multicast_t *ztm, const z_bytes_t *msg, zn_reliability_t reliability, zn_priority_t priority, size_t *pos)
+{
+    // Without QoS, all the priorities share the same conduit
+    if (ztm->sn_tx_sns.is_qos == 0)
+        priority = ZN_PRIORITY_DEFAULT;
+
+    // Try to append the encoded message to the open frame, if any
+    if (ztm->batch_is_open == 1)
+    {
+        if (*pos == 0 && ztm->batch_reliability == reliability && ztm->batch_priority == priority && _z_wbuf_space_left(&ztm->wbuf) >= msg->len)
+        {
+            *pos = msg->len;
+            return _z_wbuf_write_bytes(&ztm->wbuf, msg->val, 0, msg->len);
+        }
+
+        // Flush the current batch before starting a new one
+        int res = __unsafe_zn_multicast_flush(ztm);
+        if (res != 0)
+        {
+            _Z_INFO("Dropping zenoh message because the batch can not be sent\n");
+            return res;
+        }
+    }
+
+    // Send the next fragment of a message that does not fit in a batch
+    if (*pos > 0)
+    {
+        int is_fragment = 1;
+        z_zint_t sn = __unsafe_zn_multicast_get_sn(ztm, reliability, priority);
+        return __unsafe_zn_multicast_send_fragment(ztm, msg, reliability, priority, sn, &is_fragment, pos);
+    }
+
+    // Prepare the buffer eventually reserving space for the message length
+    __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+
+    // Get the next sequence number and encode the frame header
+    z_zint_t sn = __unsafe_zn_multicast_get_sn(ztm, reliability, priority);
+    _zn_transport_message_t t_msg = __zn_frame_header(reliability, priority, 0, 0, sn);
+    int res = _zn_transport_message_encode(&ztm->wbuf, &t_msg);
+    if (res != 0)
+    {
+        _Z_INFO("Dropping zenoh message because the session frame can not be encoded\n");
+        return res;
+    }
+
+    if (_z_wbuf_space_left(&ztm->wbuf) >= msg->len)
+    {
+        // Leave the frame open so that the following zenoh messages can be appended to it
+        ztm->batch_is_open = 1;
+        ztm->batch_reliability = reliability;
+        ztm->batch_priority = priority;
+        ztm->batch_sn = sn;
+        ztm->batch_start = z_clock_now();
+        *pos = msg->len;
+        return _z_wbuf_write_bytes(&ztm->wbuf, msg->val, 0, msg->len);
+    }
+
+    // The message does not fit in a batch, send its first fragment.
+    // The following ones are sent by the next calls, unless preempted by higher priorities.
+    int is_fragment = 0;
+    return __unsafe_zn_multicast_send_fragment(ztm, msg, reliability, priority, sn, &is_fragment, pos);
+}
+
+int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_reliability_t reliability, zn_congestion_control_t cong_ctrl, zn_priority_t priority)
 {
     _Z_DEBUG(">> send zenoh message\n");
 
     _zn_transport_multicast_t *ztm = &zn->tp->transport.multicast;
 
+    // Hand the message over to the write task, if any, which sends the higher priorities first
+    z_mutex_lock(&ztm->mutex_write_task);
+    int is_enqueued = ztm->write_task_running;
+    if (is_enqueued)
+        ztm->write_task_users++;
+    z_mutex_unlock(&ztm->mutex_write_task);
+
+    if (is_enqueued)
+    {
+        int res = _zn_enqueue_z_msg(zn, ztm->tx_queue, z_msg, reliability, cong_ctrl, priority);
+
+        // The write task being stopped waits for the last publisher to release the queue
+        z_mutex_lock(&ztm->mutex_write_task);
+        ztm->write_task_users--;
+        if (!ztm->write_task_running && ztm->write_task_users == 0)
+            z_condvar_signal(&ztm->write_task_idle);
+        z_mutex_unlock(&ztm->mutex_write_task);
+        return res;
+    }
+
+    // Without QoS, all the priorities share the same conduit
+    if (ztm->sn_tx_sns.is_qos == 0)
+        priority = ZN_PRIORITY_DEFAULT;
+
     // Acquire the lock and drop the message if needed
     if (cong_ctrl == zn_congestion_control_t_BLOCK)
     {
@@ -88,21 +417,67 @@ int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_re
         if (locked != 0)
         {
             _Z_INFO("Dropping zenoh message because of congestion control\n");
+            _ZN_STATS_INC(zn, dropped_congestion);
             // We failed to acquire the lock, drop the message
             return 0;
         }
     }
 
+    int res = 0;
+
+    // Large payloads are referenced by the frames rather than copied into the batch
+    z_bytes_t payload = _zn_zenoh_message_payload(z_msg);
+    if (payload.len >= ZN_ZERO_COPY_THRESHOLD)
+    {
+        // Flush the open batch to preserve the ordering of the zenoh messages
+        res = __unsafe_zn_multicast_flush(ztm);
+        if (res != 0)
+        {
+            _Z_INFO("Dropping zenoh message because the batch can not be sent\n");
+            goto EXIT_ZSND_PROC;
+        }
+
+        z_zint_t sn = __unsafe_zn_multicast_get_sn(ztm, reliability, priority);
+        res = __unsafe_zn_multicast_send_frames(ztm, z_msg, &payload, reliability, priority, sn);
+        goto EXIT_ZSND_PROC;
+    }
+
+    // Try to append the zenoh message to the open frame, if any
+    if (ztm->batch_is_open == 1)
+    {
+        if (ztm->batch_reliability == reliability && ztm->batch_priority == priority)
+        {
+            // Mark the buffer for the writing operation
+            size_t w_pos = _z_wbuf_get_wpos(&ztm->wbuf);
+            if (_zn_zenoh_message_encode(&ztm->wbuf, z_msg) == 0)
+            {
+                res = __unsafe_zn_multicast_flush_expired(ztm);
+                goto EXIT_ZSND_PROC;
+            }
+
+            // The zenoh message does not fit in the current batch, revert the buffer
+            _z_wbuf_set_wpos(&ztm->wbuf, w_pos);
+        }
+
+        // Flush the current batch before starting a new one
+        res = __unsafe_zn_multicast_flush(ztm);
+        if (res != 0)
+        {
+            _Z_INFO("Dropping zenoh message because the batch can not be sent\n");
+            goto EXIT_ZSND_PROC;
+        }
+    }
+
     // Prepare the buffer eventually reserving space for the message length
     __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
 
     // Get the next sequence number
-    z_zint_t sn = __unsafe_zn_multicast_get_sn(ztm, reliability);
+    z_zint_t sn = __unsafe_zn_multicast_get_sn(ztm, reliability, priority);
     // Create the frame header that carries the zenoh message
-    _zn_transport_message_t t_msg = __zn_frame_header(reliability, 0, 0, sn);
+    _zn_transport_message_t t_msg = __zn_frame_header(reliability, priority, 0, 0, sn);
 
     // Encode the frame header
-    int res = _zn_transport_message_encode(&ztm->wbuf, &t_msg);
+    res = _zn_transport_message_encode(&ztm->wbuf, &t_msg);
     if (res != 0)
     {
         _Z_INFO("Dropping zenoh message because the session frame can not be encoded\n");
@@ -113,71 +488,95 @@ int _zn_multicast_send_z_msg(zn_session_t *zn, _zn_zenoh_message_t *z_msg, zn_re
     res = _zn_zenoh_message_encode(&ztm->wbuf, z_msg);
     if (res == 0)
     {
-        // Write the message legnth in the reserved space if needed
-        __unsafe_zn_finalize_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+        // Leave the frame open so that the following zenoh messages can be appended to it.
+        // The batch is sent right away if no linger time is configured.
+        ztm->batch_is_open = 1;
+        ztm->batch_reliability = reliability;
+        ztm->batch_priority = priority;
+        ztm->batch_sn = sn;
+        ztm->batch_start = z_clock_now();
 
-        // Send the wbuf on the socket
-        res = _zn_link_send_wbuf(ztm->link, &ztm->wbuf);
-        if (res == 0)
-            ztm->transmitted = 1;
+        res = __unsafe_zn_multicast_flush_expired(ztm);
     }
     else
     {
-        // The message does not fit in the current batch, let's fragment it
-        // Create an expandable wbuf for fragmentation
-        _z_wbuf_t fbf = _z_wbuf_make(ZN_IOSLICE_SIZE, 1);
+        // The message does not fit in the current batch, let's fragment it.
+        // Its payload bytes are sliced straight from the user buffer into the fragments.
+        res = __unsafe_zn_multicast_send_frames(ztm, z_msg, &payload, reliability, priority, sn);
+    }
 
-        // Encode the message on the expandable wbuf
-        res = _zn_zenoh_message_encode(&fbf, z_msg);
-        if (res != 0)
-        {
-            _Z_INFO("Dropping zenoh message because it can not be fragmented\n");
-            goto EXIT_FRAG_PROC;
-        }
+EXIT_ZSND_PROC:
+    // Only count the zenoh messages that have been sent, or are in the open batch
+    if (res == 0)
+        _ZN_STATS_Z_MSG(zn, tx, z_msg->header, reliability);
 
-        // Fragment and send the message
-        int is_first = 1;
-        while (_z_wbuf_len(&fbf) > 0)
-        {
-            // Get the fragment sequence number
-            if (!is_first)
-                sn = __unsafe_zn_multicast_get_sn(ztm, reliability);
-            is_first = 0;
+    // Release the lock
+    z_mutex_unlock(&ztm->mutex_tx);
 
-            // Clear the buffer for serialization
-            __unsafe_zn_prepare_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+    return res;
+}
 
-            // Serialize one fragment
-            res = __unsafe_zn_serialize_zenoh_fragment(&ztm->wbuf, &fbf, reliability, sn);
-            if (res != 0)
-            {
-                _Z_INFO("Dropping zenoh message because it can not be fragmented\n");
-                goto EXIT_FRAG_PROC;
-            }
+/*------------------ Reliability helpers ------------------*/
+int _zn_multicast_retransmit(_zn_transport_multicast_t *ztm, z_zint_t sn, z_zint_t mask)
+{
+    // Links that guarantee the delivery do not keep the reliable frames
+    if (ztm->link->is_reliable == 1)
+        return 0;
 
-            // Write the message length in the reserved space if needed
-            __unsafe_zn_finalize_wbuf(&ztm->wbuf, ztm->link->is_streamed);
+    int res = 0;
 
-            // Send the wbuf on the socket
-            res = _zn_link_send_wbuf(ztm->link, &ztm->wbuf);
-            if (res != 0)
-            {
-                _Z_INFO("Dropping zenoh message because it can not sent\n");
-                goto EXIT_FRAG_PROC;
-            }
+    z_mutex_lock(&ztm->mutex_tx);
+
+    // The frames are only released when evicted, since an ACK_NACK message does not tell which
+    // peer of the group it is meant for. The ones meant for the other peers trigger spurious
+    // retransmissions, which are dropped as duplicates by the receivers.
 
-            // Mark the session that we have transmitted data
-            ztm->transmitted = 1;
+    // Bit i of the mask is set when the frame with SN sn + i is missing
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE && mask != 0; i++, mask >>= 1)
+    {
+        if ((mask & 1) == 0)
+            continue;
+
+        const z_bytes_t *frame = _zn_tx_window_get(&ztm->tx_window, ztm->sn_resolution, (sn + i) % ztm->sn_resolution);
+        if (frame == NULL)
+        {
+            _Z_INFO("Reliable frame can not be retransmitted because it has been evicted\n");
+            continue;
         }
 
-    EXIT_FRAG_PROC:
-        // Free the fragmentation buffer memory
-        _z_wbuf_clear(&fbf);
+        z_bytes_t bs = *frame;
+        res = _zn_link_send_vec(ztm->link, &bs, 1);
+        if (res != 0)
+            break;
+        _ZN_STATS_INC(ztm->session, retransmitted);
     }
 
-EXIT_ZSND_PROC:
-    // Release the lock
     z_mutex_unlock(&ztm->mutex_tx);
 
     return res;
-}
\ No newline at end of file
+}
+
+int _zn_multicast_sync_expired(_zn_transport_multicast_t *ztm)
+{
+    // Avoid contending the lock when no reliable frame has been sent since the last SYNC message
+    if (!__zn_multicast_is_retransmitted(ztm) || ztm->tx_window.synced == ztm->sn_tx_sns.val.plain.reliable)
+        return 0;
+
+    z_mutex_lock(&ztm->mutex_tx);
+    int is_expired = ztm->tx_window.len > 0 && z_clock_elapsed_ms(&ztm->tx_window.last_sync) >= ZN_RELIABILITY_SYNC_PERIOD;
+    // The count covers the frames in the window along with the open batch, if any
+    z_zint_t sn = ztm->sn_tx_sns.val.plain.reliable;
+    z_zint_t count = _zn_sn_distance(ztm->sn_resolution, ztm->tx_window.base, sn);
+    if (is_expired)
+    {
+        ztm->tx_window.synced = sn;
+        ztm->tx_window.last_sync = z_clock_now();
+    }
+    z_mutex_unlock(&ztm->mutex_tx);
+
+    if (!is_expired)
+        return 0;
+
+    _zn_transport_message_t t_msg = _zn_t_msg_make_sync(sn, 1, count);
+    return _zn_multicast_send_t_msg(ztm, &t_msg);
+}
@@ -17,8 +17,12 @@
 
 void _zn_transport_peer_entry_clear(_zn_transport_peer_entry_t *src)
 {
-    _z_wbuf_clear(&src->dbuf_reliable);
-    _z_wbuf_clear(&src->dbuf_best_effort);
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        _zn_defrag_buf_clear(&src->dbuf_reliable[i]);
+        _zn_defrag_buf_clear(&src->dbuf_best_effort[i]);
+    }
+    _zn_reorder_buf_clear(&src->rbuf_reliable);
 
     _z_bytes_clear(&src->remote_pid);
     _z_bytes_clear(&src->remote_addr);
@@ -26,16 +30,21 @@ void _zn_transport_peer_entry_clear(_zn_transport_peer_entry_t *src)
 
 void _zn_transport_peer_entry_copy(_zn_transport_peer_entry_t *dst, const _zn_transport_peer_entry_t *src)
 {
-    _z_wbuf_copy(&dst->dbuf_reliable, &src->dbuf_reliable);
-    _z_wbuf_copy(&dst->dbuf_best_effort, &src->dbuf_best_effort);
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        _zn_defrag_buf_copy(&dst->dbuf_reliable[i], &src->dbuf_reliable[i]);
+        _zn_defrag_buf_copy(&dst->dbuf_best_effort[i], &src->dbuf_best_effort[i]);
+    }
+    _zn_reorder_buf_copy(&dst->rbuf_reliable, &src->rbuf_reliable);
 
     dst->sn_resolution = src->sn_resolution;
     dst->sn_resolution_half = src->sn_resolution_half;
     _zn_conduit_sn_list_copy(&dst->sn_rx_sns, &src->sn_rx_sns);
 
     dst->lease = src->lease;
-    dst->next_lease = src->next_lease;
     dst->received = src->received;
+    // The lease of the copy is not scheduled
+    _zn_timer_init(&dst->lease_timer, src->lease_timer.callback, src->lease_timer.arg);
 
     _z_bytes_copy(&dst->remote_pid, &src->remote_pid);
     _z_bytes_copy(&dst->remote_addr, &src->remote_addr);
@@ -57,3 +66,78 @@ int _zn_transport_peer_entry_eq(const _zn_transport_peer_entry_t *left, const _z
 
     return 1; // True
 }
+
+/*------------------ Peer table ------------------*/
+static size_t __zn_transport_peer_table_bucket(const z_bytes_t *remote_addr)
+{
+    // FNV-1a hash of the remote address
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < remote_addr->len; i++)
+    {
+        hash ^= remote_addr->val[i];
+        hash *= 16777619u;
+    }
+
+    return hash % ZN_PEER_TABLE_SIZE;
+}
+
+static int __zn_transport_peer_table_addr_eq(const _zn_transport_peer_entry_t *entry, const z_bytes_t *remote_addr)
+{
+    if (entry->remote_addr.len != remote_addr->len)
+        return 0; // False
+
+    return memcmp(entry->remote_addr.val, remote_addr->val, remote_addr->len) == 0;
+}
+
+static int __zn_transport_peer_table_ptr_eq(const void *left, const void *right)
+{
+    return left == right;
+}
+
+void _zn_transport_peer_table_init(_zn_transport_peer_table_t *tbl)
+{
+    for (size_t i = 0; i < ZN_PEER_TABLE_SIZE; i++)
+        tbl->buckets[i] = NULL;
+    tbl->last = NULL;
+}
+
+void _zn_transport_peer_table_clear(_zn_transport_peer_table_t *tbl)
+{
+    // The entries are owned by the peer list, only the bucket nodes are freed
+    for (size_t i = 0; i < ZN_PEER_TABLE_SIZE; i++)
+        _z_list_free(&tbl->buckets[i], _zn_noop_free);
+    tbl->last = NULL;
+}
+
+void _zn_transport_peer_table_insert(_zn_transport_peer_table_t *tbl, _zn_transport_peer_entry_t *entry)
+{
+    size_t idx = __zn_transport_peer_table_bucket(&entry->remote_addr);
+    tbl->buckets[idx] = _z_list_push(tbl->buckets[idx], entry);
+}
+
+void _zn_transport_peer_table_remove(_zn_transport_peer_table_t *tbl, _zn_transport_peer_entry_t *entry)
+{
+    size_t idx = __zn_transport_peer_table_bucket(&entry->remote_addr);
+    tbl->buckets[idx] = _z_list_drop_filter(tbl->buckets[idx], _zn_noop_free, __zn_transport_peer_table_ptr_eq, entry);
+    if (tbl->last == entry)
+        tbl->last = NULL;
+}
+
+_zn_transport_peer_entry_t *_zn_transport_peer_table_get(_zn_transport_peer_table_t *tbl, const z_bytes_t *remote_addr)
+{
+    if (tbl->last != NULL && __zn_transport_peer_table_addr_eq(tbl->last, remote_addr))
+        return tbl->last;
+
+    _z_list_t *l = tbl->buckets[__zn_transport_peer_table_bucket(remote_addr)];
+    for (; l != NULL; l = _z_list_tail(l))
+    {
+        _zn_transport_peer_entry_t *entry = (_zn_transport_peer_entry_t *)_z_list_head(l);
+        if (__zn_transport_peer_table_addr_eq(entry, remote_addr))
+        {
+            tbl->last = entry;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,255 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <string.h>
+#include "zenoh-pico/transport/timer.h"
+#include "zenoh-pico/config.h"
+
+#define _ZN_TIMERS_DEFAULT_CAPACITY 16
+
+/*------------------ Heap helpers ------------------*/
+static void __zn_timers_swap(_zn_timers_t *tms, size_t i, size_t j)
+{
+    _zn_timer_t *tmr = tms->heap[i];
+    tms->heap[i] = tms->heap[j];
+    tms->heap[j] = tmr;
+
+    tms->heap[i]->idx = i;
+    tms->heap[j]->idx = j;
+}
+
+static void __zn_timers_sift_up(_zn_timers_t *tms, size_t i)
+{
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (tms->heap[parent]->deadline <= tms->heap[i]->deadline)
+            break;
+
+        __zn_timers_swap(tms, parent, i);
+        i = parent;
+    }
+}
+
+static void __zn_timers_sift_down(_zn_timers_t *tms, size_t i)
+{
+    while (1)
+    {
+        size_t min = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < tms->len && tms->heap[left]->deadline < tms->heap[min]->deadline)
+            min = left;
+        if (right < tms->len && tms->heap[right]->deadline < tms->heap[min]->deadline)
+            min = right;
+        if (min == i)
+            break;
+
+        __zn_timers_swap(tms, min, i);
+        i = min;
+    }
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - tms->mutex
+ */
+static void __unsafe_zn_timers_remove(_zn_timers_t *tms, _zn_timer_t *tmr)
+{
+    size_t i = tmr->idx;
+    tmr->idx = _ZN_TIMER_IDLE;
+
+    tms->len--;
+    if (i == tms->len)
+        return;
+
+    // Fill the hole with the last timer, which may need to move either way
+    _zn_timer_t *last = tms->heap[tms->len];
+    tms->heap[i] = last;
+    last->idx = i;
+    __zn_timers_sift_up(tms, i);
+    __zn_timers_sift_down(tms, last->idx);
+}
+
+/*------------------ Timer ------------------*/
+void _zn_timer_init(_zn_timer_t *tmr, _zn_timer_f callback, void *arg)
+{
+    tmr->deadline = 0;
+    tmr->callback = callback;
+    tmr->arg = arg;
+    tmr->idx = _ZN_TIMER_IDLE;
+}
+
+int _zn_timer_is_scheduled(const _zn_timer_t *tmr)
+{
+    return tmr->idx != _ZN_TIMER_IDLE;
+}
+
+/*------------------ Timer service ------------------*/
+int _zn_timers_init(_zn_timers_t *tms)
+{
+    tms->start = z_clock_now();
+    tms->heap = NULL;
+    tms->len = 0;
+    tms->capacity = 0;
+    tms->firing = NULL;
+
+    return z_mutex_init(&tms->mutex);
+}
+
+void _zn_timers_clear(_zn_timers_t *tms)
+{
+    // The timers are owned by the objects they are embedded in
+    for (size_t i = 0; i < tms->len; i++)
+        tms->heap[i]->idx = _ZN_TIMER_IDLE;
+
+    z_free(tms->heap);
+    tms->heap = NULL;
+    tms->len = 0;
+    tms->capacity = 0;
+    tms->firing = NULL;
+
+    z_mutex_free(&tms->mutex);
+}
+
+z_zint_t _zn_timers_now(_zn_timers_t *tms)
+{
+    return z_clock_elapsed_ms(&tms->start);
+}
+
+int _zn_timers_schedule(_zn_timers_t *tms, _zn_timer_t *tmr, z_zint_t delay)
+{
+    z_mutex_lock(&tms->mutex);
+
+    tmr->deadline = _zn_timers_now(tms) + delay;
+    if (tmr->idx != _ZN_TIMER_IDLE)
+    {
+        // Already scheduled, move it to its new position
+        __zn_timers_sift_up(tms, tmr->idx);
+        __zn_timers_sift_down(tms, tmr->idx);
+        goto EXIT;
+    }
+
+    if (tms->len == tms->capacity)
+    {
+        // z_realloc is not available on all platforms
+        size_t capacity = tms->capacity == 0 ? _ZN_TIMERS_DEFAULT_CAPACITY : tms->capacity * 2;
+        _zn_timer_t **heap = (_zn_timer_t **)z_malloc(capacity * sizeof(_zn_timer_t *));
+        if (heap == NULL)
+            goto ERR;
+
+        if (tms->heap != NULL)
+        {
+            memcpy(heap, tms->heap, tms->len * sizeof(_zn_timer_t *));
+            z_free(tms->heap);
+        }
+        tms->heap = heap;
+        tms->capacity = capacity;
+    }
+
+    tmr->idx = tms->len;
+    tms->heap[tms->len++] = tmr;
+    __zn_timers_sift_up(tms, tmr->idx);
+
+EXIT:
+    z_mutex_unlock(&tms->mutex);
+    return 0;
+
+ERR:
+    z_mutex_unlock(&tms->mutex);
+    return -1;
+}
+
+void _zn_timers_cancel(_zn_timers_t *tms, _zn_timer_t *tmr)
+{
+    z_mutex_lock(&tms->mutex);
+
+    if (tmr->idx != _ZN_TIMER_IDLE)
+        __unsafe_zn_timers_remove(tms, tmr);
+
+    // The callback of the timer might be about to be called, make sure it will not claim it
+    if (tms->firing == tmr)
+        tms->firing = NULL;
+
+    z_mutex_unlock(&tms->mutex);
+}
+
+/**
+ * Claim the expired timer passed to a callback. It fails if the timer has been cancelled since
+ * its expiration, in which case the object it is embedded in might not exist anymore.
+ * The objects cancel their timers before being freed, so the callback must claim the timer
+ * while holding the mutex protecting the object, in order to keep it alive.
+ */
+int _zn_timers_claim(_zn_timers_t *tms, _zn_timer_t *tmr)
+{
+    z_mutex_lock(&tms->mutex);
+
+    int ret = tms->firing == tmr;
+    if (ret)
+        tms->firing = NULL;
+
+    z_mutex_unlock(&tms->mutex);
+    return ret;
+}
+
+/**
+ * Call the callbacks of the expired timers, in the order of their deadlines.
+ * It returns the time in milliseconds until the next deadline, or _ZN_TIMER_IDLE if no timer is scheduled.
+ */
+z_zint_t _zn_timers_expire(_zn_timers_t *tms)
+{
+    z_mutex_lock(&tms->mutex);
+
+    while (tms->len > 0)
+    {
+        z_zint_t now = _zn_timers_now(tms);
+        _zn_timer_t *tmr = tms->heap[0];
+        if (tmr->deadline > now)
+        {
+            z_zint_t next = tmr->deadline - now;
+            z_mutex_unlock(&tms->mutex);
+            return next;
+        }
+
+        __unsafe_zn_timers_remove(tms, tmr);
+        _zn_timer_f callback = tmr->callback;
+        void *arg = tmr->arg;
+        tms->firing = tmr;
+
+        z_mutex_unlock(&tms->mutex);
+        callback(tmr, arg);
+        z_mutex_lock(&tms->mutex);
+
+        tms->firing = NULL;
+    }
+
+    z_mutex_unlock(&tms->mutex);
+    return _ZN_TIMER_IDLE;
+}
+
+void _zn_timers_run(_zn_timers_t *tms, volatile int *running)
+{
+    while (*running)
+    {
+        z_zint_t interval = _zn_timers_expire(tms);
+
+        // The deadlines scheduled while sleeping are honoured within the timer resolution
+        if (interval > ZN_TIMER_RESOLUTION)
+            interval = ZN_TIMER_RESOLUTION;
+
+        // The deadlines are expressed in milliseconds
+        z_sleep_ms(interval);
+    }
+}
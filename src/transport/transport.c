@@ -17,6 +17,8 @@
 #include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/transport/link/rx.h"
 #include "zenoh-pico/transport/link/tx.h"
+#include "zenoh-pico/transport/link/task/reactor.h"
+#include "zenoh-pico/transport/link/task/write.h"
 #include "zenoh-pico/utils/logging.h"
 
 int _zn_unicast_send_close(_zn_transport_unicast_t *ztu, uint8_t reason, int link_only)
@@ -69,32 +71,47 @@ _zn_transport_t *_zn_transport_unicast_new(_zn_link_t *link, _zn_transport_unica
     zt->transport.unicast.wbuf = _z_wbuf_make(mtu, 0);
     zt->transport.unicast.zbuf = _z_zbuf_make(ZN_BATCH_SIZE);
 
+    // No batch is open at start
+    zt->transport.unicast.batch_is_open = 0;
+    zt->transport.unicast.batch_depth = 0;
+    zt->transport.unicast.batch_linger = ZN_TX_BATCH_LINGER;
+
     // Initialize the defragmentation buffers
-#if ZN_DYNAMIC_MEMORY_ALLOCATION == 1
-    zt->transport.unicast.dbuf_reliable = _z_wbuf_make(0, 1);
-    zt->transport.unicast.dbuf_best_effort = _z_wbuf_make(0, 1);
-#else
-    zt->transport.unicast.dbuf_reliable = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
-    zt->transport.unicast.dbuf_best_effort = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
-#endif
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        _zn_defrag_buf_init(&zt->transport.unicast.dbuf_reliable[i]);
+        _zn_defrag_buf_init(&zt->transport.unicast.dbuf_best_effort[i]);
+    }
+
+    // Initialize the retransmission window and the reorder buffer
+    _zn_tx_window_init(&zt->transport.unicast.tx_window);
+    _zn_reorder_buf_init(&zt->transport.unicast.rbuf_reliable);
 
     // Set default SN resolution
     zt->transport.unicast.sn_resolution = param.sn_resolution;
     zt->transport.unicast.sn_resolution_half = param.sn_resolution / 2;
 
-    // The initial SN at TX side
-    zt->transport.unicast.sn_tx_reliable = param.initial_sn_tx;
-    zt->transport.unicast.sn_tx_best_effort = param.initial_sn_tx;
+    // The initial SN at TX side, for each priority if QoS is supported
+    _zn_conduit_sn_list_init(&zt->transport.unicast.sn_tx_sns, param.is_qos, param.initial_sn_tx);
 
-    // The initial SN at RX side
-    zt->transport.unicast.sn_rx_reliable = param.initial_sn_rx;
-    zt->transport.unicast.sn_rx_best_effort = param.initial_sn_rx;
+    // The initial SN at RX side, for each priority if QoS is supported
+    _zn_conduit_sn_list_init(&zt->transport.unicast.sn_rx_sns, param.is_qos, param.initial_sn_rx);
 
     // Tasks
     zt->transport.unicast.read_task_running = 0;
     zt->transport.unicast.read_task = NULL;
+    zt->transport.unicast.reactor = NULL;
     zt->transport.unicast.lease_task_running = 0;
     zt->transport.unicast.lease_task = NULL;
+    zt->transport.unicast.tx_queue = NULL;
+    z_mutex_init(&zt->transport.unicast.mutex_write_task);
+    z_condvar_init(&zt->transport.unicast.write_task_idle);
+    zt->transport.unicast.write_task_users = 0;
+    zt->transport.unicast.write_task_running = 0;
+    zt->transport.unicast.write_task = NULL;
+
+    // Timers driven by the lease task
+    _zn_timers_init(&zt->transport.unicast.timers);
 
     // Notifiers
     zt->transport.unicast.received = 0;
@@ -127,21 +144,39 @@ _zn_transport_t *_zn_transport_multicast_new(_zn_link_t *link, _zn_transport_mul
     zt->transport.multicast.wbuf = _z_wbuf_make(mtu, 0);
     zt->transport.multicast.zbuf = _z_zbuf_make(ZN_BATCH_SIZE);
 
+    // No batch is open at start
+    zt->transport.multicast.batch_is_open = 0;
+    zt->transport.multicast.batch_depth = 0;
+    zt->transport.multicast.batch_linger = ZN_TX_BATCH_LINGER;
+
     // Set default SN resolution
     zt->transport.multicast.sn_resolution = param.sn_resolution;
     zt->transport.multicast.sn_resolution_half = param.sn_resolution / 2;
-    // The initial SN at TX side
-    zt->transport.multicast.sn_tx_reliable = param.initial_sn_tx;
-    zt->transport.multicast.sn_tx_best_effort = param.initial_sn_tx;
+    // The initial SN at TX side, for each priority if QoS is supported
+    _zn_conduit_sn_list_init(&zt->transport.multicast.sn_tx_sns, param.is_qos, param.initial_sn_tx);
+
+    // Initialize the retransmission window
+    _zn_tx_window_init(&zt->transport.multicast.tx_window);
 
     // Initialize peer list
     zt->transport.multicast.peers = _zn_transport_peer_entry_list_new();
+    _zn_transport_peer_table_init(&zt->transport.multicast.peer_table);
 
     // Tasks
     zt->transport.multicast.read_task_running = 0;
     zt->transport.multicast.read_task = NULL;
+    zt->transport.multicast.reactor = NULL;
     zt->transport.multicast.lease_task_running = 0;
     zt->transport.multicast.lease_task = NULL;
+    zt->transport.multicast.tx_queue = NULL;
+    z_mutex_init(&zt->transport.multicast.mutex_write_task);
+    z_condvar_init(&zt->transport.multicast.write_task_idle);
+    zt->transport.multicast.write_task_users = 0;
+    zt->transport.multicast.write_task_running = 0;
+    zt->transport.multicast.write_task = NULL;
+
+    // Timers driven by the lease task
+    _zn_timers_init(&zt->transport.multicast.timers);
     zt->transport.multicast.lease = ZN_TRANSPORT_LEASE;
 
     // Notifiers
@@ -162,7 +197,9 @@ _zn_transport_unicast_establish_param_result_t _zn_transport_unicast_open_client
     uint8_t version = ZN_PROTO_VERSION;
     z_zint_t whatami = ZN_CLIENT;
     z_zint_t sn_resolution = ZN_SN_RESOLUTION;
-    int is_qos = 0;
+    // QoS is only requested on the links that guarantee the delivery, the reliable frames
+    // are not retransmitted on the other ones when carried by the conduits of the priorities
+    int is_qos = ZN_TRANSPORT_QOS == 1 && zl->is_reliable == 1;
 
     z_bytes_t pid = _z_bytes_wrap(local_pid.val, local_pid.len);
     _zn_transport_message_t ism = _zn_t_msg_make_init_syn(version, whatami, sn_resolution, pid, is_qos);
@@ -201,6 +238,9 @@ _zn_transport_unicast_establish_param_result_t _zn_transport_unicast_open_client
                     goto ERR_2;
             }
 
+            // The transport supports QoS if both sides do
+            param.is_qos = is_qos && _ZN_HAS_FLAG(iam.body.init.options, _ZN_OPT_INIT_QOS);
+
             // The initial SN at TX side
             z_random_fill(&param.initial_sn_tx, sizeof(param.initial_sn_tx));
             param.initial_sn_tx = param.initial_sn_tx % param.sn_resolution;
@@ -300,16 +340,14 @@ _zn_transport_multicast_establish_param_result_t _zn_transport_multicast_open_pe
 {
     _zn_transport_multicast_establish_param_result_t ret;
     _zn_transport_multicast_establish_param_t param;
-    param.is_qos = 0; // FIXME: make transport aware of qos configuration
+    // QoS is only announced on the links that guarantee the delivery, as for unicast transports
+    param.is_qos = ZN_TRANSPORT_QOS == 1 && zl->is_reliable == 1;
     param.initial_sn_tx = 0;
     param.sn_resolution = ZN_SN_RESOLUTION;
 
     // Explicitly send a JOIN message upon startup
-    // FIXME: make transport aware of qos configuration
     _zn_conduit_sn_list_t next_sns;
-    next_sns.is_qos = 0;
-    next_sns.val.plain.best_effort = param.initial_sn_tx;
-    next_sns.val.plain.reliable = param.initial_sn_tx;
+    _zn_conduit_sn_list_init(&next_sns, param.is_qos, param.initial_sn_tx);
 
     z_bytes_t pid = _z_bytes_wrap(local_pid.val, local_pid.len);
     _zn_transport_message_t jsm = _zn_t_msg_make_join(ZN_PROTO_VERSION, ZN_PEER, ZN_TRANSPORT_LEASE, param.sn_resolution, pid, next_sns);
@@ -335,11 +373,19 @@ ERR_1:
 
 int _zn_transport_unicast_close(_zn_transport_unicast_t *ztu, uint8_t reason)
 {
+    // Send the queued zenoh messages before closing
+    if (ztu->write_task != NULL)
+        _znp_unicast_stop_write_task(ztu);
+
     return _zn_unicast_send_close(ztu, reason, 0);
 }
 
 int _zn_transport_multicast_close(_zn_transport_multicast_t *ztm, uint8_t reason)
 {
+    // Send the queued zenoh messages before closing
+    if (ztm->write_task != NULL)
+        _znp_multicast_stop_write_task(ztm);
+
     return _zn_multicast_send_close(ztm, reason, 0);
 }
 
@@ -351,26 +397,42 @@ int _zn_transport_close(_zn_transport_t *zt, uint8_t reason)
 void _zn_transport_unicast_clear(_zn_transport_unicast_t *ztu)
 {
     // Clean up tasks
+    if (ztu->write_task != NULL)
+        _znp_unicast_stop_write_task(ztu);
     if (ztu->read_task != NULL)
     {
         z_task_join(ztu->read_task);
         z_task_free(&ztu->read_task);
     }
+#if Z_REACTOR == 1
+    if (ztu->reactor != NULL)
+        _zn_reactor_unicast_remove((_zn_reactor_t *)ztu->reactor, ztu);
+#endif
     if (ztu->lease_task != NULL)
     {
         z_task_join(ztu->lease_task);
         z_task_free(&ztu->lease_task);
     }
 
+    // Clean up the timers
+    _zn_timers_clear(&ztu->timers);
+
     // Clean up the mutexes
     z_mutex_free(&ztu->mutex_tx);
     z_mutex_free(&ztu->mutex_rx);
+    z_mutex_free(&ztu->mutex_write_task);
+    z_condvar_free(&ztu->write_task_idle);
 
     // Clean up the buffers
     _z_wbuf_clear(&ztu->wbuf);
     _z_zbuf_clear(&ztu->zbuf);
-    _z_wbuf_clear(&ztu->dbuf_reliable);
-    _z_wbuf_clear(&ztu->dbuf_best_effort);
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        _zn_defrag_buf_clear(&ztu->dbuf_reliable[i]);
+        _zn_defrag_buf_clear(&ztu->dbuf_best_effort[i]);
+    }
+    _zn_tx_window_clear(&ztu->tx_window);
+    _zn_reorder_buf_clear(&ztu->rbuf_reliable);
 
     // Clean up PIDs
     _z_bytes_clear(&ztu->remote_pid);
@@ -382,27 +444,40 @@ void _zn_transport_unicast_clear(_zn_transport_unicast_t *ztu)
 void _zn_transport_multicast_clear(_zn_transport_multicast_t *ztm)
 {
     // Clean up tasks
+    if (ztm->write_task != NULL)
+        _znp_multicast_stop_write_task(ztm);
     if (ztm->read_task != NULL)
     {
         z_task_join(ztm->read_task);
         z_task_free(&ztm->read_task);
     }
+#if Z_REACTOR == 1
+    if (ztm->reactor != NULL)
+        _zn_reactor_multicast_remove((_zn_reactor_t *)ztm->reactor, ztm);
+#endif
     if (ztm->lease_task != NULL)
     {
         z_task_join(ztm->lease_task);
         z_task_free(&ztm->lease_task);
     }
 
+    // Clean up the timers
+    _zn_timers_clear(&ztm->timers);
+
     // Clean up the mutexes
     z_mutex_free(&ztm->mutex_tx);
     z_mutex_free(&ztm->mutex_rx);
     z_mutex_free(&ztm->mutex_peer);
+    z_mutex_free(&ztm->mutex_write_task);
+    z_condvar_free(&ztm->write_task_idle);
 
     // Clean up the buffers
     _z_wbuf_clear(&ztm->wbuf);
     _z_zbuf_clear(&ztm->zbuf);
+    _zn_tx_window_clear(&ztm->tx_window);
 
     // Clean up peer list
+    _zn_transport_peer_table_clear(&ztm->peer_table);
     _zn_transport_peer_entry_list_free(&ztm->peers);
 
     if (ztm->link != NULL)
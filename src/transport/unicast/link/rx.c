@@ -14,6 +14,7 @@
 
 #include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/link/tx.h"
 #include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/utils/logging.h"
 
@@ -73,8 +74,12 @@ void _zn_unicast_recv_t_msg_na(_zn_transport_unicast_t *ztu, _zn_transport_messa
     // Mark the session that we have received data
     ztu->received = 1;
 
+    _ZN_STATS_ADD(ztu->session, rx.bytes, _z_zbuf_get_wpos(&ztu->zbuf));
+
     _Z_DEBUG(">> \t transport_message_decode\n");
-    _zn_transport_message_decode_na(&ztu->zbuf, r);
+    _zn_transport_message_decode_lazy_na(&ztu->zbuf, r);
+    if (r->tag == _z_res_t_ERR)
+        _ZN_STATS_INC(ztu->session, malformed);
 
 EXIT_SRCV_PROC:
     // Release the lock
@@ -89,8 +94,268 @@ _zn_transport_message_result_t _zn_unicast_recv_t_msg(_zn_transport_unicast_t *z
     return r;
 }
 
+typedef struct
+{
+    void *session;
+    zn_reliability_t reliability;
+} __zn_unicast_frame_ctx_t;
+
+static int __zn_unicast_handle_zenoh_message(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    __zn_unicast_frame_ctx_t *ctx = (__zn_unicast_frame_ctx_t *)arg;
+    _ZN_STATS_Z_MSG(ctx->session, rx, z_msg->header, ctx->reliability);
+
+    // Keep handling the remaining messages of the frame regardless of the outcome
+    _zn_handle_zenoh_message((zn_session_t *)ctx->session, z_msg);
+    return 0;
+}
+
+static void __zn_unicast_handle_frame(_zn_transport_unicast_t *ztu, uint8_t header, _zn_frame_t *frame)
+{
+    zn_reliability_t reliability = _ZN_HAS_FLAG(header, _ZN_FLAG_T_R) ? zn_reliability_t_RELIABLE : zn_reliability_t_BEST_EFFORT;
+    if (_ZN_HAS_FLAG(header, _ZN_FLAG_T_F))
+    {
+        // Select the right defragmentation buffer, the fragments of each priority are reassembled apart
+        _zn_defrag_buf_t *dbuf = _ZN_HAS_FLAG(header, _ZN_FLAG_T_R) ? &ztu->dbuf_reliable[frame->priority] : &ztu->dbuf_best_effort[frame->priority];
+
+        // Add the fragment to the defragmentation buffer, unless the zenoh message is dropped
+        // because it is bigger than the max buffer size
+        _zn_defrag_buf_push(dbuf, &frame->payload.fragment);
+
+        // Check if this is the last fragment
+        if (_ZN_HAS_FLAG(header, _ZN_FLAG_T_E))
+        {
+            if (dbuf->is_dropping == 0)
+            {
+                // Decode the zenoh message in place, its payload refers to the defragmentation buffer
+                _zn_zenoh_message_result_t r_zm = _zn_zenoh_message_decode(&dbuf->zbf);
+                if (r_zm.tag == _z_res_t_OK)
+                {
+                    _zn_zenoh_message_t d_zm = r_zm.value.zenoh_message;
+                    _ZN_STATS_Z_MSG(ztu->session, rx, d_zm.header, reliability);
+                    _zn_handle_zenoh_message(ztu->session, &d_zm);
+
+                    // Clear must be explicitly called for fragmented zenoh messages.
+                    // Non-fragmented zenoh messages are released when their transport message is released.
+                    _zn_z_msg_clear(&d_zm);
+                }
+                else
+                {
+                    _ZN_STATS_INC(ztu->session, malformed);
+                }
+            }
+            else
+            {
+                _ZN_STATS_INC(ztu->session, dropped_fragments);
+            }
+
+            // Reset the defragmentation buffer
+            _zn_defrag_buf_reset(dbuf);
+        }
+    }
+    else if (frame->is_lazy)
+    {
+        // Decode and handle the zenoh messages one by one, without allocating them
+        __zn_unicast_frame_ctx_t ctx = {ztu->session, reliability};
+        if (_zn_frame_messages_decode(frame, __zn_unicast_handle_zenoh_message, &ctx) != 0)
+            _ZN_STATS_INC(ztu->session, malformed);
+    }
+    else
+    {
+        // Handle all the zenoh message, one by one
+        unsigned int len = _z_vec_len(&frame->payload.messages);
+        for (unsigned int i = 0; i < len; i++)
+        {
+            _zn_zenoh_message_t *z_msg = (_zn_zenoh_message_t *)_z_vec_get(&frame->payload.messages, i);
+            _ZN_STATS_Z_MSG(ztu->session, rx, z_msg->header, reliability);
+            _zn_handle_zenoh_message(ztu->session, z_msg);
+        }
+    }
+}
+
+/*------------------ Reliability helpers ------------------*/
+static void __zn_unicast_handle_buffered_frame(_zn_transport_unicast_t *ztu, uint8_t header, z_zint_t sn, z_bytes_t *payload)
+{
+    // Rebuild the frame out of its buffered payload, which is decoded lazily unless it is a fragment
+    _zn_frame_t frame;
+    frame.sn = sn;
+    frame.priority = ZN_PRIORITY_DEFAULT;
+    frame.is_lazy = !_ZN_HAS_FLAG(header, _ZN_FLAG_T_F);
+    if (frame.is_lazy)
+        frame.payload.encoded = *payload;
+    else
+        frame.payload.fragment = *payload;
+
+    __zn_unicast_handle_frame(ztu, header, &frame);
+    _z_bytes_clear(payload);
+}
+
+static int __zn_unicast_send_ack_nack(_zn_transport_unicast_t *ztu, size_t len)
+{
+    // Acknowledge the frames preceding the next expected SN, and report the missing ones among the next len frames
+    ztu->rbuf_reliable.acked = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    z_zint_t mask = _zn_reorder_buf_mask(&ztu->rbuf_reliable, len);
+
+    _zn_transport_message_t t_msg = _zn_t_msg_make_ack_nack(ztu->rbuf_reliable.acked, mask);
+    return _zn_unicast_send_t_msg(ztu, &t_msg);
+}
+
+static void __zn_unicast_drain_reliable(_zn_transport_unicast_t *ztu)
+{
+    // Handle the frames received ahead that are no longer waiting for a missing one
+    uint8_t header;
+    z_bytes_t payload;
+    while (_zn_reorder_buf_take(&ztu->rbuf_reliable, &header, &payload))
+    {
+        z_zint_t sn = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+        __zn_unicast_handle_buffered_frame(ztu, header, sn, &payload);
+        ztu->sn_rx_sns.val.plain.reliable = sn;
+        _zn_reorder_buf_shift(&ztu->rbuf_reliable);
+    }
+
+    // The frames left now wait for another missing one
+    if (ztu->rbuf_reliable.len > 0)
+        ztu->rbuf_reliable.gap_start = z_clock_now();
+}
+
+static void __zn_unicast_skip_reliable(_zn_transport_unicast_t *ztu, z_zint_t sn)
+{
+    // The remote peer no longer keeps the frames preceding the SN: handle the ones received ahead
+    // and account the missing ones as lost
+    _zn_reorder_buf_t *rbuf = &ztu->rbuf_reliable;
+    z_zint_t next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    while (next != sn)
+    {
+        if (rbuf->len == 0)
+        {
+            _ZN_STATS_ADD(ztu->session, lost, _zn_sn_distance(ztu->sn_resolution, next, sn));
+            // The fragmented zenoh message being reassembled, if any, misses some fragments
+            if (_z_zbuf_len(&ztu->dbuf_reliable[ZN_PRIORITY_DEFAULT].zbf) > 0)
+                ztu->dbuf_reliable[ZN_PRIORITY_DEFAULT].is_dropping = 1;
+            ztu->sn_rx_sns.val.plain.reliable = _zn_sn_decrement(ztu->sn_resolution, sn);
+            break;
+        }
+
+        uint8_t header;
+        z_bytes_t payload;
+        if (_zn_reorder_buf_take(rbuf, &header, &payload))
+        {
+            __zn_unicast_handle_buffered_frame(ztu, header, next, &payload);
+        }
+        else
+        {
+            _ZN_STATS_INC(ztu->session, lost);
+            if (_z_zbuf_len(&ztu->dbuf_reliable[ZN_PRIORITY_DEFAULT].zbf) > 0)
+                ztu->dbuf_reliable[ZN_PRIORITY_DEFAULT].is_dropping = 1;
+        }
+
+        ztu->sn_rx_sns.val.plain.reliable = next;
+        _zn_reorder_buf_shift(rbuf);
+        next = _zn_sn_increment(ztu->sn_resolution, next);
+    }
+
+    __zn_unicast_drain_reliable(ztu);
+}
+
+static void __zn_unicast_skip_stalled_reliable(_zn_transport_unicast_t *ztu)
+{
+    // The remote peer may not retransmit the frames, e.g. if it does not support it: stop waiting
+    // for a missing frame after a lease period, and handle the frames received ahead of it
+    _zn_reorder_buf_t *rbuf = &ztu->rbuf_reliable;
+    if (rbuf->len == 0 || (z_zint_t)z_clock_elapsed_ms(&rbuf->gap_start) < ztu->lease)
+        return;
+
+    size_t offset = 1;
+    while (rbuf->headers[offset] == 0)
+        offset++;
+
+    z_zint_t next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    __zn_unicast_skip_reliable(ztu, (next + offset) % ztu->sn_resolution);
+}
+
+static void __zn_unicast_handle_reliable_frame(_zn_transport_unicast_t *ztu, uint8_t header, _zn_frame_t *frame)
+{
+    _zn_reorder_buf_t *rbuf = &ztu->rbuf_reliable;
+    z_zint_t next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    z_zint_t offset = _zn_sn_distance(ztu->sn_resolution, next, frame->sn);
+    if (offset >= ztu->sn_resolution_half)
+    {
+        _ZN_STATS_INC(ztu->session, dropped_out_of_order);
+        _Z_INFO("Reliable message dropped because it has already been received\n");
+        return;
+    }
+
+    if (offset >= ZN_RELIABILITY_WINDOW_SIZE)
+    {
+        // The remote peer has evicted the missing frames from its window, skip them to make room for this one
+        __zn_unicast_skip_reliable(ztu, (frame->sn + ztu->sn_resolution - (ZN_RELIABILITY_WINDOW_SIZE - 1)) % ztu->sn_resolution);
+        next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+        offset = _zn_sn_distance(ztu->sn_resolution, next, frame->sn);
+    }
+
+    if (offset == 0)
+    {
+        __zn_unicast_handle_frame(ztu, header, frame);
+        ztu->sn_rx_sns.val.plain.reliable = frame->sn;
+        _zn_reorder_buf_shift(rbuf);
+        __zn_unicast_drain_reliable(ztu);
+
+        // Periodically acknowledge the frames, so that the remote peer releases them
+        next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+        if (_zn_sn_distance(ztu->sn_resolution, rbuf->acked, next) >= ZN_RELIABILITY_WINDOW_SIZE / 2)
+            __zn_unicast_send_ack_nack(ztu, 0);
+    }
+    else if (_ZN_HAS_FLAG(header, _ZN_FLAG_T_F) || frame->is_lazy)
+    {
+        // Buffer the frame until the missing ones are retransmitted
+        const z_bytes_t *payload = _ZN_HAS_FLAG(header, _ZN_FLAG_T_F) ? &frame->payload.fragment : &frame->payload.encoded;
+        if (_zn_reorder_buf_put(rbuf, offset, header, payload) != 0)
+        {
+            _ZN_STATS_INC(ztu->session, dropped_out_of_order);
+            _Z_INFO("Reliable message dropped because it has already been received\n");
+            return;
+        }
+
+        // Report the missing frames as soon as a gap is detected
+        if (rbuf->len == 1)
+        {
+            rbuf->gap_start = z_clock_now();
+            __zn_unicast_send_ack_nack(ztu, offset);
+        }
+    }
+    else
+    {
+        // Decoded zenoh messages refer to the read buffer, the frame will be retransmitted
+        _ZN_STATS_INC(ztu->session, dropped_out_of_order);
+        _Z_INFO("Reliable message dropped because it is out of order\n");
+    }
+}
+
+static void __zn_unicast_handle_sync(_zn_transport_unicast_t *ztu, const _zn_sync_t *sync)
+{
+    // The remote peer keeps the count frames preceding the SN, skip the older ones that are missing
+    z_zint_t first = (sync->sn + ztu->sn_resolution - sync->count % ztu->sn_resolution) % ztu->sn_resolution;
+    z_zint_t next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    if (_zn_sn_precedes(ztu->sn_resolution_half, next, first))
+        __zn_unicast_skip_reliable(ztu, first);
+
+    // Report the missing frames among the ones sent so far
+    next = _zn_sn_increment(ztu->sn_resolution, ztu->sn_rx_sns.val.plain.reliable);
+    z_zint_t len = _zn_sn_distance(ztu->sn_resolution, next, sync->sn);
+    if (len >= ztu->sn_resolution_half)
+        len = 0;
+
+    __zn_unicast_send_ack_nack(ztu, len);
+}
+
 int _zn_unicast_handle_transport_message(_zn_transport_unicast_t *ztu, _zn_transport_message_t *t_msg)
 {
+    _ZN_STATS_TRAFFIC(ztu->session, rx, t_msg->header, 0);
+
+    // Any message from the remote peer, like its periodic keep alives, bounds the wait for a missing frame
+    if (ztu->link->is_reliable == 0 && ztu->sn_rx_sns.is_qos == 0)
+        __zn_unicast_skip_stalled_reliable(ztu);
+
     switch (_ZN_MID(t_msg->header))
     {
     case _ZN_MID_SCOUT:
@@ -125,13 +390,17 @@ int _zn_unicast_handle_transport_message(_zn_transport_unicast_t *ztu, _zn_trans
 
     case _ZN_MID_SYNC:
     {
-        _Z_INFO("Handling of Sync messages not implemented\n");
+        _Z_INFO("Received ZN_SYNC message\n");
+        // Only the reliable channel of the links that do not guarantee the delivery is synchronized
+        if (_ZN_HAS_FLAG(t_msg->header, _ZN_FLAG_T_R) && ztu->link->is_reliable == 0 && ztu->sn_rx_sns.is_qos == 0)
+            __zn_unicast_handle_sync(ztu, &t_msg->body.sync);
         break;
     }
 
     case _ZN_MID_ACK_NACK:
     {
-        _Z_INFO("Handling of AckNack messages not implemented\n");
+        _Z_INFO("Received ZN_ACK_NACK message\n");
+        _zn_unicast_retransmit(ztu, t_msg->body.ack_nack.sn, t_msg->body.ack_nack.mask);
         break;
     }
 
@@ -150,95 +419,49 @@ int _zn_unicast_handle_transport_message(_zn_transport_unicast_t *ztu, _zn_trans
     case _ZN_MID_FRAME:
     {
         _Z_INFO("Received ZN_FRAME message\n");
+        // Each priority has its own conduit if the transport supports QoS
+        zn_priority_t priority = t_msg->body.frame.priority;
+        _zn_coundit_sn_t *sns = _zn_conduit_sn_list_get(&ztu->sn_rx_sns, priority);
+
         // Check if the SN is correct
         if (_ZN_HAS_FLAG(t_msg->header, _ZN_FLAG_T_R))
         {
-            // @TODO: amend once reliability is in place. For the time being only
-            //        monothonic SNs are ensured
-            if (_zn_sn_precedes(ztu->sn_resolution_half, ztu->sn_rx_reliable, t_msg->body.frame.sn))
+            // Reliable frames are reordered, and retransmitted when missing, on the links that
+            // do not guarantee the delivery. Otherwise, only monotonic SNs need to be ensured.
+            if (ztu->link->is_reliable == 0 && ztu->sn_rx_sns.is_qos == 0)
             {
-                ztu->sn_rx_reliable = t_msg->body.frame.sn;
+                __zn_unicast_handle_reliable_frame(ztu, t_msg->header, &t_msg->body.frame);
+                break;
+            }
+
+            if (_zn_sn_precedes(ztu->sn_resolution_half, sns->reliable, t_msg->body.frame.sn))
+            {
+                sns->reliable = t_msg->body.frame.sn;
             }
             else
             {
-                _z_wbuf_clear(&ztu->dbuf_reliable);
+                _zn_defrag_buf_reset(&ztu->dbuf_reliable[priority]);
+                _ZN_STATS_INC(ztu->session, dropped_out_of_order);
                 _Z_INFO("Reliable message dropped because it is out of order\n");
                 break;
             }
         }
         else
         {
-            if (_zn_sn_precedes(ztu->sn_resolution_half, ztu->sn_rx_best_effort, t_msg->body.frame.sn))
+            if (_zn_sn_precedes(ztu->sn_resolution_half, sns->best_effort, t_msg->body.frame.sn))
             {
-                ztu->sn_rx_best_effort = t_msg->body.frame.sn;
+                sns->best_effort = t_msg->body.frame.sn;
             }
             else
             {
-                _z_wbuf_clear(&ztu->dbuf_best_effort);
+                _zn_defrag_buf_reset(&ztu->dbuf_best_effort[priority]);
+                _ZN_STATS_INC(ztu->session, dropped_out_of_order);
                 _Z_INFO("Best effort message dropped because it is out of order\n");
                 break;
             }
         }
 
-        if (_ZN_HAS_FLAG(t_msg->header, _ZN_FLAG_T_F))
-        {
-            // Select the right defragmentation buffer
-            _z_wbuf_t *dbuf = _ZN_HAS_FLAG(t_msg->header, _ZN_FLAG_T_R) ? &ztu->dbuf_reliable : &ztu->dbuf_best_effort;
-
-            uint8_t drop = 0;
-            if (_z_wbuf_len(dbuf) + t_msg->body.frame.payload.fragment.len > ZN_FRAG_MAX_SIZE)
-            {
-                // Filling the wbuf capacity as a way to signling the last fragment to reset the dbuf
-                // Otherwise, last (smaller) fragments can be understood as a complete message
-                _z_wbuf_write_bytes(dbuf, t_msg->body.frame.payload.fragment.val, 0, _z_wbuf_space_left(dbuf));
-                drop = 1;
-            }
-            else
-            {
-                // Add the fragment to the defragmentation buffer
-                _z_wbuf_write_bytes(dbuf, t_msg->body.frame.payload.fragment.val, 0, t_msg->body.frame.payload.fragment.len);
-            }
-
-            // Check if this is the last fragment
-            if (_ZN_HAS_FLAG(t_msg->header, _ZN_FLAG_T_E))
-            {
-                // Drop message if it is bigger the max buffer size
-                if (drop == 1)
-                {
-                    _z_wbuf_reset(dbuf);
-                    break;
-                }
-
-                // Convert the defragmentation buffer into a decoding buffer
-                _z_zbuf_t zbf = _z_wbuf_to_zbuf(dbuf);
-
-                // Decode the zenoh message
-                _zn_zenoh_message_result_t r_zm = _zn_zenoh_message_decode(&zbf);
-                if (r_zm.tag == _z_res_t_OK)
-                {
-                    _zn_zenoh_message_t d_zm = r_zm.value.zenoh_message;
-                    _zn_handle_zenoh_message(ztu->session, &d_zm);
-
-                    // Clear must be explicitly called for fragmented zenoh messages.
-                    // Non-fragmented zenoh messages are released when their transport message is released.
-                    _zn_z_msg_clear(&d_zm);
-                }
-
-                // Free the decoding buffer
-                _z_zbuf_clear(&zbf);
-                // Reset the defragmentation buffer
-                _z_wbuf_reset(dbuf);
-            }
-
-            break;
-        }
-        else
-        {
-            // Handle all the zenoh message, one by one
-            unsigned int len = _z_vec_len(&t_msg->body.frame.payload.messages);
-            for (unsigned int i = 0; i < len; i++)
-                _zn_handle_zenoh_message(ztu->session, (_zn_zenoh_message_t *)_z_vec_get(&t_msg->body.frame.payload.messages, i));
-        }
+        __zn_unicast_handle_frame(ztu, t_msg->header, &t_msg->body.frame);
         break;
     }
 
@@ -27,6 +27,56 @@ int _znp_unicast_send_keep_alive(_zn_transport_unicast_t *ztu)
     return _zn_unicast_send_t_msg(ztu, &t_msg);
 }
 
+static void __znp_unicast_lease_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
+
+    // Check if received data
+    if (ztu->received == 1)
+    {
+        // Reset the lease parameters
+        ztu->received = 0;
+        _zn_timers_schedule(&ztu->timers, tmr, ztu->lease);
+    }
+    else
+    {
+        _Z_INFO("Closing session because it has expired after %zums\n", ztu->lease);
+        _zn_transport_unicast_close(ztu, _ZN_CLOSE_EXPIRED);
+        ztu->lease_task_running = 0;
+    }
+}
+
+static void __znp_unicast_keep_alive_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
+
+    // Check if need to send a keep alive
+    if (ztu->transmitted == 0)
+        _znp_unicast_send_keep_alive(ztu);
+
+    // Reset the keep alive parameters
+    ztu->transmitted = 0;
+    _zn_timers_schedule(&ztu->timers, tmr, ztu->lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR);
+}
+
+static void __znp_unicast_linger_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
+
+    // Flush the TX batch if it has been lingering for too long
+    _zn_unicast_flush_expired(ztu);
+    _zn_timers_schedule(&ztu->timers, tmr, ztu->batch_linger);
+}
+
+static void __znp_unicast_sync_expired(_zn_timer_t *tmr, void *arg)
+{
+    _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
+
+    // Announce the reliable frames waiting to be acknowledged
+    _zn_unicast_sync_expired(ztu);
+    _zn_timers_schedule(&ztu->timers, tmr, ZN_RELIABILITY_SYNC_PERIOD);
+}
+
 void *_znp_unicast_lease_task(void *arg)
 {
     _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
@@ -35,56 +85,28 @@ void *_znp_unicast_lease_task(void *arg)
     ztu->received = 0;
     ztu->transmitted = 0;
 
-    z_zint_t next_lease = ztu->lease;
-    z_zint_t next_keep_alive = ztu->lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR;
-    while (ztu->lease_task_running)
-    {
-        if (next_lease <= 0)
-        {
-            // Check if received data
-            if (ztu->received == 1)
-            {
-                // Reset the lease parameters
-                ztu->received = 0;
-            }
-            else
-            {
-                _Z_INFO("Closing session because it has expired after %zums\n", ztu->lease);
-                _zn_transport_unicast_close(ztu, _ZN_CLOSE_EXPIRED);
-                return 0;
-            }
-
-            next_lease = ztu->lease;
-        }
-
-        if (next_keep_alive <= 0)
-        {
-            // Check if need to send a keep alive
-            if (ztu->transmitted == 0)
-                _znp_unicast_send_keep_alive(ztu);
-
-            // Reset the keep alive parameters
-            ztu->transmitted = 0;
-            next_keep_alive = ztu->lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR;
-        }
-
-        // Compute the target interval
-        z_zint_t interval;
-        if (next_lease > 0)
-        {
-            interval = next_lease;
-            if (next_keep_alive < interval)
-                interval = next_keep_alive;
-        }
-        else
-            interval = next_keep_alive;
-
-        // The keep alive and lease intervals are expressed in milliseconds
-        z_sleep_ms(interval);
-
-        next_lease -= interval;
-        next_keep_alive -= interval;
-    }
+    // The keep alive and lease intervals are expressed in milliseconds
+    _zn_timer_init(&ztu->lease_timer, __znp_unicast_lease_expired, ztu);
+    _zn_timers_schedule(&ztu->timers, &ztu->lease_timer, ztu->lease);
+    _zn_timer_init(&ztu->keep_alive_timer, __znp_unicast_keep_alive_expired, ztu);
+    _zn_timers_schedule(&ztu->timers, &ztu->keep_alive_timer, ztu->lease / ZN_TRANSPORT_LEASE_EXPIRE_FACTOR);
+
+    _zn_timer_init(&ztu->linger_timer, __znp_unicast_linger_expired, ztu);
+    if (ztu->batch_linger > 0)
+        _zn_timers_schedule(&ztu->timers, &ztu->linger_timer, ztu->batch_linger);
+
+    // Only the links that do not guarantee the delivery synchronize the reliable channel
+    _zn_timer_init(&ztu->sync_timer, __znp_unicast_sync_expired, ztu);
+    if (ztu->link->is_reliable == 0)
+        _zn_timers_schedule(&ztu->timers, &ztu->sync_timer, ZN_RELIABILITY_SYNC_PERIOD);
+
+    // Drive the deadlines of the transport, and the ones of the session like the query timeouts
+    _zn_timers_run(&ztu->timers, &ztu->lease_task_running);
+
+    _zn_timers_cancel(&ztu->timers, &ztu->lease_timer);
+    _zn_timers_cancel(&ztu->timers, &ztu->keep_alive_timer);
+    _zn_timers_cancel(&ztu->timers, &ztu->linger_timer);
+    _zn_timers_cancel(&ztu->timers, &ztu->sync_timer);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include "zenoh-pico/api/session.h"
 #include "zenoh-pico/transport/link/task/read.h"
 #include "zenoh-pico/transport/link/rx.h"
 #include "zenoh-pico/utils/logging.h"
@@ -31,14 +32,109 @@ ERR:
     return _z_res_t_ERR;
 }
 
+/**
+ * Handle the transport messages of a batch of to_read bytes, located at the read position
+ * of the main buffer, and move the read position past them.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->mutex_rx
+ */
+static int __unsafe_znp_unicast_handle_batch(_zn_transport_unicast_t *ztu, size_t to_read)
+{
+    _zn_transport_message_result_t r;
+
+    // Wrap the main buffer for to_read bytes
+    _z_zbuf_t zbuf = _z_zbuf_view(&ztu->zbuf, to_read);
+    _ZN_STATS_ADD(ztu->session, rx.bytes, ztu->link->is_streamed == 1 ? to_read + _ZN_MSG_LEN_ENC_SIZE : to_read);
+
+    while (_z_zbuf_len(&zbuf) > 0)
+    {
+        // Mark the session that we have received data
+        ztu->received = 1;
+
+        // Decode one session message
+        _zn_transport_message_decode_lazy_na(&zbuf, &r);
+
+        if (r.tag == _z_res_t_OK)
+        {
+            int res = _zn_unicast_handle_transport_message(ztu, &r.value.transport_message);
+            if (res == _z_res_t_OK)
+                _zn_t_msg_clear(&r.value.transport_message);
+            else
+                return _z_res_t_ERR;
+        }
+        else
+        {
+            _Z_ERROR("Connection closed due to malformed message\n");
+            _ZN_STATS_INC(ztu->session, malformed);
+            return _z_res_t_ERR;
+        }
+    }
+
+    // Move the read position of the read buffer
+    _z_zbuf_set_rpos(&ztu->zbuf, _z_zbuf_get_rpos(&ztu->zbuf) + to_read);
+
+    return _z_res_t_OK;
+}
+
+int _znp_unicast_read_ready(void *arg)
+{
+    _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
+    int res = _z_res_t_OK;
+
+    z_mutex_lock(&ztu->mutex_rx);
+
+    // The link is ready: this does not block
+    size_t rb = _zn_link_recv_zbuf(ztu->link, &ztu->zbuf, NULL);
+    if (rb == SIZE_MAX)
+        goto EXIT;
+
+    if (ztu->link->is_streamed == 1)
+    {
+        // Reading nothing from a ready stream means that it has been closed by the other end
+        if (rb == 0)
+        {
+            res = _z_res_t_ERR;
+            goto EXIT;
+        }
+
+        // Handle the complete messages, a partial one is kept until the rest of it is received
+        while (_z_zbuf_len(&ztu->zbuf) >= _ZN_MSG_LEN_ENC_SIZE)
+        {
+            size_t to_read = 0;
+            for (int i = 0; i < _ZN_MSG_LEN_ENC_SIZE; i++)
+                to_read |= _z_zbuf_read(&ztu->zbuf) << (i * 8);
+
+            if (_z_zbuf_len(&ztu->zbuf) < to_read)
+            {
+                _z_zbuf_set_rpos(&ztu->zbuf, _z_zbuf_get_rpos(&ztu->zbuf) - _ZN_MSG_LEN_ENC_SIZE);
+                break;
+            }
+
+            res = __unsafe_znp_unicast_handle_batch(ztu, to_read);
+            if (res != _z_res_t_OK)
+                goto EXIT;
+        }
+    }
+    else
+    {
+        res = __unsafe_znp_unicast_handle_batch(ztu, rb);
+    }
+
+EXIT:
+    _z_zbuf_compact(&ztu->zbuf);
+    z_mutex_unlock(&ztu->mutex_rx);
+
+    return res;
+}
+
 void *_znp_unicast_read_task(void *arg)
 {
     _zn_transport_unicast_t *ztu = (_zn_transport_unicast_t *)arg;
 
     ztu->read_task_running = 1;
 
-    _zn_transport_message_result_t r;
-
     // Acquire and keep the lock
     z_mutex_lock(&ztu->mutex_rx);
 
@@ -78,34 +174,9 @@ void *_znp_unicast_read_task(void *arg)
                 continue;
         }
 
-        // Wrap the main buffer for to_read bytes
-        _z_zbuf_t zbuf = _z_zbuf_view(&ztu->zbuf, to_read);
-
-        while (_z_zbuf_len(&zbuf) > 0)
-        {
-            // Mark the session that we have received data
-            ztu->received = 1;
-
-            // Decode one session message
-            _zn_transport_message_decode_na(&zbuf, &r);
-
-            if (r.tag == _z_res_t_OK)
-            {
-                int res = _zn_unicast_handle_transport_message(ztu, &r.value.transport_message);
-                if (res == _z_res_t_OK)
-                    _zn_t_msg_clear(&r.value.transport_message);
-                else
-                    goto EXIT_RECV_LOOP;
-            }
-            else
-            {
-                _Z_ERROR("Connection closed due to malformed message\n");
-                goto EXIT_RECV_LOOP;
-            }
-        }
+        if (__unsafe_znp_unicast_handle_batch(ztu, to_read) != _z_res_t_OK)
+            goto EXIT_RECV_LOOP;
 
-        // Move the read position of the read buffer
-        _z_zbuf_set_rpos(&ztu->zbuf, _z_zbuf_get_rpos(&ztu->zbuf) + to_read);
         _z_zbuf_compact(&ztu->zbuf);
     }
 
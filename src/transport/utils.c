@@ -12,6 +12,7 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include <string.h>
 #include "zenoh-pico/transport/utils.h"
 
 int _zn_sn_precedes(const z_zint_t sn_resolution_half, const z_zint_t sn_left, const z_zint_t sn_right)
@@ -65,7 +66,347 @@ void _zn_conduit_sn_list_decrement(const z_zint_t sn_resolution, _zn_conduit_sn_
         for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
         {
             sns->val.qos[i].best_effort = _zn_sn_decrement(sn_resolution, sns->val.qos[i].best_effort);
-            sns->val.qos[i].best_effort = _zn_sn_decrement(sn_resolution, sns->val.qos[i].reliable);
+            sns->val.qos[i].reliable = _zn_sn_decrement(sn_resolution, sns->val.qos[i].reliable);
         }
     }
-}
\ No newline at end of file
+}
+
+void _zn_conduit_sn_list_init(_zn_conduit_sn_list_t *sns, uint8_t is_qos, const z_zint_t sn)
+{
+    // All the conduits start from the same SN
+    sns->is_qos = is_qos;
+    if (sns->is_qos == 0)
+    {
+        sns->val.plain.best_effort = sn;
+        sns->val.plain.reliable = sn;
+    }
+    else
+    {
+        for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+        {
+            sns->val.qos[i].best_effort = sn;
+            sns->val.qos[i].reliable = sn;
+        }
+    }
+}
+
+_zn_coundit_sn_t *_zn_conduit_sn_list_get(_zn_conduit_sn_list_t *sns, zn_priority_t priority)
+{
+    // Without QoS, all the priorities share the same conduit
+    if (sns->is_qos == 0)
+        return &sns->val.plain;
+
+    return &sns->val.qos[priority];
+}
+
+/*------------------ Defragmentation helpers ------------------*/
+void _zn_defrag_buf_init(_zn_defrag_buf_t *dbuf)
+{
+    // Nothing is allocated until the first fragment is received
+    dbuf->zbf.ios = _z_iosli_wrap(NULL, 0, 0, 0);
+    dbuf->is_dropping = 0;
+}
+
+int _zn_defrag_buf_push(_zn_defrag_buf_t *dbuf, const z_bytes_t *fragment)
+{
+    // Drop the remaining fragments once the zenoh message exceeds the max buffer size.
+    // Otherwise, last (smaller) fragments can be understood as a complete message.
+    size_t len = _z_zbuf_len(&dbuf->zbf) + fragment->len;
+    if (dbuf->is_dropping == 1 || len > ZN_FRAG_MAX_SIZE)
+    {
+        dbuf->is_dropping = 1;
+        return -1;
+    }
+
+    if (_z_zbuf_space_left(&dbuf->zbf) < fragment->len)
+    {
+#if ZN_DYNAMIC_MEMORY_ALLOCATION == 1
+        // Grow the buffer geometrically to amortize the copy of the previous fragments
+        size_t capacity = 2 * _z_zbuf_capacity(&dbuf->zbf);
+        if (capacity < len)
+            capacity = len;
+        if (capacity > ZN_FRAG_MAX_SIZE)
+            capacity = ZN_FRAG_MAX_SIZE;
+#else
+        // Allocate the buffer for the largest zenoh message on the first fragment, and keep it
+        size_t capacity = ZN_FRAG_MAX_SIZE;
+#endif
+        _z_zbuf_t zbf = _z_zbuf_make(capacity);
+        if (_z_zbuf_len(&dbuf->zbf) > 0)
+            _z_iosli_write_bytes(&zbf.ios, _z_zbuf_get_rptr(&dbuf->zbf), 0, _z_zbuf_len(&dbuf->zbf));
+        _z_zbuf_clear(&dbuf->zbf);
+        dbuf->zbf = zbf;
+    }
+
+    _z_iosli_write_bytes(&dbuf->zbf.ios, fragment->val, 0, fragment->len);
+    return 0;
+}
+
+void _zn_defrag_buf_reset(_zn_defrag_buf_t *dbuf)
+{
+#if ZN_DYNAMIC_MEMORY_ALLOCATION == 1
+    // Release the memory until the next fragmented zenoh message
+    _zn_defrag_buf_clear(dbuf);
+#else
+    _z_zbuf_reset(&dbuf->zbf);
+    dbuf->is_dropping = 0;
+#endif
+}
+
+void _zn_defrag_buf_clear(_zn_defrag_buf_t *dbuf)
+{
+    _z_zbuf_clear(&dbuf->zbf);
+    _zn_defrag_buf_init(dbuf);
+}
+
+void _zn_defrag_buf_copy(_zn_defrag_buf_t *dst, const _zn_defrag_buf_t *src)
+{
+    _zn_defrag_buf_init(dst);
+    dst->is_dropping = src->is_dropping;
+
+    size_t len = _z_zbuf_len(&src->zbf);
+    if (len > 0)
+    {
+        dst->zbf = _z_zbuf_make(_z_zbuf_capacity(&src->zbf));
+        _z_iosli_write_bytes(&dst->zbf.ios, _z_zbuf_get_rptr(&src->zbf), 0, len);
+    }
+}
+
+/*------------------ Reliability helpers ------------------*/
+z_zint_t _zn_sn_distance(const z_zint_t sn_resolution, const z_zint_t sn_from, const z_zint_t sn_to)
+{
+    return sn_to >= sn_from ? sn_to - sn_from : sn_resolution - sn_from + sn_to;
+}
+
+void _zn_tx_window_init(_zn_tx_window_t *win)
+{
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+        _z_bytes_reset(&win->frames[i]);
+    win->head = 0;
+    win->len = 0;
+    win->base = 0;
+    win->synced = 0;
+    win->last_sync = z_clock_now();
+}
+
+void _zn_tx_window_clear(_zn_tx_window_t *win)
+{
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+        _z_bytes_clear(&win->frames[i]);
+    _zn_tx_window_init(win);
+}
+
+static void __zn_tx_window_pop(_zn_tx_window_t *win, const z_zint_t sn_resolution)
+{
+    _z_bytes_clear(&win->frames[win->head]);
+    _z_bytes_reset(&win->frames[win->head]);
+    win->head = (win->head + 1) % ZN_RELIABILITY_WINDOW_SIZE;
+    win->base = _zn_sn_increment(sn_resolution, win->base);
+    win->len--;
+}
+
+void _zn_tx_window_push(_zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn, const _z_wbuf_t *wbf, const uint8_t *ext, size_t ext_len)
+{
+    if (win->len == 0)
+    {
+        win->base = sn;
+    }
+    else
+    {
+        // The SNs of the frames are consecutive, unless a frame could not be serialized.
+        // Leave an empty slot for the missing frames, or restart the window if too far ahead.
+        z_zint_t next = (win->base + win->len) % sn_resolution;
+        z_zint_t gap = _zn_sn_distance(sn_resolution, next, sn);
+        if (gap >= ZN_RELIABILITY_WINDOW_SIZE)
+        {
+            while (win->len > 0)
+                __zn_tx_window_pop(win, sn_resolution);
+            win->base = sn;
+        }
+        for (z_zint_t i = 0; i < gap && win->len > 0; i++)
+        {
+            if (win->len == ZN_RELIABILITY_WINDOW_SIZE)
+                __zn_tx_window_pop(win, sn_resolution);
+            win->len++;
+        }
+    }
+
+    // Evict the oldest frame when the window is full
+    if (win->len == ZN_RELIABILITY_WINDOW_SIZE)
+        __zn_tx_window_pop(win, sn_resolution);
+
+    // Copy the serialized frame, along with the bytes sent right after it
+    size_t len = _z_wbuf_len(wbf) + ext_len;
+    z_bytes_t *frame = &win->frames[(win->head + win->len) % ZN_RELIABILITY_WINDOW_SIZE];
+    *frame = _z_bytes_make(len);
+    uint8_t *val = (uint8_t *)frame->val;
+    size_t pos = 0;
+    for (size_t i = 0; i < _z_wbuf_len_iosli(wbf); i++)
+    {
+        _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, i);
+        size_t readable = _z_iosli_readable(ios);
+        memcpy(val + pos, ios->buf + ios->r_pos, readable);
+        pos += readable;
+    }
+    if (ext_len > 0)
+        memcpy(val + pos, ext, ext_len);
+    win->len++;
+}
+
+void _zn_tx_window_ack(_zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn)
+{
+    // Release the frames preceding the acknowledged SN
+    z_zint_t acked = _zn_sn_distance(sn_resolution, win->base, sn);
+    while (win->len > 0 && acked > 0 && acked <= ZN_RELIABILITY_WINDOW_SIZE)
+    {
+        __zn_tx_window_pop(win, sn_resolution);
+        acked--;
+    }
+}
+
+const z_bytes_t *_zn_tx_window_get(const _zn_tx_window_t *win, const z_zint_t sn_resolution, const z_zint_t sn)
+{
+    z_zint_t offset = _zn_sn_distance(sn_resolution, win->base, sn);
+    if (offset >= win->len)
+        return NULL;
+
+    const z_bytes_t *frame = &win->frames[(win->head + offset) % ZN_RELIABILITY_WINDOW_SIZE];
+    return frame->val != NULL ? frame : NULL;
+}
+
+void _zn_reorder_buf_init(_zn_reorder_buf_t *rbuf)
+{
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+    {
+        _z_bytes_reset(&rbuf->frames[i]);
+        rbuf->headers[i] = 0;
+    }
+    rbuf->len = 0;
+    rbuf->acked = 0;
+    rbuf->gap_start = z_clock_now();
+}
+
+void _zn_reorder_buf_clear(_zn_reorder_buf_t *rbuf)
+{
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+        _z_bytes_clear(&rbuf->frames[i]);
+    _zn_reorder_buf_init(rbuf);
+}
+
+void _zn_reorder_buf_copy(_zn_reorder_buf_t *dst, const _zn_reorder_buf_t *src)
+{
+    _zn_reorder_buf_init(dst);
+    for (size_t i = 0; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+    {
+        dst->headers[i] = src->headers[i];
+        if (src->headers[i] != 0)
+            _z_bytes_copy(&dst->frames[i], &src->frames[i]);
+    }
+    dst->len = src->len;
+    dst->acked = src->acked;
+    dst->gap_start = src->gap_start;
+}
+
+int _zn_reorder_buf_put(_zn_reorder_buf_t *rbuf, size_t offset, uint8_t header, const z_bytes_t *payload)
+{
+    // Positions are only free ahead of the next expected SN, a non-null header marks the used ones
+    if (offset == 0 || offset >= ZN_RELIABILITY_WINDOW_SIZE || rbuf->headers[offset] != 0)
+        return -1;
+
+    _z_bytes_copy(&rbuf->frames[offset], payload);
+    rbuf->headers[offset] = header;
+    rbuf->len++;
+    return 0;
+}
+
+int _zn_reorder_buf_take(_zn_reorder_buf_t *rbuf, uint8_t *header, z_bytes_t *payload)
+{
+    if (rbuf->headers[0] == 0)
+        return 0;
+
+    *header = rbuf->headers[0];
+    _z_bytes_move(payload, &rbuf->frames[0]);
+    rbuf->headers[0] = 0;
+    rbuf->len--;
+    return 1;
+}
+
+void _zn_reorder_buf_shift(_zn_reorder_buf_t *rbuf)
+{
+    // The frame at position 0, if any, is lost
+    if (rbuf->headers[0] != 0)
+    {
+        _z_bytes_clear(&rbuf->frames[0]);
+        rbuf->len--;
+    }
+
+    for (size_t i = 1; i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+    {
+        rbuf->frames[i - 1] = rbuf->frames[i];
+        rbuf->headers[i - 1] = rbuf->headers[i];
+    }
+    _z_bytes_reset(&rbuf->frames[ZN_RELIABILITY_WINDOW_SIZE - 1]);
+    rbuf->headers[ZN_RELIABILITY_WINDOW_SIZE - 1] = 0;
+}
+
+z_zint_t _zn_reorder_buf_mask(const _zn_reorder_buf_t *rbuf, size_t len)
+{
+    // Bit i is set when the frame with SN next + i has not been received
+    z_zint_t mask = 0;
+    for (size_t i = 0; i < len && i < ZN_RELIABILITY_WINDOW_SIZE; i++)
+    {
+        if (rbuf->headers[i] == 0)
+            mask |= (z_zint_t)1 << i;
+    }
+    return mask;
+}
+
+/*------------------ TX scheduling helpers ------------------*/
+void _zn_tx_lanes_init(_zn_tx_lanes_t *lanes)
+{
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        lanes->head[i] = NULL;
+        lanes->tail[i] = NULL;
+    }
+    lanes->len = 0;
+}
+
+void _zn_tx_lanes_push(_zn_tx_lanes_t *lanes, _zn_tx_job_t *job)
+{
+    // Append the job to the lane of its priority
+    job->next = NULL;
+    if (lanes->tail[job->priority] == NULL)
+        lanes->head[job->priority] = job;
+    else
+        lanes->tail[job->priority]->next = job;
+    lanes->tail[job->priority] = job;
+    lanes->len++;
+}
+
+_zn_tx_job_t *_zn_tx_lanes_peek(const _zn_tx_lanes_t *lanes)
+{
+    // The lower the value, the higher the priority
+    for (int i = 0; i < ZN_PRIORITIES_NUM; i++)
+    {
+        if (lanes->head[i] != NULL)
+            return lanes->head[i];
+    }
+
+    return NULL;
+}
+
+_zn_tx_job_t *_zn_tx_lanes_pop(_zn_tx_lanes_t *lanes)
+{
+    _zn_tx_job_t *job = _zn_tx_lanes_peek(lanes);
+    if (job == NULL)
+        return NULL;
+
+    lanes->head[job->priority] = job->next;
+    if (lanes->head[job->priority] == NULL)
+        lanes->tail[job->priority] = NULL;
+    job->next = NULL;
+    lanes->len--;
+
+    return job;
+}
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/system/platform.h"
+
+#define RUN 10000
+#define TASKS 4
+#define SLOTS 64
+
+volatile int first_go = 0;
+
+void *first_alloc_task(void *arg)
+{
+    (void)(arg);
+    while (!first_go)
+        ;
+    _z_pool_free(_z_pool_malloc(64, Z_MEM_OTHER));
+    return NULL;
+}
+
+void test_first_allocation(void)
+{
+    printf(">>> Testing concurrent first allocations\n");
+
+    // The pool is initialized once, even when the first allocations race
+    z_task_t tasks[TASKS];
+    for (size_t i = 0; i < TASKS; i++)
+        z_task_init(&tasks[i], NULL, first_alloc_task, NULL);
+    first_go = 1;
+    for (size_t i = 0; i < TASKS; i++)
+        z_task_join(&tasks[i]);
+
+    z_pool_stats_t stats;
+    z_pool_stats(&stats);
+    assert(stats.subsystems[Z_MEM_OTHER].allocs == TASKS);
+    assert(stats.subsystems[Z_MEM_OTHER].frees == TASKS);
+    assert(stats.subsystems[Z_MEM_OTHER].in_use == 0);
+}
+
+void test_classes(void)
+{
+    printf(">>> Testing size classes\n");
+
+    z_pool_stats_t before;
+    z_pool_stats(&before);
+
+    // Blocks of a class are reused once freed
+    void *p = _z_pool_malloc(20, Z_MEM_CODEC);
+    assert(p != NULL);
+    _z_pool_free(p);
+    void *q = _z_pool_malloc(32, Z_MEM_CODEC);
+    assert(q == p);
+
+    z_pool_stats_t stats;
+    z_pool_stats(&stats);
+    assert(stats.classes[1].block_size == 32);
+    assert(stats.classes[1].in_use == before.classes[1].in_use + 1);
+    assert(stats.classes[1].allocs == before.classes[1].allocs + 2);
+    assert(stats.classes[1].blocks > 1);
+    assert(stats.subsystems[Z_MEM_CODEC].in_use == before.subsystems[Z_MEM_CODEC].in_use + 32);
+    assert(stats.subsystems[Z_MEM_CODEC].frees == before.subsystems[Z_MEM_CODEC].frees + 1);
+    assert(stats.reserved > before.reserved);
+
+    // Larger allocations are served by the platform allocator
+    size_t large = (size_t)Z_POOL_MIN_BLOCK_SIZE << Z_POOL_CLASSES_NUM;
+    void *l = _z_pool_malloc(large, Z_MEM_TRANSPORT);
+    assert(l != NULL);
+    memset(l, 0xab, large);
+    z_pool_stats(&stats);
+    assert(stats.classes[Z_POOL_CLASSES_NUM].block_size == 0);
+    assert(stats.classes[Z_POOL_CLASSES_NUM].in_use == before.classes[Z_POOL_CLASSES_NUM].in_use + 1);
+    assert(stats.subsystems[Z_MEM_TRANSPORT].in_use == before.subsystems[Z_MEM_TRANSPORT].in_use + large);
+
+    _z_pool_free(q);
+    _z_pool_free(l);
+    _z_pool_free(NULL);
+
+    z_pool_stats(&stats);
+    for (int c = 0; c <= Z_POOL_CLASSES_NUM; c++)
+        assert(stats.classes[c].in_use == before.classes[c].in_use);
+    for (int s = 0; s < Z_MEM_SUBSYSTEMS_NUM; s++)
+        assert(stats.subsystems[s].in_use == before.subsystems[s].in_use);
+}
+
+void test_realloc(void)
+{
+    printf(">>> Testing realloc\n");
+
+    uint8_t *p = (uint8_t *)_z_pool_realloc(NULL, 10, Z_MEM_SESSION);
+    for (uint8_t i = 0; i < 10; i++)
+        p[i] = i;
+
+    // The block is kept while it is large enough
+    uint8_t *q = (uint8_t *)_z_pool_realloc(p, 16, Z_MEM_SESSION);
+    assert(q == p);
+
+    // Otherwise the content is moved to a larger block
+    q = (uint8_t *)_z_pool_realloc(p, 5000, Z_MEM_SESSION);
+    assert(q != p);
+    for (uint8_t i = 0; i < 10; i++)
+        assert(q[i] == i);
+
+    q = (uint8_t *)_z_pool_realloc(q, 3, Z_MEM_SESSION);
+    for (uint8_t i = 0; i < 3; i++)
+        assert(q[i] == i);
+    _z_pool_free(q);
+}
+
+void *alloc_task(void *arg)
+{
+    size_t seed = (size_t)arg;
+    void *slots[SLOTS];
+    memset(slots, 0, sizeof(slots));
+
+    for (size_t i = 0; i < RUN; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        size_t s = (seed >> 8) % SLOTS;
+        _z_pool_free(slots[s]);
+        size_t size = 1 + (seed >> 16) % 3000;
+        slots[s] = _z_pool_malloc(size, Z_MEM_SESSION);
+        memset(slots[s], (int)s, size);
+    }
+
+    for (size_t s = 0; s < SLOTS; s++)
+        _z_pool_free(slots[s]);
+
+    return NULL;
+}
+
+void test_concurrency(void)
+{
+    printf(">>> Testing concurrent allocations\n");
+
+    z_pool_stats_t before;
+    z_pool_stats(&before);
+
+    z_task_t tasks[TASKS];
+    for (size_t i = 0; i < TASKS; i++)
+        z_task_init(&tasks[i], NULL, alloc_task, (void *)(i + 1));
+    for (size_t i = 0; i < TASKS; i++)
+        z_task_join(&tasks[i]);
+
+    z_pool_stats_t stats;
+    z_pool_stats(&stats);
+    assert(stats.subsystems[Z_MEM_SESSION].in_use == before.subsystems[Z_MEM_SESSION].in_use);
+    assert(stats.subsystems[Z_MEM_SESSION].allocs == before.subsystems[Z_MEM_SESSION].allocs + TASKS * RUN);
+    assert(stats.subsystems[Z_MEM_SESSION].peak > 0);
+    for (int c = 0; c <= Z_POOL_CLASSES_NUM; c++)
+    {
+        assert(stats.classes[c].in_use == before.classes[c].in_use);
+        printf("  - class %zu: %zu blocks, peak %zu, %zu allocs\n", stats.classes[c].block_size,
+               stats.classes[c].blocks, stats.classes[c].peak, stats.classes[c].allocs);
+    }
+}
+
+int main(void)
+{
+    test_first_allocation();
+    test_classes();
+    test_realloc();
+    test_concurrency();
+
+    return 0;
+}
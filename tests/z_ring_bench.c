@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include "zenoh-pico/system/collections.h"
+#include "zenoh-pico/system/platform.h"
+
+#define RUN 1000000
+#define CAPACITY 256
+
+// Elements are never null
+#define ELEM(i) ((void *)(uintptr_t)((i) + 1))
+
+void *mvar_produce(void *arg)
+{
+    z_mvar_t *mv = (z_mvar_t *)arg;
+    for (size_t i = 0; i < RUN; i++)
+        z_mvar_put(mv, ELEM(i));
+    return 0;
+}
+
+void *spsc_produce(void *arg)
+{
+    z_spsc_ring_t *r = (z_spsc_ring_t *)arg;
+    for (size_t i = 0; i < RUN; i++)
+    {
+        while (z_spsc_ring_push(r, ELEM(i)) != 0)
+            z_sleep_us(0);
+    }
+    return 0;
+}
+
+void *mpsc_produce(void *arg)
+{
+    z_mpsc_ring_t *r = (z_mpsc_ring_t *)arg;
+    for (size_t i = 0; i < RUN; i++)
+    {
+        while (z_mpsc_ring_push(r, ELEM(i)) != 0)
+            z_sleep_us(0);
+    }
+    return 0;
+}
+
+void *queue_produce(void *arg)
+{
+    z_ring_queue_t *q = (z_ring_queue_t *)arg;
+    for (size_t i = 0; i < RUN; i++)
+        z_ring_queue_put(q, ELEM(i));
+    return 0;
+}
+
+void report(const char *name, z_clock_t *start)
+{
+    unsigned long us = z_clock_elapsed_us(start);
+    printf("%-12s %8lu us %10.1f ns/elem %8.2f Melem/s\n", name, us, (us * 1000.0) / RUN, (double)RUN / us);
+}
+
+int main(void)
+{
+    z_task_t producer;
+    z_clock_t start;
+
+    printf("Transferring %d elements between two tasks\n", RUN);
+
+    z_mvar_t *mv = z_mvar_empty();
+    start = z_clock_now();
+    z_task_init(&producer, NULL, mvar_produce, mv);
+    for (size_t i = 0; i < RUN; i++)
+        z_mvar_get(mv);
+    z_task_join(&producer);
+    report("mvar", &start);
+    z_free(mv);
+
+    z_spsc_ring_t *spsc = z_spsc_ring_make(CAPACITY);
+    start = z_clock_now();
+    z_task_init(&producer, NULL, spsc_produce, spsc);
+    for (size_t i = 0; i < RUN; i++)
+    {
+        while (z_spsc_ring_pull(spsc) == NULL)
+            z_sleep_us(0);
+    }
+    z_task_join(&producer);
+    report("spsc_ring", &start);
+    z_spsc_ring_free(&spsc);
+
+    z_mpsc_ring_t *mpsc = z_mpsc_ring_make(CAPACITY);
+    start = z_clock_now();
+    z_task_init(&producer, NULL, mpsc_produce, mpsc);
+    for (size_t i = 0; i < RUN; i++)
+    {
+        while (z_mpsc_ring_pull(mpsc) == NULL)
+            z_sleep_us(0);
+    }
+    z_task_join(&producer);
+    report("mpsc_ring", &start);
+    z_mpsc_ring_free(&mpsc);
+
+    z_ring_queue_t *q = z_ring_queue_make(CAPACITY);
+    start = z_clock_now();
+    z_task_init(&producer, NULL, queue_produce, q);
+    for (size_t i = 0; i < RUN; i++)
+        z_ring_queue_get(q);
+    z_task_join(&producer);
+    report("ring_queue", &start);
+    z_ring_queue_free(&q);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "zenoh-pico/system/collections.h"
+#include "zenoh-pico/system/platform.h"
+
+#define PRODUCERS 4
+#define RUN 100000
+
+// Elements are encoded as (producer << 24 | sequence) + 1, never null
+#define ELEM(p, i) ((void *)(uintptr_t)((((uintptr_t)(p) << 24) | (uintptr_t)(i)) + 1))
+#define ELEM_PRODUCER(e) ((((uintptr_t)(e)) - 1) >> 24)
+#define ELEM_SEQ(e) ((((uintptr_t)(e)) - 1) & 0xffffff)
+
+void spsc_ring_test(void)
+{
+    z_spsc_ring_t *r = z_spsc_ring_make(5);
+    assert(z_spsc_ring_capacity(r) == 8);
+    assert(z_spsc_ring_pull(r) == NULL);
+
+    // Wrap around several times
+    for (size_t lap = 0; lap < 3; lap++)
+    {
+        for (size_t i = 0; i < 8; i++)
+            assert(z_spsc_ring_push(r, ELEM(0, i)) == 0);
+        assert(z_spsc_ring_push(r, ELEM(0, 8)) == -1);
+
+        for (size_t i = 0; i < 8; i++)
+            assert(z_spsc_ring_pull(r) == ELEM(0, i));
+        assert(z_spsc_ring_pull(r) == NULL);
+    }
+
+    z_spsc_ring_free(&r);
+    assert(r == NULL);
+}
+
+void mpsc_ring_test(void)
+{
+    z_mpsc_ring_t *r = z_mpsc_ring_make(4);
+    assert(z_mpsc_ring_capacity(r) == 4);
+    assert(z_mpsc_ring_pull(r) == NULL);
+
+    for (size_t lap = 0; lap < 3; lap++)
+    {
+        for (size_t i = 0; i < 4; i++)
+            assert(z_mpsc_ring_push(r, ELEM(0, i)) == 0);
+        assert(z_mpsc_ring_push(r, ELEM(0, 4)) == -1);
+
+        // Interleave pulls and pushes
+        assert(z_mpsc_ring_pull(r) == ELEM(0, 0));
+        assert(z_mpsc_ring_push(r, ELEM(0, 4)) == 0);
+        for (size_t i = 1; i < 5; i++)
+            assert(z_mpsc_ring_pull(r) == ELEM(0, i));
+        assert(z_mpsc_ring_pull(r) == NULL);
+    }
+
+    z_mpsc_ring_free(&r);
+    assert(r == NULL);
+}
+
+void *spsc_produce(void *arg)
+{
+    z_spsc_ring_t *r = (z_spsc_ring_t *)arg;
+    for (size_t i = 0; i < RUN; i++)
+    {
+        // Yield while spinning, the test might run on a single core
+        while (z_spsc_ring_push(r, ELEM(0, i)) != 0)
+            z_sleep_us(0);
+    }
+    return 0;
+}
+
+void spsc_ring_concurrent_test(void)
+{
+    z_spsc_ring_t *r = z_spsc_ring_make(16);
+
+    z_task_t producer;
+    z_task_init(&producer, NULL, spsc_produce, r);
+
+    for (size_t i = 0; i < RUN; i++)
+    {
+        void *e;
+        while ((e = z_spsc_ring_pull(r)) == NULL)
+            z_sleep_us(0);
+        assert(e == ELEM(0, i));
+    }
+
+    z_task_join(&producer);
+    assert(z_spsc_ring_pull(r) == NULL);
+    z_spsc_ring_free(&r);
+}
+
+z_mpsc_ring_t *mpsc_ring = NULL;
+z_ring_queue_t *queue = NULL;
+
+void *mpsc_produce(void *arg)
+{
+    uintptr_t p = (uintptr_t)arg;
+    for (size_t i = 0; i < RUN; i++)
+    {
+        while (z_mpsc_ring_push(mpsc_ring, ELEM(p, i)) != 0)
+            z_sleep_us(0);
+    }
+    return 0;
+}
+
+void *queue_produce(void *arg)
+{
+    uintptr_t p = (uintptr_t)arg;
+    for (size_t i = 0; i < RUN; i++)
+        z_ring_queue_put(queue, ELEM(p, i));
+    return 0;
+}
+
+void multi_producer_test(void *(*produce)(void *), void *(*get)(void))
+{
+    size_t expected[PRODUCERS] = {0};
+    z_task_t producers[PRODUCERS];
+    for (uintptr_t p = 0; p < PRODUCERS; p++)
+        z_task_init(&producers[p], NULL, produce, (void *)p);
+
+    // Elements of each producer are received in order
+    for (size_t n = 0; n < PRODUCERS * RUN; n++)
+    {
+        void *e = get();
+        size_t p = ELEM_PRODUCER(e);
+        assert(p < PRODUCERS);
+        assert(ELEM_SEQ(e) == expected[p]);
+        expected[p]++;
+    }
+
+    for (size_t p = 0; p < PRODUCERS; p++)
+    {
+        z_task_join(&producers[p]);
+        assert(expected[p] == RUN);
+    }
+}
+
+void *mpsc_ring_get(void)
+{
+    void *e;
+    while ((e = z_mpsc_ring_pull(mpsc_ring)) == NULL)
+        z_sleep_us(0);
+    return e;
+}
+
+void *queue_get(void)
+{
+    return z_ring_queue_get(queue);
+}
+
+int main(void)
+{
+    spsc_ring_test();
+    mpsc_ring_test();
+    spsc_ring_concurrent_test();
+
+    mpsc_ring = z_mpsc_ring_make(16);
+    multi_producer_test(mpsc_produce, mpsc_ring_get);
+    assert(z_mpsc_ring_pull(mpsc_ring) == NULL);
+    z_mpsc_ring_free(&mpsc_ring);
+
+    // A small queue makes both the producers and the consumer block
+    queue = z_ring_queue_make(2);
+    assert(z_ring_queue_try_get(queue) == NULL);
+    assert(z_ring_queue_try_put(queue, ELEM(0, 0)) == 0);
+    assert(z_ring_queue_try_put(queue, ELEM(0, 1)) == 0);
+    assert(z_ring_queue_try_put(queue, ELEM(0, 2)) == -1);
+    assert(z_ring_queue_get(queue) == ELEM(0, 0));
+    assert(z_ring_queue_get(queue) == ELEM(0, 1));
+    multi_producer_test(queue_produce, queue_get);
+    assert(z_ring_queue_try_get(queue) == NULL);
+    z_ring_queue_free(&queue);
+    assert(queue == NULL);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include "zenoh-pico/protocol/codec.h"
+#include "zenoh-pico/system/platform.h"
+
+#define VALUES_NUM 4096
+#define ROUNDS 1000
+
+// Reference byte-at-a-time codec, as it was before the fast paths
+int ref_zint_encode(_z_wbuf_t *wbf, z_zint_t v)
+{
+    while (v > 0x7f)
+    {
+        uint8_t c = (v & 0x7f) | 0x80;
+        _ZN_EC(_z_wbuf_write(wbf, (uint8_t)c))
+        v = v >> 7;
+    }
+    return _z_wbuf_write(wbf, (uint8_t)v);
+}
+
+_z_zint_result_t ref_zint_decode(_z_zbuf_t *zbf)
+{
+    _z_zint_result_t r;
+    r.tag = _z_res_t_OK;
+    r.value.zint = 0;
+
+    int i = 0;
+    _z_uint8_result_t r_uint8;
+    do
+    {
+        r_uint8 = _z_uint8_decode(zbf);
+        _ASSURE_RESULT(r_uint8, r, _z_err_t_PARSE_ZINT);
+
+        r.value.zint = r.value.zint | (((z_zint_t)r_uint8.value.uint8 & 0x7f) << i);
+        i += 7;
+    } while (r_uint8.value.uint8 > 0x7f);
+
+    return r;
+}
+
+void report(const char *name, z_clock_t *start)
+{
+    unsigned long us = z_clock_elapsed_us(start);
+    size_t ops = (size_t)VALUES_NUM * ROUNDS;
+    printf("%-20s %8lu us %8.2f ns/zint\n", name, us, (us * 1000.0) / ops);
+}
+
+void run(const char *name, const z_zint_t *values)
+{
+    char label[32];
+    _z_wbuf_t wbf = _z_wbuf_make(VALUES_NUM * 10, 0);
+    z_clock_t start;
+
+    start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        _z_wbuf_reset(&wbf);
+        for (size_t i = 0; i < VALUES_NUM; i++)
+            ref_zint_encode(&wbf, values[i]);
+    }
+    snprintf(label, sizeof(label), "%s/encode/ref", name);
+    report(label, &start);
+
+    start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        _z_wbuf_reset(&wbf);
+        for (size_t i = 0; i < VALUES_NUM; i++)
+            _z_zint_encode(&wbf, values[i]);
+    }
+    snprintf(label, sizeof(label), "%s/encode/fast", name);
+    report(label, &start);
+
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+    volatile z_zint_t sink = 0;
+
+    start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        _z_zbuf_set_rpos(&zbf, 0);
+        for (size_t i = 0; i < VALUES_NUM; i++)
+            sink += ref_zint_decode(&zbf).value.zint;
+    }
+    snprintf(label, sizeof(label), "%s/decode/ref", name);
+    report(label, &start);
+
+    start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        _z_zbuf_set_rpos(&zbf, 0);
+        for (size_t i = 0; i < VALUES_NUM; i++)
+            sink += _z_zint_decode(&zbf).value.zint;
+    }
+    snprintf(label, sizeof(label), "%s/decode/fast", name);
+    report(label, &start);
+    (void)(sink);
+
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+}
+
+int main(void)
+{
+    z_zint_t values[VALUES_NUM];
+
+    printf("Encoding and decoding %d zints %d times\n", VALUES_NUM, ROUNDS);
+
+    // Headers, ids and short lengths: one byte on the wire
+    for (size_t i = 0; i < VALUES_NUM; i++)
+        values[i] = z_random_u8() & 0x7f;
+    run("1-byte", values);
+
+    // Sequence numbers and payload lengths: two or three bytes on the wire
+    for (size_t i = 0; i < VALUES_NUM; i++)
+        values[i] = 0x80 + (z_random_u32() % 0x1fff80);
+    run("2-3-bytes", values);
+
+    // Mix of all the lengths up to 8 bytes on the wire
+    for (size_t i = 0; i < VALUES_NUM; i++)
+        values[i] = (z_zint_t)(((uint64_t)z_random_u32() << 32 | z_random_u32()) >> (8 + 7 * (i % 8)));
+    run("mixed", values);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 8192
+#define MAX_FRAMES 1024
+#define LARGE 100000
+#define OVERSIZED (ZN_FRAG_MAX_SIZE + 1)
+
+uint8_t payload[OVERSIZED];
+
+// Frames written on the link of the publishing session
+zn_test_frames_t frames;
+
+// Samples delivered to the subscriber of the receiving session
+size_t delivered = 0;
+size_t delivered_len = 0;
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(strncmp(sample->key.val, "/a/b", sample->key.len) == 0);
+    assert(memcmp(sample->value.val, payload, sample->value.len) == 0);
+    delivered++;
+    delivered_len = sample->value.len;
+}
+
+void publish(zn_session_t *zn, size_t len)
+{
+    zn_test_frames_reset(&frames);
+    assert(zn_test_publish(zn, payload, len, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+}
+
+void test_defrag_buf(void)
+{
+    printf(">>> Testing defragmentation buffer\n");
+
+    // No memory is allocated until the first fragment is received
+    _zn_defrag_buf_t dbuf;
+    _zn_defrag_buf_init(&dbuf);
+    assert(_z_zbuf_capacity(&dbuf.zbf) == 0);
+
+    size_t len = 0;
+    while (len + MTU <= LARGE)
+    {
+        z_bytes_t fragment = _z_bytes_wrap(payload + len, MTU);
+        assert(_zn_defrag_buf_push(&dbuf, &fragment) == 0);
+        len += MTU;
+    }
+    assert(_z_zbuf_len(&dbuf.zbf) == len);
+    assert(memcmp(_z_zbuf_get_rptr(&dbuf.zbf), payload, len) == 0);
+
+    _zn_defrag_buf_t copy;
+    _zn_defrag_buf_copy(&copy, &dbuf);
+    assert(_z_zbuf_len(&copy.zbf) == len);
+    assert(memcmp(_z_zbuf_get_rptr(&copy.zbf), payload, len) == 0);
+    _zn_defrag_buf_clear(&copy);
+    assert(_z_zbuf_capacity(&copy.zbf) == 0);
+
+    _zn_defrag_buf_reset(&dbuf);
+    assert(_z_zbuf_len(&dbuf.zbf) == 0);
+
+    // Oversized messages are dropped until the buffer is reset
+    z_bytes_t fragment = _z_bytes_wrap(payload, OVERSIZED);
+    assert(_zn_defrag_buf_push(&dbuf, &fragment) == -1);
+    fragment = _z_bytes_wrap(payload, 1);
+    assert(_zn_defrag_buf_push(&dbuf, &fragment) == -1);
+    assert(dbuf.is_dropping == 1);
+    _zn_defrag_buf_reset(&dbuf);
+    assert(dbuf.is_dropping == 0);
+    assert(_zn_defrag_buf_push(&dbuf, &fragment) == 0);
+
+    _zn_defrag_buf_clear(&dbuf);
+}
+
+void test_transport(void)
+{
+    printf(">>> Testing reassembly on the transport\n");
+
+    zn_test_frames_init(&frames, 2 * OVERSIZED, MAX_FRAMES);
+    zn_session_t *pub = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(1));
+    zn_session_t *sub = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(0));
+    zn_test_subscribe(sub, "/a/*", data_handler, NULL);
+
+    // Fragmented messages are reassembled and delivered
+    publish(pub, LARGE);
+    assert(frames.len > 1);
+    zn_test_deliver(sub, &frames, 0, frames.len);
+    assert(delivered == 1);
+    assert(delivered_len == LARGE);
+
+    // Messages missing a fragment are not delivered, the reassembly restarts with the next message
+    publish(pub, LARGE);
+    zn_test_deliver(sub, &frames, 0, 1);
+    zn_test_deliver(sub, &frames, 2, frames.len);
+    assert(delivered == 1);
+
+    publish(pub, LARGE);
+    zn_test_deliver(sub, &frames, 0, frames.len);
+    assert(delivered == 2);
+
+    // Oversized messages are dropped, and do not prevent the following ones to be delivered
+    publish(pub, OVERSIZED);
+    zn_test_deliver(sub, &frames, 0, frames.len);
+    assert(delivered == 2);
+
+    publish(pub, LARGE);
+    zn_test_deliver(sub, &frames, 0, frames.len);
+    assert(delivered == 3);
+
+    zn_test_session_free(sub);
+    zn_test_session_free(pub);
+    zn_test_frames_clear(&frames);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < OVERSIZED; i++)
+        payload[i] = (uint8_t)(i % 251);
+
+    test_defrag_buf();
+    test_transport();
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/api/session.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/session/utils.h"
+
+#define KEYS 8
+#define SAMPLES 1000
+#define WORKERS 3
+
+// Each key is always delivered by the same worker, no need for synchronization
+size_t expected[KEYS];
+
+void ordered_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(sample->key.len == 4);
+    size_t k = (size_t)(sample->key.val[3] - '0');
+    assert(k < KEYS);
+
+    uint32_t seq;
+    assert(sample->value.len == sizeof(seq));
+    memcpy(&seq, sample->value.val, sizeof(seq));
+
+    // Samples for the same resource name are delivered in order
+    assert(seq == expected[k]);
+    expected[k]++;
+}
+
+void test_order(void)
+{
+    zn_session_t *zn = _zn_session_init();
+
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(sub, 0, sizeof(_zn_subscriber_t));
+    sub->id = 1;
+    sub->rname = _z_str_clone("/a/*");
+    sub->callback = ordered_handler;
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+
+    assert(znp_stop_dispatch_pool(zn) == -1);
+    assert(znp_start_dispatch_pool(zn, 0) == -1);
+    assert(znp_start_dispatch_pool(zn, WORKERS) == 0);
+    assert(znp_start_dispatch_pool(zn, WORKERS) == -1);
+
+    char rname[] = "/a/0";
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = rname;
+
+    uint32_t seq;
+    z_bytes_t payload = _z_bytes_wrap((const uint8_t *)&seq, sizeof(seq));
+
+    for (seq = 0; seq < SAMPLES; seq++)
+    {
+        for (size_t k = 0; k < KEYS; k++)
+        {
+            rname[3] = (char)('0' + k);
+            res = _zn_trigger_subscriptions(zn, key, payload);
+            assert(res == 0);
+        }
+    }
+
+    // The pending samples are delivered before the pool stops
+    assert(znp_stop_dispatch_pool(zn) == 0);
+    for (size_t k = 0; k < KEYS; k++)
+        assert(expected[k] == SAMPLES);
+
+    // Without the pool, samples are delivered by the caller
+    rname[3] = '0';
+    seq = SAMPLES;
+    res = _zn_trigger_subscriptions(zn, key, payload);
+    assert(res == 0);
+    assert(expected[0] == SAMPLES + 1);
+
+    // Closing the session stops the pool
+    assert(znp_start_dispatch_pool(zn, WORKERS) == 0);
+    _zn_session_free(&zn);
+}
+
+volatile size_t slow_calls = 0;
+
+void slow_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    slow_calls++;
+    z_sleep_ms(10);
+}
+
+void test_undeclare_queued(void)
+{
+    zn_session_t *zn = _zn_session_init();
+
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(sub, 0, sizeof(_zn_subscriber_t));
+    sub->id = 1;
+    sub->rname = _z_str_clone("/a/0");
+    sub->callback = slow_handler;
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+    assert(znp_start_dispatch_pool(zn, 1) == 0);
+
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/a/0";
+    z_bytes_t payload;
+    _z_bytes_reset(&payload);
+
+    for (size_t i = 0; i < ZN_DISPATCH_QUEUE_SIZE; i++)
+    {
+        res = _zn_trigger_subscriptions(zn, key, payload);
+        assert(res == 0);
+    }
+
+    // The samples still queued are not delivered once the subscription is undeclared
+    _zn_unregister_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    size_t calls = slow_calls;
+    assert(znp_stop_dispatch_pool(zn) == 0);
+    assert(slow_calls == calls);
+    assert(calls < ZN_DISPATCH_QUEUE_SIZE);
+
+    _zn_session_free(&zn);
+}
+
+size_t counted = 0;
+volatile int triggering = 0;
+
+void count_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    counted++;
+}
+
+void *trigger_task(void *arg)
+{
+    zn_session_t *zn = (zn_session_t *)arg;
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/a/0";
+    z_bytes_t payload;
+    _z_bytes_reset(&payload);
+
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        int res = _zn_trigger_subscriptions(zn, key, payload);
+        assert(res == 0);
+    }
+    triggering = 0;
+
+    return 0;
+}
+
+void test_concurrent_stop(void)
+{
+    zn_session_t *zn = _zn_session_init();
+
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(sub, 0, sizeof(_zn_subscriber_t));
+    sub->id = 1;
+    sub->rname = _z_str_clone("/a/0");
+    sub->callback = count_handler;
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+
+    // The pool is started and stopped while samples are being received
+    triggering = 1;
+    z_task_t task;
+    z_task_init(&task, NULL, trigger_task, zn);
+    while (triggering)
+    {
+        assert(znp_start_dispatch_pool(zn, 1) == 0);
+        assert(znp_stop_dispatch_pool(zn) == 0);
+    }
+    z_task_join(&task);
+
+    // Each sample is delivered exactly once, either by the pool or by the caller
+    assert(counted == SAMPLES);
+
+    _zn_session_free(&zn);
+}
+
+int main(void)
+{
+    test_order();
+    test_undeclare_queued();
+    test_concurrent_stop();
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/session/utils.h"
+
+zn_session_t *zn = NULL;
+_zn_subscriber_t *sibling = NULL;
+size_t delivered = 0;
+size_t sibling_delivered = 0;
+
+_zn_subscriber_t *make_subscriber(z_zint_t id, const char *rname, zn_data_handler_t callback, void *arg)
+{
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(sub, 0, sizeof(_zn_subscriber_t));
+    sub->id = id;
+    sub->rname = _z_str_clone((z_str_t)rname);
+    sub->callback = callback;
+    sub->arg = arg;
+    return sub;
+}
+
+void other_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+}
+
+void sibling_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    sibling_delivered++;
+}
+
+void reentrant_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(strncmp(sample->key.val, "/a/b", sample->key.len) == 0);
+    delivered++;
+
+    // Callbacks run without the session lock: they can call back into the session
+    _zn_subscriber_t *other = make_subscriber(100 + delivered, "/x/y", other_handler, NULL);
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, other);
+    assert(res == 0);
+    _zn_unregister_subscription(zn, _ZN_RESOURCE_IS_LOCAL, other);
+
+    // Other subscriptions can be undeclared too, but not the one being dispatched
+    if (delivered == 2)
+        _zn_unregister_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sibling);
+}
+
+void test_reentrant(void)
+{
+    zn = _zn_session_init();
+
+    _zn_subscriber_t *sub = make_subscriber(1, "/a/*", reentrant_handler, NULL);
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+    sibling = make_subscriber(2, "/s/t", sibling_handler, NULL);
+    res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sibling);
+    assert(res == 0);
+
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/a/b";
+    z_bytes_t payload;
+    _z_bytes_reset(&payload);
+
+    zn_reskey_t sibling_key;
+    sibling_key.rid = ZN_RESOURCE_ID_NONE;
+    sibling_key.rname = "/s/t";
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        res = _zn_trigger_subscriptions(zn, key, payload);
+        assert(res == 0);
+        _zn_trigger_subscriptions(zn, sibling_key, payload);
+    }
+
+    // No more samples are delivered to the sibling once undeclared
+    assert(delivered == 4);
+    assert(sibling_delivered == 1);
+
+    _zn_session_free(&zn);
+}
+
+typedef struct
+{
+    volatile int started;
+    volatile int finished;
+    size_t calls;
+} slow_arg_t;
+
+void slow_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    slow_arg_t *state = (slow_arg_t *)arg;
+    state->calls++;
+    state->started = 1;
+    z_sleep_ms(100);
+    state->finished = 1;
+}
+
+void *trigger_task(void *arg)
+{
+    (void)(arg);
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/c/d";
+    z_bytes_t payload;
+    _z_bytes_reset(&payload);
+
+    int res = _zn_trigger_subscriptions(zn, key, payload);
+    assert(res == 0);
+    return 0;
+}
+
+void test_concurrent_undeclare(void)
+{
+    zn = _zn_session_init();
+
+    slow_arg_t *state = (slow_arg_t *)z_malloc(sizeof(slow_arg_t));
+    memset(state, 0, sizeof(slow_arg_t));
+    _zn_subscriber_t *sub = make_subscriber(1, "/c/*", slow_handler, state);
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+
+    z_task_t task;
+    z_task_init(&task, NULL, trigger_task, NULL);
+    while (!state->started)
+        z_sleep_ms(1);
+
+    // Undeclaring returns only once the callback in progress has returned
+    _zn_unregister_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(state->finished);
+    z_task_join(&task);
+
+    // The argument can be released, the callback is no longer invoked
+    z_free(state);
+    trigger_task(NULL);
+
+    _zn_session_free(&zn);
+}
+
+void test_concurrent_flush(void)
+{
+    zn = _zn_session_init();
+
+    slow_arg_t *state = (slow_arg_t *)z_malloc(sizeof(slow_arg_t));
+    memset(state, 0, sizeof(slow_arg_t));
+    _zn_subscriber_t *sub = make_subscriber(1, "/c/*", slow_handler, state);
+    int res = _zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub);
+    assert(res == 0);
+
+    z_task_t task;
+    z_task_init(&task, NULL, trigger_task, NULL);
+    while (!state->started)
+        z_sleep_ms(1);
+
+    // Flushing the subscriptions of a closing session waits for the callbacks in progress too
+    _zn_flush_subscriptions(zn);
+    assert(state->finished);
+    z_task_join(&task);
+    z_free(state);
+
+    _zn_session_free(&zn);
+}
+
+int main(void)
+{
+    test_reentrant();
+    test_concurrent_undeclare();
+    test_concurrent_flush();
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_alloc.h"
+
+#define RUNS 100
+#define MESSAGES 16
+
+size_t delivered = 0;
+uint8_t expected = 0;
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(strncmp(sample->key.val, "/robot/sensor/temp", sample->key.len) == 0);
+    assert(sample->value.len == 1);
+    // Messages are delivered in the order they have been framed
+    assert(sample->value.val[0] == expected);
+    expected = (expected + 1) % MESSAGES;
+    delivered++;
+}
+
+int handle_visitor(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    assert(_zn_handle_zenoh_message((zn_session_t *)arg, z_msg) == _z_res_t_OK);
+    return 0;
+}
+
+int count_visitor(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    (void)(z_msg);
+    size_t *visited = (size_t *)arg;
+    (*visited)++;
+    return 0;
+}
+
+int stop_visitor(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    count_visitor(z_msg, arg);
+    return *(size_t *)arg == 3 ? 1 : 0;
+}
+
+int main(void)
+{
+    if (ZN_TEST_ALLOC_COUNTED == 0)
+    {
+        printf("Allocation counting is only supported with glibc, skipping\n");
+        return 0;
+    }
+
+    zn_session_t *zn = zn_test_alloc_session_make(data_handler);
+
+    // Serialize a FRAME batching MESSAGES DATA messages on a numerical resource id
+    uint8_t payload[MESSAGES];
+    _zn_frame_payload_t fp;
+    fp.messages = _zn_zenoh_message_vec_make(MESSAGES);
+    for (uint8_t i = 0; i < MESSAGES; i++)
+    {
+        payload[i] = i;
+        zn_reskey_t key;
+        key.rid = ZN_TEST_ALLOC_RID;
+        key.rname = NULL;
+        _zn_data_info_t info;
+        memset(&info, 0, sizeof(_zn_data_info_t));
+        _zn_zenoh_message_t *z_msg = (_zn_zenoh_message_t *)z_malloc(sizeof(_zn_zenoh_message_t));
+        *z_msg = _zn_z_msg_make_data(key, info, _z_bytes_wrap(&payload[i], 1), 1);
+        _zn_zenoh_message_vec_append(&fp.messages, z_msg);
+    }
+    _zn_transport_message_t t_msg = _zn_t_msg_make_frame(7, fp, 1, 0, 0);
+
+    _z_wbuf_t wbf = _z_wbuf_make(ZN_BATCH_SIZE, 0);
+    assert(_zn_transport_message_encode(&wbf, &t_msg) == 0);
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+
+    // The eager decode allocates every message of the frame
+    zn_test_heap_ops = 0;
+    _zn_transport_message_result_t r = _zn_transport_message_decode(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    assert(r.value.transport_message.body.frame.is_lazy == 0);
+    assert(_zn_zenoh_message_vec_len(&r.value.transport_message.body.frame.payload.messages) == MESSAGES);
+    _zn_t_msg_clear(&r.value.transport_message);
+    size_t eager_ops = zn_test_heap_ops;
+    assert(eager_ops > MESSAGES);
+
+    // A visitor can stop the iteration early
+    _z_zbuf_set_rpos(&zbf, 0);
+    r = _zn_transport_message_decode_lazy(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    size_t visited = 0;
+    assert(_zn_frame_messages_decode(&r.value.transport_message.body.frame, stop_visitor, &visited) == 1);
+    assert(visited == 3);
+    _zn_t_msg_clear(&r.value.transport_message);
+
+    // The lazy decode hands the messages to the session without any allocation
+    for (size_t i = 0; i <= RUNS; i++)
+    {
+        // The first frame warms up the dispatch cache
+        if (i == 1)
+            zn_test_heap_ops = 0;
+
+        _z_zbuf_set_rpos(&zbf, 0);
+        r = _zn_transport_message_decode_lazy(&zbf);
+        assert(r.tag == _z_res_t_OK);
+        _zn_frame_t *frame = &r.value.transport_message.body.frame;
+        assert(frame->is_lazy == 1);
+        assert(frame->sn == 7);
+        assert(_zn_frame_messages_decode(frame, handle_visitor, zn) == 0);
+        _zn_t_msg_clear(&r.value.transport_message);
+    }
+
+    size_t lazy_ops = zn_test_heap_ops;
+    printf("Delivered %zu samples, %zu heap operations per eager frame, %zu in steady state with lazy frames\n", delivered, eager_ops, lazy_ops);
+    assert(delivered == (RUNS + 1) * MESSAGES);
+    assert(lazy_ops == 0);
+
+    // Truncated frames are reported as decoding errors
+    _z_zbuf_set_rpos(&zbf, 0);
+    _z_zbuf_set_wpos(&zbf, _z_zbuf_get_wpos(&zbf) - 1);
+    r = _zn_transport_message_decode_lazy(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    visited = 0;
+    assert(_zn_frame_messages_decode(&r.value.transport_message.body.frame, count_visitor, &visited) == -1);
+    assert(visited == MESSAGES - 1);
+    _zn_t_msg_clear(&r.value.transport_message);
+
+    _zn_t_msg_clear(&t_msg);
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+    _zn_session_free(&zn);
+
+    return 0;
+}
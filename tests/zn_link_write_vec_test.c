@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "zenoh-pico/link/link.h"
+#include "zenoh-pico/protocol/iobuf.h"
+
+#define PAYLOAD 1000
+
+uint8_t out[4 * PAYLOAD];
+size_t out_len = 0;
+size_t calls = 0;
+size_t max_write = SIZE_MAX;
+
+size_t test_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    (void)(arg);
+    memcpy(out + out_len, ptr, len);
+    out_len += len;
+    calls++;
+    return len;
+}
+
+size_t test_write_vec(const void *arg, const z_bytes_t *bufs, size_t n)
+{
+    (void)(arg);
+    assert(n <= ZN_LINK_WRITE_VEC_SIZE);
+    calls++;
+
+    // Simulate partial writes of a congested stream
+    size_t wb = 0;
+    for (size_t i = 0; i < n && wb < max_write; i++)
+    {
+        size_t len = bufs[i].len < max_write - wb ? bufs[i].len : max_write - wb;
+        memcpy(out + out_len, bufs[i].val, len);
+        out_len += len;
+        wb += len;
+    }
+    return wb;
+}
+
+// Build a buffer of several slices with a wrapped payload in the middle
+_z_wbuf_t make_wbuf(uint8_t *payload, size_t *len)
+{
+    _z_wbuf_t wbf = _z_wbuf_make(ZN_IOSLICE_SIZE, 1);
+    *len = 0;
+    for (uint8_t i = 0; i < 200; i++, (*len)++)
+        _z_wbuf_write(&wbf, i);
+    _z_wbuf_wrap_bytes(&wbf, payload, 0, PAYLOAD);
+    *len += PAYLOAD;
+    for (uint8_t i = 0; i < 10; i++, (*len)++)
+        _z_wbuf_write(&wbf, i);
+    return wbf;
+}
+
+void check_output(const uint8_t *payload, size_t len)
+{
+    assert(out_len == len);
+    for (size_t i = 0; i < 200; i++)
+        assert(out[i] == (uint8_t)i);
+    assert(memcmp(out + 200, payload, PAYLOAD) == 0);
+    for (size_t i = 0; i < 10; i++)
+        assert(out[200 + PAYLOAD + i] == (uint8_t)i);
+}
+
+int main(void)
+{
+    uint8_t payload[PAYLOAD];
+    for (size_t i = 0; i < PAYLOAD; i++)
+        payload[i] = (uint8_t)(i * 7);
+
+    _zn_link_t link;
+    memset(&link, 0, sizeof(link));
+    link.write_f = test_write;
+    link.write_all_f = test_write;
+    link.is_streamed = 1;
+
+    size_t len;
+    _z_wbuf_t wbf = make_wbuf(payload, &len);
+    assert(_z_wbuf_len_iosli(&wbf) > 2);
+
+    // Without gather writes, each slice is written separately
+    assert(_zn_link_send_wbuf(&link, &wbf) == 0);
+    check_output(payload, len);
+    assert(calls == _z_wbuf_len_iosli(&wbf));
+
+    // With gather writes, the whole buffer is written at once
+    link.write_vec_f = test_write_vec;
+    out_len = 0;
+    calls = 0;
+    assert(_zn_link_send_wbuf(&link, &wbf) == 0);
+    check_output(payload, len);
+    assert(calls == 1);
+
+    // Partial writes are resumed from the right slice and offset
+    max_write = 7;
+    out_len = 0;
+    calls = 0;
+    assert(_zn_link_send_wbuf(&link, &wbf) == 0);
+    check_output(payload, len);
+    assert(calls == (len + 6) / 7);
+    max_write = SIZE_MAX;
+    _z_wbuf_clear(&wbf);
+
+    // Buffers with more slices than ZN_LINK_WRITE_VEC_SIZE take several writes
+    wbf = _z_wbuf_make(ZN_IOSLICE_SIZE, 1);
+    for (size_t i = 0; i < 2 * ZN_LINK_WRITE_VEC_SIZE; i++)
+        _z_wbuf_wrap_bytes(&wbf, payload + i, 0, 1);
+    out_len = 0;
+    calls = 0;
+    assert(_zn_link_send_wbuf(&link, &wbf) == 0);
+    assert(out_len == 2 * ZN_LINK_WRITE_VEC_SIZE);
+    assert(memcmp(out, payload, out_len) == 0);
+    assert(calls == 2);
+
+    // On datagram links, such buffers are coalesced and sent in a single write
+    link.is_streamed = 0;
+    out_len = 0;
+    calls = 0;
+    assert(_zn_link_send_wbuf(&link, &wbf) == 0);
+    assert(out_len == 2 * ZN_LINK_WRITE_VEC_SIZE);
+    assert(memcmp(out, payload, out_len) == 0);
+    assert(calls == 1);
+    _z_wbuf_clear(&wbf);
+
+    // The same goes for the datagram links without gather writes
+    link.write_vec_f = NULL;
+    z_bytes_t slices[2 * ZN_LINK_WRITE_VEC_SIZE];
+    for (size_t i = 0; i < 2 * ZN_LINK_WRITE_VEC_SIZE; i++)
+        slices[i] = _z_bytes_wrap(payload + 2 * i, 2);
+    out_len = 0;
+    calls = 0;
+    assert(_zn_link_send_vec(&link, slices, 2 * ZN_LINK_WRITE_VEC_SIZE) == 0);
+    assert(out_len == 4 * ZN_LINK_WRITE_VEC_SIZE);
+    assert(memcmp(out, payload, out_len) == 0);
+    assert(calls == 1);
+
+#if ZN_LINK_TCP == 1 && Z_LINK_WRITE_VEC == 1
+    // Gather writes on a stream socket
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    z_bytes_t bufs[3];
+    bufs[0] = _z_bytes_wrap(payload, 10);
+    bufs[1] = _z_bytes_wrap(payload + 500, 20);
+    bufs[2] = _z_bytes_wrap(payload + 990, 10);
+    assert(_zn_send_vec_tcp(fds[0], bufs, 3) == 40);
+    uint8_t in[40];
+    assert(_zn_read_exact_tcp(fds[1], in, 40) == 40);
+    assert(memcmp(in, payload, 10) == 0);
+    assert(memcmp(in + 10, payload + 500, 20) == 0);
+    assert(memcmp(in + 30, payload + 990, 10) == 0);
+    close(fds[0]);
+    close(fds[1]);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,378 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "zenoh-pico.h"
+#include "zenoh-pico/link/manager.h"
+#include "zenoh-pico/session/utils.h"
+
+// Results are printed as CSV, one line per transport, batching mode, test and payload size.
+// Throughput lines fill msgs_per_s and mb_per_s, latency lines the round-trip percentiles.
+//
+// Usage: zn_loopback_bench [multicast locator], by default udp/224.0.0.224:7447#iface=lo.
+// The multicast measurements are skipped when the two sessions can not reach each other.
+
+#define DEFAULT_MULTICAST_LOCATOR "udp/224.0.0.224:7447#iface=lo"
+
+#define THR_TARGET_BYTES (32 * 1024 * 1024)
+#define THR_MIN_MSGS 1000
+#define THR_MAX_MSGS 20000
+#define BATCH_MSGS 64
+#define LAT_ROUNDS 1000
+
+// Time to wait for a message before considering it lost
+#define TIMEOUT_US 2000000
+
+typedef enum
+{
+    BATCHING_NONE,
+    BATCHING_SCOPE,
+    BATCHING_WRITE_TASK,
+} batching_t;
+
+const char *batching_names[] = {"none", "scope", "write_task"};
+
+typedef struct
+{
+    const char *name;
+    zn_session_t *pub;
+    zn_session_t *sub;
+} bench_t;
+
+uint8_t *payload;
+volatile size_t received = 0;
+
+// Keys for publications, that do not take ownership of the resource name
+zn_reskey_t pub_key(z_str_t rname)
+{
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = rname;
+    return key;
+}
+
+void thr_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    received++;
+}
+
+void ping_handler(const zn_sample_t *sample, const void *arg)
+{
+    zn_session_t *zn = (zn_session_t *)arg;
+    zn_write(zn, pub_key("/bench/pong"), sample->value.val, sample->value.len);
+}
+
+void pong_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    received++;
+}
+
+// Wait for the expected messages, giving up when no progress is made for TIMEOUT_US
+int wait_received(size_t expected)
+{
+    size_t last = received;
+    z_clock_t progress = z_clock_now();
+    while (received < expected)
+    {
+        if (received != last)
+        {
+            last = received;
+            progress = z_clock_now();
+        }
+        else if (z_clock_elapsed_us(&progress) > TIMEOUT_US)
+            return -1;
+        z_sleep_us(0);
+    }
+    return 0;
+}
+
+int cmp_ulong(const void *l, const void *r)
+{
+    unsigned long a = *(const unsigned long *)l;
+    unsigned long b = *(const unsigned long *)r;
+    return (a > b) - (a < b);
+}
+
+void set_batching(bench_t *b, batching_t batching, int enable)
+{
+    if (batching != BATCHING_WRITE_TASK)
+        return;
+
+    if (enable)
+    {
+        znp_start_write_task(b->pub);
+        znp_start_write_task(b->sub);
+    }
+    else
+    {
+        znp_stop_write_task(b->pub);
+        znp_stop_write_task(b->sub);
+    }
+}
+
+void measure_thr(bench_t *b, batching_t batching, size_t len)
+{
+    size_t msgs = THR_TARGET_BYTES / len;
+    if (msgs < THR_MIN_MSGS)
+        msgs = THR_MIN_MSGS;
+    if (msgs > THR_MAX_MSGS)
+        msgs = THR_MAX_MSGS;
+
+    zn_subscriber_t *sub = zn_declare_subscriber(b->sub, zn_rname("/bench/thr"), zn_subinfo_default(), thr_handler, NULL);
+    set_batching(b, batching, 1);
+    z_sleep_ms(100);
+
+    received = 0;
+    z_clock_t start = z_clock_now();
+    for (size_t i = 0; i < msgs; i++)
+    {
+        if (batching == BATCHING_SCOPE && i % BATCH_MSGS == 0)
+            znp_batch_start(b->pub);
+
+        zn_write_ext(b->pub, pub_key("/bench/thr"), payload, len, 0, 0, zn_congestion_control_t_BLOCK);
+
+        if (batching == BATCHING_SCOPE && (i % BATCH_MSGS == BATCH_MSGS - 1 || i == msgs - 1))
+            znp_batch_flush(b->pub);
+    }
+    wait_received(msgs);
+    unsigned long us = z_clock_elapsed_us(&start);
+    size_t delivered = received;
+
+    set_batching(b, batching, 0);
+    zn_undeclare_subscriber(sub);
+
+    double msgs_per_s = us > 0 ? (delivered * 1000000.0) / us : 0.0;
+    double mb_per_s = us > 0 ? ((double)delivered * len) / us : 0.0;
+    printf("%s,%s,thr,%zu,%zu,%.0f,%.1f,,,,%zu\n", b->name, batching_names[batching], len, msgs, msgs_per_s, mb_per_s, msgs - delivered);
+}
+
+void measure_lat(bench_t *b, batching_t batching, size_t len)
+{
+    unsigned long rtts[LAT_ROUNDS];
+    size_t samples = 0;
+
+    zn_subscriber_t *ping = zn_declare_subscriber(b->sub, zn_rname("/bench/ping"), zn_subinfo_default(), ping_handler, b->sub);
+    zn_subscriber_t *pong = zn_declare_subscriber(b->pub, zn_rname("/bench/pong"), zn_subinfo_default(), pong_handler, NULL);
+    set_batching(b, batching, 1);
+    z_sleep_ms(100);
+
+    received = 0;
+    for (size_t i = 0; i < LAT_ROUNDS; i++)
+    {
+        // Late pongs of lost rounds are not taken into account
+        size_t expected = received + 1;
+        z_clock_t start = z_clock_now();
+        zn_write(b->pub, pub_key("/bench/ping"), payload, len);
+        if (wait_received(expected) == 0)
+            rtts[samples++] = z_clock_elapsed_us(&start);
+        else
+            received = expected;
+    }
+
+    set_batching(b, batching, 0);
+    zn_undeclare_subscriber(pong);
+    zn_undeclare_subscriber(ping);
+
+    if (samples == 0)
+    {
+        printf("%s,%s,lat,%zu,%d,,,,,,%d\n", b->name, batching_names[batching], len, LAT_ROUNDS, LAT_ROUNDS);
+        return;
+    }
+
+    qsort(rtts, samples, sizeof(unsigned long), cmp_ulong);
+    printf("%s,%s,lat,%zu,%d,,,%lu,%lu,%lu,%zu\n", b->name, batching_names[batching], len, LAT_ROUNDS,
+           rtts[samples / 2], rtts[(samples * 99) / 100], rtts[(samples * 999) / 1000], LAT_ROUNDS - samples);
+}
+
+void run(bench_t *b, const size_t *sizes, size_t sizes_num)
+{
+    for (int batching = BATCHING_NONE; batching <= BATCHING_WRITE_TASK; batching++)
+    {
+        for (size_t i = 0; i < sizes_num; i++)
+            measure_thr(b, (batching_t)batching, sizes[i]);
+
+        // Batch scopes are flushed after every ping, that is the same as no batching
+        if (batching == BATCHING_SCOPE)
+            continue;
+
+        for (size_t i = 0; i < sizes_num; i++)
+            measure_lat(b, (batching_t)batching, sizes[i]);
+    }
+}
+
+/*------------------ Unicast ------------------*/
+// Unicast listening is not supported by the transport layer, hence the bench accepts the TCP
+// connection itself and builds both transports on the connected sockets, without handshake
+zn_session_t *make_unicast_session(_zn_link_t *link)
+{
+    zn_session_t *zn = _zn_session_init();
+
+    _zn_transport_unicast_establish_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.sn_resolution = ZN_SN_RESOLUTION;
+    param.initial_sn_tx = 0;
+    param.initial_sn_rx = ZN_SN_RESOLUTION - 1;
+    param.lease = ZN_TRANSPORT_LEASE;
+    zn->tp = _zn_transport_unicast_new(link, param);
+    zn->tp->transport.unicast.session = zn;
+
+    znp_start_read_task(zn);
+    return zn;
+}
+
+void free_unicast_session(zn_session_t *zn)
+{
+    // Unblock the read task, that is joined when the session is released
+    znp_stop_read_task(zn);
+    shutdown(((_zn_link_t *)zn->tp->transport.unicast.link)->socket.tcp.sock, SHUT_RDWR);
+    _zn_session_free(&zn);
+}
+
+int run_unicast(const size_t *sizes, size_t sizes_num)
+{
+    int lsock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (lsock < 0 || bind(lsock, (struct sockaddr *)&addr, addr_len) < 0 || listen(lsock, 1) < 0 ||
+        getsockname(lsock, (struct sockaddr *)&addr, &addr_len) < 0)
+        goto ERR_1;
+
+    char locator[64];
+    snprintf(locator, sizeof(locator), "tcp/127.0.0.1:%u", ntohs(addr.sin_port));
+
+    _zn_link_p_result_t r_link = _zn_open_link(locator);
+    if (r_link.tag == _z_res_t_ERR)
+        goto ERR_1;
+
+    int sock = accept(lsock, NULL, NULL);
+    if (sock < 0)
+        goto ERR_2;
+
+    _zn_endpoint_result_t r_ep = _zn_endpoint_from_str(locator);
+    _zn_link_t *accepted = _zn_new_link_tcp(r_ep.value.endpoint);
+    accepted->socket.tcp.sock = sock;
+
+    bench_t b;
+    b.name = "tcp";
+    b.pub = make_unicast_session(r_link.value.link);
+    b.sub = make_unicast_session(accepted);
+
+    run(&b, sizes, sizes_num);
+
+    free_unicast_session(b.pub);
+    free_unicast_session(b.sub);
+    close(lsock);
+    return 0;
+
+ERR_2:
+    _zn_link_free(&r_link.value.link);
+ERR_1:
+    if (lsock >= 0)
+        close(lsock);
+    return -1;
+}
+
+/*------------------ Multicast ------------------*/
+zn_session_t *open_multicast_session(z_str_t locator)
+{
+    zn_properties_t *config = zn_config_default();
+    zn_properties_insert(config, ZN_CONFIG_MODE_KEY, z_string_make("peer"));
+    zn_properties_insert(config, ZN_CONFIG_PEER_KEY, z_string_make(locator));
+    zn_session_t *zn = zn_open(config);
+    zn_properties_free(&config);
+    if (zn == NULL)
+        return NULL;
+
+    znp_start_read_task(zn);
+    znp_start_lease_task(zn);
+    return zn;
+}
+
+void close_multicast_session(zn_session_t *zn)
+{
+    znp_stop_lease_task(zn);
+    znp_stop_read_task(zn);
+    zn_close(zn);
+}
+
+int run_multicast(z_str_t locator, const size_t *sizes, size_t sizes_num)
+{
+    bench_t b;
+    b.name = "udp_multicast";
+    b.pub = open_multicast_session(locator);
+    b.sub = open_multicast_session(locator);
+    if (b.pub == NULL || b.sub == NULL)
+        goto ERR;
+
+    // Make sure the sessions can reach each other
+    zn_subscriber_t *probe = zn_declare_subscriber(b.sub, zn_rname("/bench/thr"), zn_subinfo_default(), thr_handler, NULL);
+    received = 0;
+    for (int i = 0; i < 10 && received == 0; i++)
+    {
+        zn_write(b.pub, pub_key("/bench/thr"), payload, 8);
+        z_sleep_ms(100);
+    }
+    zn_undeclare_subscriber(probe);
+    if (received == 0)
+        goto ERR;
+
+    run(&b, sizes, sizes_num);
+
+    close_multicast_session(b.pub);
+    close_multicast_session(b.sub);
+    return 0;
+
+ERR:
+    if (b.pub != NULL)
+        close_multicast_session(b.pub);
+    if (b.sub != NULL)
+        close_multicast_session(b.sub);
+    return -1;
+}
+
+int main(int argc, char **argv)
+{
+    z_str_t locator = argc > 1 ? argv[1] : DEFAULT_MULTICAST_LOCATOR;
+    const size_t sizes[] = {8, 256, 1024, 8192, 32768};
+    const size_t sizes_num = sizeof(sizes) / sizeof(sizes[0]);
+
+    payload = (uint8_t *)z_malloc(sizes[sizes_num - 1]);
+    memset(payload, 1, sizes[sizes_num - 1]);
+
+    printf("transport,batching,test,payload_len,msgs,msgs_per_s,mb_per_s,p50_us,p99_us,p999_us,lost\n");
+
+    if (run_unicast(sizes, sizes_num) != 0)
+        fprintf(stderr, "Unicast loopback unavailable, skipping\n");
+
+    if (run_multicast(locator, sizes, sizes_num) != 0)
+        fprintf(stderr, "Multicast on %s unavailable, skipping\n", locator);
+
+    z_free(payload);
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/utils.h"
+
+// Results are printed as CSV, one line per message kind, operation and payload size:
+// ns_per_msg and allocs_per_msg are per zenoh message, mb_per_s is computed on the wire bytes.
+// allocs_per_msg is -1 when the allocations can not be counted.
+
+// Wire bytes processed by each measurement, bounded by the iteration limits below
+#define TARGET_BYTES (16 * 1024 * 1024)
+#define MIN_ITERS 200
+#define MAX_ITERS 100000
+
+#define FRAME_MESSAGES 16
+#define FRAGMENT_MTU 1024
+#define FRAGMENTS_MAX (ZN_FRAG_MAX_SIZE / FRAGMENT_MTU + 1)
+
+#if defined(__GLIBC__)
+// Count the heap allocations by interposing the libc allocator
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+volatile size_t allocs = 0;
+
+void *malloc(size_t size)
+{
+    allocs++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    allocs++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    allocs++;
+    return __libc_realloc(ptr, size);
+}
+#define ALLOCS_PER_MSG(n, msgs) ((double)(n) / (msgs))
+#else
+volatile size_t allocs = 0;
+#define ALLOCS_PER_MSG(n, msgs) (-1.0)
+#endif
+
+typedef struct
+{
+    _zn_zenoh_message_t z_msg;
+    _zn_transport_message_t t_msg;
+    _z_wbuf_t wbf;
+    _z_zbuf_t zbf;
+
+    // Fragmented messages
+    z_bytes_t serialized;
+    size_t offsets[FRAGMENTS_MAX + 1];
+    size_t fragments;
+    _zn_defrag_buf_t dbuf;
+} bench_t;
+
+typedef void (*bench_op_t)(bench_t *b);
+
+/*------------------ Operations ------------------*/
+void zenoh_message_encode(bench_t *b)
+{
+    _z_wbuf_reset(&b->wbf);
+    int res = _zn_zenoh_message_encode(&b->wbf, &b->z_msg);
+    assert(res == 0);
+    (void)(res);
+}
+
+void zenoh_message_decode(bench_t *b)
+{
+    _z_zbuf_set_rpos(&b->zbf, 0);
+    _zn_zenoh_message_result_t r = _zn_zenoh_message_decode(&b->zbf);
+    assert(r.tag == _z_res_t_OK);
+    _zn_z_msg_clear(&r.value.zenoh_message);
+}
+
+void transport_message_encode(bench_t *b)
+{
+    _z_wbuf_reset(&b->wbf);
+    int res = _zn_transport_message_encode(&b->wbf, &b->t_msg);
+    assert(res == 0);
+    (void)(res);
+}
+
+void transport_message_decode(bench_t *b)
+{
+    _z_zbuf_set_rpos(&b->zbf, 0);
+    _zn_transport_message_result_t r = _zn_transport_message_decode(&b->zbf);
+    assert(r.tag == _z_res_t_OK);
+    _zn_t_msg_clear(&r.value.transport_message);
+}
+
+int noop_visitor(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    (void)(z_msg);
+    (void)(arg);
+    return 0;
+}
+
+void transport_message_decode_lazy(bench_t *b)
+{
+    _z_zbuf_set_rpos(&b->zbf, 0);
+    _zn_transport_message_result_t r = _zn_transport_message_decode_lazy(&b->zbf);
+    assert(r.tag == _z_res_t_OK);
+    int res = _zn_frame_messages_decode(&r.value.transport_message.body.frame, noop_visitor, NULL);
+    assert(res == 0);
+    (void)(res);
+    _zn_t_msg_clear(&r.value.transport_message);
+}
+
+void fragments_encode(bench_t *b)
+{
+    _z_wbuf_reset(&b->wbf);
+    size_t done = 0;
+    for (size_t i = 0; i < b->fragments; i++)
+    {
+        size_t len = b->serialized.len - done < FRAGMENT_MTU ? b->serialized.len - done : FRAGMENT_MTU;
+        _zn_frame_payload_t fp;
+        fp.fragment = _z_bytes_wrap(b->serialized.val + done, len);
+        _zn_transport_message_t t_msg = _zn_t_msg_make_frame(i, fp, 1, 1, i == b->fragments - 1);
+
+        b->offsets[i] = _z_wbuf_len(&b->wbf);
+        int res = _zn_transport_message_encode(&b->wbf, &t_msg);
+        assert(res == 0);
+        (void)(res);
+        done += len;
+    }
+    b->offsets[b->fragments] = _z_wbuf_len(&b->wbf);
+}
+
+void fragments_decode(bench_t *b)
+{
+    for (size_t i = 0; i < b->fragments; i++)
+    {
+        _z_zbuf_t zbf;
+        size_t len = b->offsets[i + 1] - b->offsets[i];
+        zbf.ios = _z_iosli_wrap(_z_zbuf_get_rptr(&b->zbf) + b->offsets[i], len, 0, len);
+
+        _zn_transport_message_result_t r = _zn_transport_message_decode(&zbf);
+        assert(r.tag == _z_res_t_OK);
+        _zn_defrag_buf_push(&b->dbuf, &r.value.transport_message.body.frame.payload.fragment);
+        if (_ZN_HAS_FLAG(r.value.transport_message.header, _ZN_FLAG_T_E))
+        {
+            _zn_zenoh_message_result_t r_zm = _zn_zenoh_message_decode(&b->dbuf.zbf);
+            assert(r_zm.tag == _z_res_t_OK);
+            _zn_z_msg_clear(&r_zm.value.zenoh_message);
+            _zn_defrag_buf_reset(&b->dbuf);
+        }
+        _zn_t_msg_clear(&r.value.transport_message);
+    }
+}
+
+/*------------------ Measurements ------------------*/
+void measure(const char *name, const char *op, size_t payload_len, size_t wire_bytes, size_t msgs, bench_op_t fn, bench_t *b)
+{
+    size_t iters = TARGET_BYTES / wire_bytes;
+    if (iters < MIN_ITERS)
+        iters = MIN_ITERS;
+    if (iters > MAX_ITERS)
+        iters = MAX_ITERS;
+
+    // Warm up the caches and the lazily allocated buffers
+    fn(b);
+
+    size_t allocs_start = allocs;
+    z_clock_t start = z_clock_now();
+    for (size_t i = 0; i < iters; i++)
+        fn(b);
+    unsigned long us = z_clock_elapsed_us(&start);
+    size_t n_allocs = allocs - allocs_start;
+
+    double total_msgs = (double)iters * msgs;
+    double ns_per_msg = (us * 1000.0) / total_msgs;
+    double mb_per_s = us > 0 ? ((double)iters * wire_bytes) / us : 0.0;
+    printf("%s,%s,%zu,%zu,%zu,%zu,%.1f,%.1f,%.2f\n", name, op, payload_len, wire_bytes, msgs, iters,
+           ns_per_msg, mb_per_s, ALLOCS_PER_MSG(n_allocs, total_msgs));
+}
+
+// Encode once to size the wire representation, then measure encoding and decoding
+void run_zenoh_message(const char *name, size_t payload_len, bench_t *b)
+{
+    b->wbf = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
+    zenoh_message_encode(b);
+    b->zbf = _z_wbuf_to_zbuf(&b->wbf);
+    size_t wire_bytes = _z_zbuf_len(&b->zbf);
+
+    measure(name, "encode", payload_len, wire_bytes, 1, zenoh_message_encode, b);
+    measure(name, "decode", payload_len, wire_bytes, 1, zenoh_message_decode, b);
+
+    _z_zbuf_clear(&b->zbf);
+    _z_wbuf_clear(&b->wbf);
+}
+
+zn_reskey_t make_reskey(z_str_t rname)
+{
+    zn_reskey_t key;
+    key.rid = rname == NULL ? 1 : ZN_RESOURCE_ID_NONE;
+    key.rname = rname == NULL ? NULL : _z_str_clone(rname);
+    return key;
+}
+
+_zn_zenoh_message_t make_data(uint8_t *payload, size_t payload_len)
+{
+    _zn_data_info_t info;
+    memset(&info, 0, sizeof(_zn_data_info_t));
+    return _zn_z_msg_make_data(make_reskey(NULL), info, _z_bytes_wrap(payload, payload_len), 1);
+}
+
+int main(void)
+{
+    const size_t sizes[] = {8, 64, 512, 4096};
+    const size_t fragmented_sizes[] = {4096, 16384, 65536};
+
+    uint8_t *payload = (uint8_t *)z_malloc(fragmented_sizes[2]);
+    z_random_fill(payload, fragmented_sizes[2]);
+
+    bench_t b;
+    memset(&b, 0, sizeof(bench_t));
+
+    printf("bench,op,payload_len,wire_bytes,msgs,iters,ns_per_msg,mb_per_s,allocs_per_msg\n");
+
+    // DATA on a numerical resource id
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        b.z_msg = make_data(payload, sizes[i]);
+        run_zenoh_message("data", sizes[i], &b);
+        _zn_z_msg_clear(&b.z_msg);
+    }
+
+    // DECLARE of a resource and a subscriber
+    _zn_declaration_array_t declarations = _zn_declaration_array_make(2);
+    declarations.val[0] = _zn_z_msg_make_declaration_resource(1, make_reskey("/robot/sensor/temp"));
+    declarations.val[1] = _zn_z_msg_make_declaration_subscriber(make_reskey(NULL), zn_subinfo_default());
+    b.z_msg = _zn_z_msg_make_declare(declarations);
+    run_zenoh_message("declare", 0, &b);
+    _zn_z_msg_clear(&b.z_msg);
+
+    // QUERY with a string key and a predicate
+    b.z_msg = _zn_z_msg_make_query(make_reskey("/robot/sensor/**"), _z_str_clone("value>10"), 1, zn_query_target_default(), zn_query_consolidation_default());
+    run_zenoh_message("query", 0, &b);
+    _zn_z_msg_clear(&b.z_msg);
+
+    // FRAME batching FRAME_MESSAGES DATA, decoded both eagerly and lazily
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        _zn_frame_payload_t fp;
+        fp.messages = _zn_zenoh_message_vec_make(FRAME_MESSAGES);
+        for (size_t j = 0; j < FRAME_MESSAGES; j++)
+        {
+            _zn_zenoh_message_t *z_msg = (_zn_zenoh_message_t *)z_malloc(sizeof(_zn_zenoh_message_t));
+            *z_msg = make_data(payload, sizes[i]);
+            _zn_zenoh_message_vec_append(&fp.messages, z_msg);
+        }
+        b.t_msg = _zn_t_msg_make_frame(1, fp, 1, 0, 0);
+
+        b.wbf = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
+        transport_message_encode(&b);
+        b.zbf = _z_wbuf_to_zbuf(&b.wbf);
+        size_t wire_bytes = _z_zbuf_len(&b.zbf);
+
+        measure("frame", "encode", sizes[i], wire_bytes, FRAME_MESSAGES, transport_message_encode, &b);
+        measure("frame", "decode", sizes[i], wire_bytes, FRAME_MESSAGES, transport_message_decode, &b);
+        measure("frame", "decode_lazy", sizes[i], wire_bytes, FRAME_MESSAGES, transport_message_decode_lazy, &b);
+
+        _z_zbuf_clear(&b.zbf);
+        _z_wbuf_clear(&b.wbf);
+        _zn_t_msg_clear(&b.t_msg);
+    }
+
+    // DATA fragmented in FRAGMENT_MTU bytes FRAMEs and reassembled
+    _zn_defrag_buf_init(&b.dbuf);
+    for (size_t i = 0; i < sizeof(fragmented_sizes) / sizeof(fragmented_sizes[0]); i++)
+    {
+        b.z_msg = make_data(payload, fragmented_sizes[i]);
+        _z_wbuf_t fbf = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
+        int res = _zn_zenoh_message_encode(&fbf, &b.z_msg);
+        assert(res == 0);
+        (void)(res);
+        _z_zbuf_t serialized = _z_wbuf_to_zbuf(&fbf);
+        b.serialized = _z_bytes_wrap(_z_zbuf_get_rptr(&serialized), _z_zbuf_len(&serialized));
+        b.fragments = (b.serialized.len + FRAGMENT_MTU - 1) / FRAGMENT_MTU;
+
+        b.wbf = _z_wbuf_make(ZN_FRAG_MAX_SIZE, 0);
+        fragments_encode(&b);
+        b.zbf = _z_wbuf_to_zbuf(&b.wbf);
+        size_t wire_bytes = _z_zbuf_len(&b.zbf);
+
+        measure("fragmented", "encode", fragmented_sizes[i], wire_bytes, 1, fragments_encode, &b);
+        measure("fragmented", "decode", fragmented_sizes[i], wire_bytes, 1, fragments_decode, &b);
+
+        _z_zbuf_clear(&b.zbf);
+        _z_wbuf_clear(&b.wbf);
+        _z_zbuf_clear(&serialized);
+        _z_wbuf_clear(&fbf);
+        _zn_z_msg_clear(&b.z_msg);
+    }
+    _zn_defrag_buf_clear(&b.dbuf);
+
+    z_free(payload);
+
+    return 0;
+}
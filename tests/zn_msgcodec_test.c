@@ -305,6 +305,48 @@ void assert_eq_locator_array(_zn_locator_array_t *left, _zn_locator_array_t *rig
 /*=============================*/
 /*       Message Fields        */
 /*=============================*/
+/*------------------ ZInt field ------------------*/
+void zint_field(void)
+{
+    printf("\n>> ZInt field\n");
+
+    // One value per encoded length, both at the start and at the end of the buffers,
+    // to exercise the direct and the byte-at-a-time paths of the codec
+    for (unsigned int bits = 0; bits < 8 * sizeof(z_zint_t); bits++)
+    {
+        z_zint_t e_zint = ((z_zint_t)1 << bits) | (gen_zint() & (((z_zint_t)1 << bits) - 1));
+        size_t len = _z_zint_len(e_zint);
+        assert(len == (bits / 7) + 1);
+
+        for (size_t pad = 0; pad < 12; pad++)
+        {
+            _z_wbuf_t wbf = _z_wbuf_make(1 + pad % 4, 1);
+            for (size_t i = 0; i < pad; i++)
+                assert(_z_wbuf_write(&wbf, 0xff) == 0);
+
+            assert(_z_zint_encode(&wbf, e_zint) == 0);
+            assert(_z_wbuf_len(&wbf) == pad + len);
+
+            _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+            _z_zbuf_set_rpos(&zbf, pad);
+            _z_zint_result_t r_zint = _z_zint_decode(&zbf);
+            assert(r_zint.tag == _z_res_t_OK);
+            assert(r_zint.value.zint == e_zint);
+            assert(_z_zbuf_len(&zbf) == 0);
+
+            // A truncated zint must be reported as an error
+            _z_zbuf_set_rpos(&zbf, pad);
+            _z_zbuf_set_wpos(&zbf, pad + len - 1);
+            if (len > 1)
+                assert(_z_zint_decode(&zbf).tag == _z_res_t_ERR);
+
+            _z_zbuf_clear(&zbf);
+            _z_wbuf_clear(&wbf);
+        }
+        printf("   %zu bytes: %llu\n", len, (unsigned long long)e_zint);
+    }
+}
+
 /*------------------ Payload field ------------------*/
 void assert_eq_payload(_zn_payload_t *left, _zn_payload_t *right)
 {
@@ -2550,6 +2592,7 @@ _zn_transport_message_t gen_transport_message(int can_be_fragment)
         break;
     case _ZN_MID_FRAME:
         e_tm = gen_frame_message(can_be_fragment);
+        e_tm.body.frame.priority = (zn_priority_t)(gen_uint8() % ZN_PRIORITIES_NUM);
         break;
     default:
         assert(0);
@@ -2614,6 +2657,8 @@ void assert_eq_transport_message(_zn_transport_message_t *left, _zn_transport_me
         assert_eq_ping_pong_message(&left->body.ping_pong, &right->body.ping_pong);
         break;
     case _ZN_MID_FRAME:
+        printf("   Priority (%d:%d)\n", left->body.frame.priority, right->body.frame.priority);
+        assert(left->body.frame.priority == right->body.frame.priority);
         assert_eq_frame_message(&left->body.frame, &right->body.frame, left->header);
         break;
     default:
@@ -2724,6 +2769,7 @@ _zn_transport_message_t _zn_frame_header(int is_reliable, int is_fragment, int i
     t_msg.attachment = NULL;
     t_msg.header = _ZN_MID_FRAME;
     t_msg.body.frame.sn = sn;
+    t_msg.body.frame.priority = ZN_PRIORITY_DEFAULT;
 
     if (is_reliable)
         _ZN_SET_FLAG(t_msg.header, _ZN_FLAG_T_R);
@@ -2893,6 +2939,7 @@ int main(void)
     {
         printf("\n\n== RUN %u", i);
         // Message fields
+        zint_field();
         payload_field();
         timestamp_field();
         subinfo_field();
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/protocol/msg.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/utils.h"
+
+#define ADDR_LEN 6 // IPv4 address and UDP port
+#define ROUNDS 200000
+#define BURST 16
+
+static const size_t PEERS_NUM[] = {1, 8, 32, 200, 1000};
+
+void make_addr(uint8_t *addr, size_t i)
+{
+    addr[0] = 192;
+    addr[1] = 168;
+    addr[2] = (uint8_t)(i >> 8);
+    addr[3] = (uint8_t)i;
+    addr[4] = 0x1c;
+    addr[5] = 0x5f;
+}
+
+// The lookup performed on every received datagram before the peer table
+_zn_transport_peer_entry_t *list_find(_zn_transport_peer_entry_list_t *l, z_bytes_t *remote_addr)
+{
+    for (; l != NULL; l = l->tail)
+    {
+        _zn_transport_peer_entry_t *entry = (_zn_transport_peer_entry_t *)l->val;
+        if (entry->remote_addr.len == remote_addr->len && memcmp(entry->remote_addr.val, remote_addr->val, remote_addr->len) == 0)
+            return entry;
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    printf("peers | list scan (ns/msg) | rx round-robin (ns/msg) | rx bursts of %d (ns/msg)\n", BURST);
+
+    for (size_t p = 0; p < sizeof(PEERS_NUM) / sizeof(PEERS_NUM[0]); p++)
+    {
+        size_t n = PEERS_NUM[p];
+        uint8_t(*addrs)[ADDR_LEN] = (uint8_t(*)[ADDR_LEN])z_malloc(n * ADDR_LEN);
+
+        _zn_transport_multicast_t ztm;
+        memset(&ztm, 0, sizeof(ztm));
+        z_mutex_init(&ztm.mutex_peer);
+        ztm.peers = _zn_transport_peer_entry_list_new();
+        _zn_transport_peer_table_init(&ztm.peer_table);
+        _zn_timers_init(&ztm.timers);
+
+        // Let the peers join the group
+        _zn_conduit_sn_list_t next_sns;
+        _zn_conduit_sn_list_init(&next_sns, 0, 0);
+        for (size_t i = 0; i < n; i++)
+        {
+            make_addr(addrs[i], i);
+            z_bytes_t addr = _z_bytes_wrap(addrs[i], ADDR_LEN);
+            z_bytes_t pid = _z_bytes_wrap(addrs[i], ADDR_LEN);
+            _zn_transport_message_t t_msg = _zn_t_msg_make_join(ZN_PROTO_VERSION, ZN_PEER, 10000, ZN_SN_RESOLUTION_DEFAULT, pid, next_sns);
+            _zn_multicast_handle_transport_message(&ztm, &t_msg, &addr);
+        }
+
+        z_bytes_t pid = _z_bytes_wrap(NULL, 0);
+        _zn_transport_message_t keep_alive = _zn_t_msg_make_keep_alive(pid);
+
+        // Former lookup, datagrams from each peer in turn
+        size_t found = 0;
+        z_clock_t start = z_clock_now();
+        for (size_t r = 0; r < ROUNDS; r++)
+        {
+            z_bytes_t addr = _z_bytes_wrap(addrs[r % n], ADDR_LEN);
+            z_mutex_lock(&ztm.mutex_peer);
+            found += list_find(ztm.peers, &addr) != NULL;
+            z_mutex_unlock(&ztm.mutex_peer);
+        }
+        double list_ns = (double)z_clock_elapsed_us(&start) * 1000.0 / ROUNDS;
+
+        // RX path, datagrams from each peer in turn
+        start = z_clock_now();
+        for (size_t r = 0; r < ROUNDS; r++)
+        {
+            z_bytes_t addr = _z_bytes_wrap(addrs[r % n], ADDR_LEN);
+            _zn_multicast_handle_transport_message(&ztm, &keep_alive, &addr);
+        }
+        double rr_ns = (double)z_clock_elapsed_us(&start) * 1000.0 / ROUNDS;
+
+        // RX path, bursts of datagrams from the same peer
+        start = z_clock_now();
+        for (size_t r = 0; r < ROUNDS; r++)
+        {
+            z_bytes_t addr = _z_bytes_wrap(addrs[(r / BURST) % n], ADDR_LEN);
+            _zn_multicast_handle_transport_message(&ztm, &keep_alive, &addr);
+        }
+        double burst_ns = (double)z_clock_elapsed_us(&start) * 1000.0 / ROUNDS;
+
+        printf("%5zu | %18.1f | %23.1f | %22.1f\n", n, list_ns, rr_ns, burst_ns);
+
+        size_t received = 0;
+        for (_zn_transport_peer_entry_list_t *l = ztm.peers; l != NULL; l = l->tail)
+            received += ((_zn_transport_peer_entry_t *)l->val)->received;
+
+        _zn_timers_clear(&ztm.timers);
+        _zn_transport_peer_table_clear(&ztm.peer_table);
+        _zn_transport_peer_entry_list_free(&ztm.peers);
+        z_mutex_free(&ztm.mutex_peer);
+        z_free(addrs);
+
+        if (found != ROUNDS || received != n)
+            return -1;
+    }
+
+    return 0;
+}
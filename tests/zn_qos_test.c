@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/link/tx.h"
+#include "zenoh-pico/transport/link/task/write.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 1024
+#define MAX_FRAMES 64
+#define SMALL 16
+#define LARGE (8 * MTU)
+
+uint8_t payload[LARGE];
+
+// The frames written on the link of the publisher, possibly by its write task
+zn_test_frames_t queue;
+
+// The zenoh message published by the link once the first frame is written, if any
+zn_session_t *inject_zn = NULL;
+zn_priority_t inject_priority;
+
+// Sequence of the first payload byte of the delivered samples
+uint8_t delivered[16];
+size_t delivered_len = 0;
+size_t delivered_size[16];
+
+void publish(zn_session_t *zn, uint8_t id, size_t len, zn_priority_t priority)
+{
+    uint8_t bs[LARGE];
+    memcpy(bs, payload, len);
+    bs[0] = id;
+    assert(zn_test_publish(zn, bs, len, zn_congestion_control_t_BLOCK, priority) == 0);
+}
+
+size_t inject_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    zn_test_link_write(arg, ptr, len);
+
+    // Publish a message while the write task is sending the fragments of a large one
+    if (inject_zn != NULL)
+    {
+        zn_session_t *zn = inject_zn;
+        inject_zn = NULL;
+        publish(zn, 1, SMALL, inject_priority);
+    }
+
+    return len;
+}
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(delivered_len < sizeof(delivered));
+    assert(memcmp(sample->value.val + 1, payload + 1, sample->value.len - 1) == 0);
+    delivered_size[delivered_len] = sample->value.len;
+    delivered[delivered_len++] = sample->value.val[0];
+}
+
+zn_session_t *make_session(int is_qos)
+{
+    _zn_link_t *link = zn_test_link_make(&queue, MTU, 1);
+    link->write_f = inject_write;
+
+    _zn_transport_unicast_establish_param_t param = zn_test_unicast_param(1);
+    param.is_qos = (uint8_t)is_qos;
+    zn_session_t *zn = zn_test_unicast_session_make(link, param);
+    zn_test_subscribe(zn, "/a/*", data_handler, NULL);
+
+    return zn;
+}
+
+_zn_transport_message_t decode(size_t i)
+{
+    _zn_transport_message_t t_msg = zn_test_frames_decode(&queue, i);
+    assert(_ZN_MID(t_msg.header) == _ZN_MID_FRAME);
+    return t_msg;
+}
+
+// Number of complete zenoh messages written so far, fragmented or not
+size_t count_messages(void)
+{
+    size_t n = 0;
+    size_t len = queue.len;
+    for (size_t i = 0; i < len; i++)
+    {
+        _zn_transport_message_t t_msg = decode(i);
+        if (!_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_F) || _ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_E))
+            n++;
+        _zn_t_msg_clear(&t_msg);
+    }
+    return n;
+}
+
+// Handle all the frames written by the publisher, and forget them
+void deliver_all(zn_session_t *zn)
+{
+    zn_test_deliver(zn, &queue, 0, queue.len);
+    zn_test_frames_reset(&queue);
+}
+
+void test_lanes(void)
+{
+    printf(">>> Testing TX lanes\n");
+
+    _zn_tx_lanes_t lanes;
+    _zn_tx_lanes_init(&lanes);
+    assert(_zn_tx_lanes_peek(&lanes) == NULL);
+    assert(_zn_tx_lanes_pop(&lanes) == NULL);
+
+    _zn_tx_job_t jobs[5];
+    zn_priority_t priorities[5] = {zn_priority_t_DATA, zn_priority_t_BACKGROUND, zn_priority_t_REAL_TIME, zn_priority_t_DATA, zn_priority_t_CONTROL};
+    for (int i = 0; i < 5; i++)
+    {
+        jobs[i].priority = priorities[i];
+        _zn_tx_lanes_push(&lanes, &jobs[i]);
+    }
+    assert(lanes.len == 5);
+
+    // The highest priority first, in FIFO order within a priority
+    int order[5] = {4, 2, 0, 3, 1};
+    for (int i = 0; i < 5; i++)
+    {
+        assert(_zn_tx_lanes_peek(&lanes) == &jobs[order[i]]);
+        assert(_zn_tx_lanes_pop(&lanes) == &jobs[order[i]]);
+    }
+    assert(lanes.len == 0);
+    assert(_zn_tx_lanes_peek(&lanes) == NULL);
+
+    // Emptied lanes can be reused
+    _zn_tx_lanes_push(&lanes, &jobs[0]);
+    assert(_zn_tx_lanes_pop(&lanes) == &jobs[0]);
+    assert(lanes.len == 0);
+}
+
+void test_codec(void)
+{
+    printf(">>> Testing priority decorator\n");
+
+    _z_wbuf_t wbf = _z_wbuf_make(MTU, 0);
+
+    // The default priority is not encoded
+    _zn_transport_message_t t_msg = _zn_t_msg_make_frame_header(7, 1, 0, 0);
+    assert(_zn_transport_message_encode(&wbf, &t_msg) == 0);
+    assert(_z_wbuf_len(&wbf) == 2);
+
+    // Other priorities are encoded in front of the frame
+    _z_wbuf_reset(&wbf);
+    t_msg.body.frame.priority = zn_priority_t_REAL_TIME;
+    assert(_zn_transport_message_encode(&wbf, &t_msg) == 0);
+    assert(_z_wbuf_len(&wbf) == 3);
+    assert(_z_wbuf_get_iosli(&wbf, 0)->buf[0] == (_ZN_MID_PRIORITY | (zn_priority_t_REAL_TIME << 5)));
+
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+    _zn_transport_message_result_t r = _zn_transport_message_decode(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    assert(_ZN_MID(r.value.transport_message.header) == _ZN_MID_FRAME);
+    assert(r.value.transport_message.body.frame.sn == 7);
+    assert(r.value.transport_message.body.frame.priority == zn_priority_t_REAL_TIME);
+    _zn_t_msg_clear(&r.value.transport_message);
+
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+}
+
+void test_conduits(void)
+{
+    printf(">>> Testing conduits\n");
+
+    zn_session_t *pub = make_session(1);
+    zn_session_t *sub = make_session(1);
+
+    // Each priority has its own SNs
+    publish(pub, 0, SMALL, zn_priority_t_DATA);
+    publish(pub, 1, SMALL, zn_priority_t_REAL_TIME);
+    publish(pub, 2, SMALL, zn_priority_t_DATA);
+    publish(pub, 3, SMALL, zn_priority_t_BACKGROUND);
+    assert(queue.len == 4);
+    z_zint_t sns[4] = {1, 1, 2, 1};
+    zn_priority_t priorities[4] = {zn_priority_t_DATA, zn_priority_t_REAL_TIME, zn_priority_t_DATA, zn_priority_t_BACKGROUND};
+    for (size_t i = 0; i < 4; i++)
+    {
+        _zn_transport_message_t t_msg = decode(i);
+        assert(t_msg.body.frame.sn == sns[i]);
+        assert(t_msg.body.frame.priority == priorities[i]);
+        _zn_t_msg_clear(&t_msg);
+    }
+
+    // The frames of different priorities are not out of order
+    deliver_all(sub);
+    assert(delivered_len == 4);
+    for (uint8_t i = 0; i < 4; i++)
+        assert(delivered[i] == i);
+
+    // The fragments of different priorities are reassembled apart
+    publish(pub, 4, LARGE, zn_priority_t_DATA_LOW);
+    size_t len = queue.len;
+    publish(pub, 5, LARGE, zn_priority_t_DATA_HIGH);
+    assert(len > 1 && queue.len == 2 * len);
+    for (size_t i = 0; i < len; i++)
+    {
+        // Interleave the fragments of both messages
+        size_t idx[2] = {i, len + i};
+        for (size_t j = 0; j < 2; j++)
+            zn_test_deliver(sub, &queue, idx[j], idx[j] + 1);
+    }
+    zn_test_frames_reset(&queue);
+    assert(delivered_len == 6);
+    assert(delivered[4] == 4 && delivered_size[4] == LARGE);
+    assert(delivered[5] == 5 && delivered_size[5] == LARGE);
+
+    // Without QoS, all the priorities share the same conduit
+    zn_session_t *plain = make_session(0);
+    publish(plain, 6, SMALL, zn_priority_t_DATA);
+    publish(plain, 7, SMALL, zn_priority_t_REAL_TIME);
+    assert(queue.len == 2);
+    for (size_t i = 0; i < 2; i++)
+    {
+        _zn_transport_message_t t_msg = decode(i);
+        assert(t_msg.body.frame.sn == 1 + i);
+        assert(t_msg.body.frame.priority == ZN_PRIORITY_DEFAULT);
+        _zn_t_msg_clear(&t_msg);
+    }
+    zn_test_frames_reset(&queue);
+
+    // Out of range priorities are refused
+    assert(zn_test_publish(pub, payload, SMALL, zn_congestion_control_t_BLOCK, (zn_priority_t)ZN_PRIORITIES_NUM) == -1);
+    assert(zn_test_publish(pub, payload, SMALL, zn_congestion_control_t_BLOCK, (zn_priority_t)-1) == -1);
+    assert(queue.len == 0);
+
+    zn_test_session_free(pub);
+    zn_test_session_free(sub);
+    zn_test_session_free(plain);
+}
+
+void test_preemption(int is_qos)
+{
+    printf(">>> Testing write task preemption (QoS: %d)\n", is_qos);
+
+    zn_session_t *pub = make_session(is_qos);
+    zn_session_t *sub = make_session(is_qos);
+    delivered_len = 0;
+
+    assert(_znp_unicast_start_write_task(&pub->tp->transport.unicast) == 0);
+
+    // A message with a higher priority is published once the first fragment is sent
+    inject_priority = zn_priority_t_REAL_TIME;
+    inject_zn = pub;
+    publish(pub, 0, LARGE, zn_priority_t_BACKGROUND);
+    while (count_messages() < 2)
+        z_sleep_ms(1);
+
+    assert(_znp_unicast_stop_write_task(&pub->tp->transport.unicast) == 0);
+    assert(inject_zn == NULL);
+
+    // With QoS, the message is sent between the fragments
+    size_t len = queue.len;
+    _zn_transport_message_t t_msg = decode(1);
+    assert(_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_F) != is_qos);
+    _zn_t_msg_clear(&t_msg);
+    t_msg = decode(len - 1);
+    assert(_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_F) == is_qos);
+    _zn_t_msg_clear(&t_msg);
+
+    deliver_all(sub);
+    assert(delivered_len == 2);
+    assert(delivered[0] == (is_qos ? 1 : 0));
+    assert(delivered[1] == (is_qos ? 0 : 1));
+    assert(delivered_size[is_qos ? 1 : 0] == LARGE);
+
+    zn_test_session_free(pub);
+    zn_test_session_free(sub);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < LARGE; i++)
+        payload[i] = (uint8_t)i;
+    zn_test_frames_init(&queue, MAX_FRAMES * MTU, MAX_FRAMES);
+
+    test_lanes();
+    test_codec();
+    test_conduits();
+    test_preemption(0);
+    test_preemption(1);
+
+    zn_test_frames_clear(&queue);
+    return 0;
+}
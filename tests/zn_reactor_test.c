@@ -0,0 +1,299 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/task/reactor.h"
+#include "zn_test_session.h"
+
+#if Z_REACTOR == 1
+
+#define SESSIONS 16
+#define TASKS 4
+#define MSGS 200
+#define MTU 1024
+
+/*------------------ Platform reactor ------------------*/
+volatile int ready = 0;
+volatile int slow = 0;
+
+int count_ready(void *arg)
+{
+    int fd = *(int *)arg;
+    char c;
+    assert(read(fd, &c, 1) == 1);
+    ready++;
+    if (slow)
+        z_sleep_ms(50);
+
+    // The file descriptor removes itself upon reading a zero
+    return c == 0 ? -1 : 0;
+}
+
+z_reactor_t *self_reactor = NULL;
+
+int remove_ready(void *arg)
+{
+    int fd = *(int *)arg;
+    char c;
+    assert(read(fd, &c, 1) == 1);
+    ready++;
+
+    // The file descriptor is removed from its own callback, without waiting for it
+    assert(z_reactor_remove(self_reactor, fd) == 0);
+    return 0;
+}
+
+typedef struct
+{
+    z_reactor_t *r;
+    volatile int running;
+} waiter_t;
+
+void *wait_task(void *arg)
+{
+    waiter_t *w = (waiter_t *)arg;
+    while (w->running)
+        z_reactor_wait(w->r, 10);
+    return 0;
+}
+
+void wait_ready(int expected)
+{
+    for (int i = 0; i < 200 && ready < expected; i++)
+        z_sleep_ms(5);
+    assert(ready == expected);
+}
+
+void test_platform(void)
+{
+    printf("\n>> Platform reactor\n");
+    z_reactor_t r;
+    assert(z_reactor_init(&r) == 0);
+
+    int sv[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    // Nothing is ready
+    assert(z_reactor_wait(&r, 0) == 0);
+    assert(z_reactor_add(&r, sv[1], count_ready, &sv[1]) == 0);
+    assert(z_reactor_add(&r, sv[1], count_ready, &sv[1]) == -1);
+    assert(z_reactor_wait(&r, 0) == 0);
+
+    // The file descriptor is armed again after each callback
+    char c = 1;
+    for (int i = 1; i <= 3; i++)
+    {
+        assert(write(sv[0], &c, 1) == 1);
+        assert(z_reactor_wait(&r, 1000) == 1);
+        assert(ready == i);
+    }
+
+    // A callback removes its file descriptor
+    c = 0;
+    assert(write(sv[0], &c, 1) == 1);
+    assert(z_reactor_wait(&r, 1000) == 1);
+    assert(ready == 4);
+    assert(z_reactor_remove(&r, sv[1]) == -1);
+
+    // The removal waits for the callback being called
+    waiter_t w = {&r, 1};
+    z_task_t task;
+    assert(z_task_init(&task, NULL, wait_task, &w) == 0);
+    assert(z_reactor_add(&r, sv[1], count_ready, &sv[1]) == 0);
+    slow = 1;
+    c = 1;
+    assert(write(sv[0], &c, 1) == 1);
+    for (int i = 0; i < 200 && ready < 5; i++)
+        z_sleep_ms(1);
+    assert(z_reactor_remove(&r, sv[1]) == 0);
+    assert(ready == 5);
+    slow = 0;
+
+    // Nothing is read once removed
+    assert(write(sv[0], &c, 1) == 1);
+    z_sleep_ms(30);
+    assert(ready == 5);
+
+    // A callback removes its file descriptor with z_reactor_remove
+    self_reactor = &r;
+    assert(z_reactor_add(&r, sv[1], remove_ready, &sv[1]) == 0);
+    assert(write(sv[0], &c, 1) == 1);
+    wait_ready(6);
+    assert(write(sv[0], &c, 1) == 1);
+    z_sleep_ms(30);
+    assert(ready == 6);
+    assert(z_reactor_remove(&r, sv[1]) == -1);
+
+    w.running = 0;
+    z_task_join(&task);
+
+    close(sv[0]);
+    close(sv[1]);
+    assert(z_reactor_free(&r) == 0);
+}
+
+/*------------------ Sessions ------------------*/
+volatile size_t delivered[SESSIONS];
+
+// The session removing itself from the reactor from its handler, if any
+znp_reactor_t *remove_reactor = NULL;
+zn_session_t *remove_zn = NULL;
+
+size_t test_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+    ssize_t wb = send(self->socket.tcp.sock, ptr, len, MSG_NOSIGNAL);
+    return wb < 0 ? SIZE_MAX : (size_t)wb;
+}
+
+size_t test_read(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr)
+{
+    (void)(addr);
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+    ssize_t rb = recv(self->socket.tcp.sock, ptr, len, 0);
+    return rb < 0 ? SIZE_MAX : (size_t)rb;
+}
+
+int test_fd(const void *arg)
+{
+    const _zn_link_t *self = (const _zn_link_t *)arg;
+    return self->socket.tcp.sock;
+}
+
+void test_close(void *arg)
+{
+    _zn_link_t *self = (_zn_link_t *)arg;
+    close(self->socket.tcp.sock);
+}
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    delivered[(size_t)arg]++;
+
+    if (remove_zn != NULL && (size_t)arg == SESSIONS - 1)
+    {
+        assert(znp_reactor_remove_session(remove_reactor, remove_zn) == 0);
+        remove_zn = NULL;
+    }
+}
+
+zn_session_t *make_session(int fd, z_zint_t initial_sn_tx)
+{
+    _zn_link_t *link = zn_test_link_make(NULL, MTU, 1);
+    link->socket.tcp.sock = fd;
+    link->write_f = test_write;
+    link->write_all_f = test_write;
+    link->read_f = test_read;
+    link->fd_f = test_fd;
+    link->close_f = test_close;
+    link->is_streamed = 1;
+
+    return zn_test_unicast_session_make(link, zn_test_unicast_param(initial_sn_tx));
+}
+
+void test_sessions(void)
+{
+    printf("\n>> Sessions serviced by a reactor\n");
+    zn_session_t *pubs[SESSIONS];
+    zn_session_t *subs[SESSIONS];
+
+    znp_reactor_t *reactor = znp_reactor_open(TASKS);
+    assert(reactor != NULL);
+    for (size_t i = 0; i < SESSIONS; i++)
+    {
+        int sv[2];
+        assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+        pubs[i] = make_session(sv[0], 1);
+        subs[i] = make_session(sv[1], 0);
+        zn_test_subscribe(subs[i], "/a/*", data_handler, (void *)i);
+        assert(znp_reactor_add_session(reactor, subs[i]) == 0);
+        delivered[i] = 0;
+    }
+
+    // A session is serviced either by the read task or by a reactor
+    assert(znp_reactor_add_session(reactor, subs[0]) == -1);
+    assert(znp_start_read_task(subs[0]) == -1);
+
+    // The messages of all the sessions are received, whatever their size, including the
+    // messages split over several reads
+    uint8_t payload[MTU / 2];
+    memset(payload, 0xab, sizeof(payload));
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/a/b";
+    for (size_t m = 0; m < MSGS; m++)
+        for (size_t i = 0; i < SESSIONS; i++)
+            assert(zn_write_ext(pubs[i], key, payload, 1 + (m * 7 + i) % sizeof(payload), 0, 0, zn_congestion_control_t_BLOCK) == 0);
+
+    for (size_t i = 0; i < SESSIONS; i++)
+    {
+        for (int t = 0; t < 200 && delivered[i] < MSGS; t++)
+            z_sleep_ms(5);
+        assert(delivered[i] == MSGS);
+    }
+
+    // A session is no longer serviced once removed
+    assert(znp_reactor_remove_session(reactor, subs[0]) == 0);
+    assert(znp_reactor_remove_session(reactor, subs[0]) == -1);
+    assert(zn_write_ext(pubs[0], key, payload, 8, 0, 0, zn_congestion_control_t_BLOCK) == 0);
+    z_sleep_ms(50);
+    assert(delivered[0] == MSGS);
+
+    // A session is removed from the reactor by its own handler
+    remove_reactor = reactor;
+    remove_zn = subs[SESSIONS - 1];
+    assert(zn_write_ext(pubs[SESSIONS - 1], key, payload, 8, 0, 0, zn_congestion_control_t_BLOCK) == 0);
+    for (int t = 0; t < 200 && remove_zn != NULL; t++)
+        z_sleep_ms(5);
+    assert(remove_zn == NULL);
+    assert(delivered[SESSIONS - 1] == MSGS + 1);
+    assert(zn_write_ext(pubs[SESSIONS - 1], key, payload, 8, 0, 0, zn_congestion_control_t_BLOCK) == 0);
+    z_sleep_ms(50);
+    assert(delivered[SESSIONS - 1] == MSGS + 1);
+    assert(znp_reactor_remove_session(reactor, subs[SESSIONS - 1]) == -1);
+
+    // A link closed by the other end is removed from the reactor, the session is removed
+    // from the reactor when closed
+    _zn_session_free(&pubs[1]);
+    z_sleep_ms(50);
+    for (size_t i = 0; i < SESSIONS; i++)
+    {
+        if (pubs[i] != NULL)
+            _zn_session_free(&pubs[i]);
+        _zn_session_free(&subs[i]);
+    }
+
+    znp_reactor_close(reactor);
+}
+
+int main(void)
+{
+    test_platform();
+    test_sessions();
+
+    return 0;
+}
+#else
+int main(void)
+{
+    return 0;
+}
+#endif
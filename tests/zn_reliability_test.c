@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/link/tx.h"
+#include "zenoh-pico/transport/link/task/lease.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 1024
+#define MAX_FRAMES 64
+#define SMALL 16
+#define LARGE (4 * MTU)
+#define W ZN_RELIABILITY_WINDOW_SIZE
+
+uint8_t payload[LARGE];
+
+// The messages written on the link of each session, waiting to be read by the remote session
+zn_test_frames_t pub_q;
+zn_test_frames_t sub_q;
+
+// Sequence of the first payload byte of the delivered samples
+uint8_t delivered[4 * W];
+size_t delivered_len = 0;
+size_t delivered_size = 0;
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(delivered_len < sizeof(delivered));
+    assert(memcmp(sample->value.val + 1, payload + 1, sample->value.len - 1) == 0);
+    delivered[delivered_len++] = sample->value.val[0];
+    delivered_size = sample->value.len;
+}
+
+zn_session_t *make_session(zn_test_frames_t *q)
+{
+    // Datagrams might be lost or reordered
+    return zn_test_unicast_session_make(zn_test_link_make(q, MTU, 0), zn_test_unicast_param(1));
+}
+
+void publish(zn_session_t *zn, uint8_t id, size_t len)
+{
+    payload[0] = id;
+    assert(zn_test_publish(zn, payload, len, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+}
+
+// Handle the i-th message written by the remote session
+void deliver(zn_session_t *zn, const zn_test_frames_t *q, size_t i)
+{
+    zn_test_deliver(zn, q, i, i + 1);
+}
+
+// Handle all the messages written by the remote session, and forget them
+void deliver_all(zn_session_t *zn, zn_test_frames_t *q)
+{
+    // The messages written in return go to the queue of the handling session
+    zn_test_deliver(zn, q, 0, q->len);
+    zn_test_frames_reset(q);
+}
+
+void expire_sync(zn_session_t *zn)
+{
+    // Pretend the last SYNC message was sent long ago
+    zn->tp->transport.unicast.tx_window.last_sync.tv_sec -= 1;
+    assert(_zn_unicast_sync_expired(&zn->tp->transport.unicast) == 0);
+}
+
+void test_tx_window(void)
+{
+    printf(">>> Testing retransmission window\n");
+
+    _zn_tx_window_t win;
+    _zn_tx_window_init(&win);
+
+    uint8_t bs[1] = {0};
+    _z_wbuf_t wbf = _z_wbuf_make(8, 0);
+    z_zint_t res = 64;
+
+    // Frames are kept, along with the bytes sent right after them
+    for (z_zint_t sn = 60; sn < 60 + W + 2; sn++)
+    {
+        _z_wbuf_reset(&wbf);
+        _z_wbuf_write(&wbf, (uint8_t)sn);
+        bs[0] = (uint8_t)(sn + 1);
+        _zn_tx_window_push(&win, res, sn % res, &wbf, bs, 1);
+    }
+
+    // The oldest frames are evicted when the window is full
+    assert(win.len == W);
+    assert(_zn_tx_window_get(&win, res, 60) == NULL);
+    assert(_zn_tx_window_get(&win, res, 61) == NULL);
+    const z_bytes_t *frame = _zn_tx_window_get(&win, res, 62);
+    assert(frame != NULL && frame->len == 2 && frame->val[0] == 62 && frame->val[1] == 63);
+    frame = _zn_tx_window_get(&win, res, (60 + W + 1) % res);
+    assert(frame != NULL && frame->val[0] == 60 + W + 1);
+    assert(_zn_tx_window_get(&win, res, (60 + W + 2) % res) == NULL);
+
+    // Acknowledged frames are released, across the SN wrap-around
+    _zn_tx_window_ack(&win, res, 1);
+    assert(win.len == 60 + W + 2 - 65);
+    assert(_zn_tx_window_get(&win, res, 0) == NULL);
+    assert(_zn_tx_window_get(&win, res, 1) != NULL);
+
+    // SN gaps leave empty slots
+    _z_wbuf_reset(&wbf);
+    _z_wbuf_write(&wbf, 0);
+    size_t len = win.len;
+    _zn_tx_window_push(&win, res, (60 + W + 3) % res, &wbf, NULL, 0);
+    assert(win.len == len + 2);
+    assert(_zn_tx_window_get(&win, res, (60 + W + 2) % res) == NULL);
+    assert(_zn_tx_window_get(&win, res, (60 + W + 3) % res) != NULL);
+
+    _zn_tx_window_clear(&win);
+    assert(win.len == 0);
+    _z_wbuf_clear(&wbf);
+}
+
+void test_reorder_buf(void)
+{
+    printf(">>> Testing reorder buffer\n");
+
+    _zn_reorder_buf_t rbuf;
+    _zn_reorder_buf_init(&rbuf);
+
+    z_bytes_t bs = _z_bytes_wrap(payload, SMALL);
+    assert(_zn_reorder_buf_put(&rbuf, 0, _ZN_MID_FRAME, &bs) == -1);
+    assert(_zn_reorder_buf_put(&rbuf, W, _ZN_MID_FRAME, &bs) == -1);
+    assert(_zn_reorder_buf_put(&rbuf, 2, _ZN_MID_FRAME, &bs) == 0);
+    assert(_zn_reorder_buf_put(&rbuf, 2, _ZN_MID_FRAME, &bs) == -1);
+    assert(_zn_reorder_buf_put(&rbuf, 4, _ZN_MID_FRAME, &bs) == 0);
+    assert(rbuf.len == 2);
+    assert(_zn_reorder_buf_mask(&rbuf, 5) == 0x0b);
+    assert(_zn_reorder_buf_mask(&rbuf, 2) == 0x03);
+
+    _zn_reorder_buf_t copy;
+    _zn_reorder_buf_copy(&copy, &rbuf);
+    assert(copy.len == 2 && copy.headers[2] == _ZN_MID_FRAME && copy.frames[4].len == SMALL);
+    _zn_reorder_buf_clear(&copy);
+    assert(copy.len == 0 && copy.headers[2] == 0);
+
+    uint8_t header;
+    z_bytes_t p;
+    assert(_zn_reorder_buf_take(&rbuf, &header, &p) == 0);
+    _zn_reorder_buf_shift(&rbuf);
+    _zn_reorder_buf_shift(&rbuf);
+    assert(_zn_reorder_buf_take(&rbuf, &header, &p) == 1);
+    assert(header == _ZN_MID_FRAME && p.len == SMALL && memcmp(p.val, payload, SMALL) == 0);
+    _z_bytes_clear(&p);
+    assert(rbuf.len == 1);
+
+    // Shifting drops the frame in the first position
+    _zn_reorder_buf_shift(&rbuf);
+    _zn_reorder_buf_shift(&rbuf);
+    assert(rbuf.len == 1);
+    _zn_reorder_buf_shift(&rbuf);
+    assert(rbuf.len == 0);
+
+    _zn_reorder_buf_clear(&rbuf);
+}
+
+void test_transport(void)
+{
+    printf(">>> Testing reliability on the transport\n");
+
+    zn_test_frames_init(&pub_q, MAX_FRAMES * MTU, MAX_FRAMES);
+    zn_test_frames_init(&sub_q, MAX_FRAMES * MTU, MAX_FRAMES);
+    zn_session_t *pub = make_session(&pub_q);
+    zn_session_t *sub = make_session(&sub_q);
+    zn_test_subscribe(sub, "/a/*", data_handler, NULL);
+
+    zn_stats_t st;
+
+    // A lost frame is reported as soon as the following one is received, and retransmitted
+    for (uint8_t i = 0; i < 3; i++)
+        publish(pub, i, SMALL);
+    assert(pub_q.len == 3);
+    deliver(sub, &pub_q, 1);
+    deliver(sub, &pub_q, 2);
+    assert(delivered_len == 0);
+    zn_test_frames_reset(&pub_q);
+
+    assert(sub_q.len == 1);
+    deliver_all(pub, &sub_q);
+    assert(pub_q.len == 1);
+    deliver_all(sub, &pub_q);
+    assert(delivered_len == 3);
+    for (uint8_t i = 0; i < 3; i++)
+        assert(delivered[i] == i);
+
+    // Duplicated frames are dropped
+    publish(pub, 3, SMALL);
+    deliver(sub, &pub_q, 0);
+    deliver(sub, &pub_q, 0);
+    zn_test_frames_reset(&pub_q);
+    assert(delivered_len == 4);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.dropped_out_of_order == 1);
+
+    // A lost last frame is reported upon the SYNC message
+    publish(pub, 4, SMALL);
+    zn_test_frames_reset(&pub_q);
+    expire_sync(pub);
+    assert(pub_q.len == 1);
+    deliver_all(sub, &pub_q);
+    deliver_all(pub, &sub_q);
+    deliver_all(sub, &pub_q);
+    assert(delivered_len == 5 && delivered[4] == 4);
+
+    // Acknowledged frames are released, no SYNC message is sent once they all are
+    assert(pub->tp->transport.unicast.tx_window.len > 0);
+    expire_sync(pub);
+    deliver_all(sub, &pub_q);
+    deliver_all(pub, &sub_q);
+    assert(pub->tp->transport.unicast.tx_window.len == 0);
+    expire_sync(pub);
+    assert(pub_q.len == 0);
+
+    // Fragments received in reverse order are reassembled
+    publish(pub, 5, LARGE);
+    assert(pub_q.len > 1 && pub_q.len < W);
+    for (size_t i = pub_q.len; i > 0; i--)
+        deliver(sub, &pub_q, i - 1);
+    zn_test_frames_reset(&pub_q);
+    zn_test_frames_reset(&sub_q);
+    assert(delivered_len == 6 && delivered[5] == 5 && delivered_size == LARGE);
+
+    // Frames evicted from the window of the sender are skipped
+    assert(zn_stats(pub, &st) == 0);
+    size_t retransmitted = st.retransmitted;
+    for (uint8_t i = 0; i < W + 2; i++)
+        publish(pub, 6 + i, SMALL);
+    for (size_t i = 1; i < pub_q.len; i++)
+        deliver(sub, &pub_q, i);
+    zn_test_frames_reset(&pub_q);
+    deliver_all(pub, &sub_q);
+    assert(pub_q.len == 0);
+    assert(delivered_len == 6 + W + 1);
+    for (uint8_t i = 1; i < W + 2; i++)
+        assert(delivered[5 + i] == 6 + i);
+
+    assert(zn_stats(pub, &st) == 0);
+    assert(st.retransmitted == retransmitted);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.lost == 1);
+
+    // A frame never retransmitted, e.g. by a remote peer not supporting it, is skipped after a lease period
+    for (uint8_t i = 0; i < 3; i++)
+        publish(pub, 7 + W + i, SMALL);
+    deliver(sub, &pub_q, 1);
+    deliver(sub, &pub_q, 2);
+    zn_test_frames_reset(&pub_q);
+    zn_test_frames_reset(&sub_q);
+    assert(delivered_len == 6 + W + 1);
+
+    _zn_transport_unicast_t *ztu = &sub->tp->transport.unicast;
+    assert(_znp_unicast_send_keep_alive(&pub->tp->transport.unicast) == 0);
+    deliver(sub, &pub_q, 0);
+    assert(delivered_len == 6 + W + 1);
+
+    ztu->rbuf_reliable.gap_start.tv_sec -= ztu->lease / 1000 + 1;
+    deliver_all(sub, &pub_q);
+    assert(delivered_len == 6 + W + 3);
+    assert(delivered[6 + W + 1] == 8 + W && delivered[6 + W + 2] == 9 + W);
+    assert(ztu->rbuf_reliable.len == 0);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.lost == 2);
+
+    zn_test_session_free(pub);
+    zn_test_session_free(sub);
+    zn_test_frames_clear(&pub_q);
+    zn_test_frames_clear(&sub_q);
+}
+
+void test_qos(void)
+{
+    printf(">>> Testing reliability with QoS\n");
+
+    zn_test_frames_init(&pub_q, MAX_FRAMES * MTU, MAX_FRAMES);
+    _zn_transport_unicast_establish_param_t param = zn_test_unicast_param(1);
+    param.is_qos = 1;
+    zn_session_t *pub = zn_test_unicast_session_make(zn_test_link_make(&pub_q, MTU, 0), param);
+
+    // The conduits of the priorities have their own SNs, the frames are neither kept nor synchronized
+    payload[0] = 0;
+    assert(zn_test_publish(pub, payload, SMALL, zn_congestion_control_t_BLOCK, zn_priority_t_REAL_TIME) == 0);
+    assert(pub_q.len == 1);
+    assert(pub->tp->transport.unicast.tx_window.len == 0);
+    expire_sync(pub);
+    assert(pub_q.len == 1);
+
+    zn_test_session_free(pub);
+    zn_test_frames_clear(&pub_q);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < LARGE; i++)
+        payload[i] = (uint8_t)i;
+
+    test_tx_window();
+    test_reorder_buf();
+    test_transport();
+    test_qos();
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "zenoh-pico/collections/list.h"
+#include "zenoh-pico/protocol/rname_trie.h"
+#include "zenoh-pico/protocol/utils.h"
+#include "zenoh-pico/system/platform.h"
+
+#define SUBS_NUM 2000
+#define KEYS_NUM 64
+#define ROUNDS 2000
+
+void count_match(void *val, void *arg)
+{
+    (void)(val);
+    (*(size_t *)arg)++;
+}
+
+int main(void)
+{
+    char *subs[SUBS_NUM];
+    _z_list_t *list = NULL;
+    _zn_rname_trie_t trie;
+    _zn_rname_trie_init(&trie);
+
+    // Mostly literal subscriptions plus a few wildcard ones
+    for (size_t i = 0; i < SUBS_NUM; i++)
+    {
+        subs[i] = (char *)z_malloc(64);
+        if (i % 100 == 0)
+            snprintf(subs[i], 64, "/robot/%zu/**", i / 100);
+        else if (i % 50 == 0)
+            snprintf(subs[i], 64, "/robot/*/sensor/%zu", i);
+        else
+            snprintf(subs[i], 64, "/robot/%zu/sensor/%zu", i % 20, i);
+
+        list = _z_list_push(list, subs[i]);
+        _zn_rname_trie_insert(&trie, subs[i], subs[i]);
+    }
+
+    char keys[KEYS_NUM][64];
+    for (size_t i = 0; i < KEYS_NUM; i++)
+        snprintf(keys[i], 64, "/robot/%zu/sensor/%zu", (i * 31) % 20, (i * 997) % SUBS_NUM);
+
+    // Current dispatch: scan the whole list and allocate the list of matches
+    size_t list_matches = 0;
+    z_clock_t start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t k = 0; k < KEYS_NUM; k++)
+        {
+            _z_list_t *xs = NULL;
+            for (_z_list_t *l = list; l != NULL; l = _z_list_tail(l))
+            {
+                if (zn_rname_intersect((z_str_t)_z_list_head(l), keys[k]))
+                    xs = _z_list_push(xs, _z_list_head(l));
+            }
+            list_matches += _z_list_len(xs);
+            _z_list_free(&xs, _zn_noop_free);
+        }
+    }
+    double list_ns = (double)z_clock_elapsed_us(&start) * 1000.0 / (ROUNDS * KEYS_NUM);
+
+    // Trie dispatch
+    size_t trie_matches = 0;
+    start = z_clock_now();
+    for (size_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t k = 0; k < KEYS_NUM; k++)
+            _zn_rname_trie_match(&trie, keys[k], count_match, &trie_matches);
+    }
+    double trie_ns = (double)z_clock_elapsed_us(&start) * 1000.0 / (ROUNDS * KEYS_NUM);
+
+    printf("subscriptions: %d, lookups: %d\n", SUBS_NUM, ROUNDS * KEYS_NUM);
+    printf("list scan: %.1f ns/lookup (%zu matches)\n", list_ns, list_matches);
+    printf("trie:      %.1f ns/lookup (%zu matches)\n", trie_ns, trie_matches);
+
+    _zn_rname_trie_clear(&trie);
+    _z_list_free(&list, _zn_noop_free);
+    for (size_t i = 0; i < SUBS_NUM; i++)
+        z_free(subs[i]);
+
+    return list_matches == trie_matches ? 0 : -1;
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include "zenoh-pico/protocol/rname_trie.h"
+#include "zenoh-pico/protocol/utils.h"
+
+#define RNAMES_NUM 32
+
+const char *rnames[RNAMES_NUM] = {
+    "/", "/a", "/a/", "/a/b", "/a/b/c", "/a/c", "/a/d/foo/l", "/*", "/*/", "/ab*", "/ab*d", "/ab/*",
+    "/abcd", "/ab", "/a/*/c/*/e", "/a/b/c/d/e", "/a/**/d/**/l", "/a/*b/c/*d/e", "/a/xb/c/xd/e",
+    "/ab*cd", "/abxxcxxcd", "/**", "/**/", "/ab/**", "/**/xyz", "/a/b/xyz/d/e/f/xyz", "/**/xyz*xyz",
+    "/a/**/c/**/e", "/a/c/e", "/x/abc", "/x/*", "/a//b"};
+
+int eq_ptr(const void *left, const void *right)
+{
+    return left == right;
+}
+
+void count_match(void *val, void *arg)
+{
+    int *matches = (int *)arg;
+    matches[(const char **)val - rnames]++;
+}
+
+void assert_match(_zn_rname_trie_t *trie, const char *rname, const int *registered)
+{
+    int matches[RNAMES_NUM] = {0};
+    _zn_rname_trie_match(trie, (const z_str_t)rname, count_match, matches);
+
+    for (size_t i = 0; i < RNAMES_NUM; i++)
+    {
+        int expected = registered[i] && zn_rname_intersect((const z_str_t)rnames[i], (const z_str_t)rname);
+        if (matches[i] != expected)
+            printf("Mismatch: %s %s (%d != %d)\n", rnames[i], rname, matches[i], expected);
+        assert(matches[i] == expected);
+    }
+}
+
+int main(void)
+{
+    _zn_rname_trie_t trie;
+    _zn_rname_trie_init(&trie);
+
+    int registered[RNAMES_NUM] = {0};
+    assert(_zn_rname_trie_match(&trie, "/a", count_match, NULL) == 0);
+
+    // Register every resource name and match them against each other
+    for (size_t i = 0; i < RNAMES_NUM; i++)
+    {
+        assert(_zn_rname_trie_insert(&trie, (const z_str_t)rnames[i], &rnames[i]) == 0);
+        registered[i] = 1;
+    }
+
+    for (size_t i = 0; i < RNAMES_NUM; i++)
+        assert_match(&trie, rnames[i], registered);
+    assert_match(&trie, "/a/b/b/b/c/d/d/d/e", registered);
+    assert_match(&trie, "/a/b/c/d/e/f/g/h/i/l", registered);
+    assert_match(&trie, "/zzz", registered);
+
+    // Remove half of the resource names
+    for (size_t i = 0; i < RNAMES_NUM; i += 2)
+    {
+        assert(_zn_rname_trie_remove(&trie, (const z_str_t)rnames[i], eq_ptr, &rnames[i]) == 0);
+        registered[i] = 0;
+    }
+    assert(_zn_rname_trie_remove(&trie, "/not/registered", eq_ptr, &rnames[0]) == -1);
+
+    for (size_t i = 0; i < RNAMES_NUM; i++)
+        assert_match(&trie, rnames[i], registered);
+
+    // Remove the remaining ones, the trie must be emptied
+    for (size_t i = 1; i < RNAMES_NUM; i += 2)
+        assert(_zn_rname_trie_remove(&trie, (const z_str_t)rnames[i], eq_ptr, &rnames[i]) == 0);
+    assert(trie.root == NULL);
+
+    // Clear a non-empty trie
+    for (size_t i = 0; i < RNAMES_NUM; i++)
+        _zn_rname_trie_insert(&trie, (const z_str_t)rnames[i], &rnames[i]);
+    _zn_rname_trie_clear(&trie);
+    assert(trie.root == NULL);
+
+    return 0;
+}
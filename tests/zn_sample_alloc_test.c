@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_alloc.h"
+
+#define RUNS 1000
+
+size_t delivered = 0;
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(arg);
+    assert(strncmp(sample->key.val, "/robot/sensor/temp", sample->key.len) == 0);
+    assert(sample->value.len == 4);
+    delivered++;
+}
+
+int main(void)
+{
+    if (ZN_TEST_ALLOC_COUNTED == 0)
+    {
+        printf("Allocation counting is only supported with glibc, skipping\n");
+        return 0;
+    }
+
+    zn_session_t *zn = zn_test_alloc_session_make(data_handler);
+
+    // Serialize a DATA message on a numerical resource id
+    uint8_t payload[4] = {0, 1, 2, 3};
+    zn_reskey_t key;
+    key.rid = ZN_TEST_ALLOC_RID;
+    key.rname = NULL;
+    _zn_data_info_t info;
+    memset(&info, 0, sizeof(_zn_data_info_t));
+    _zn_zenoh_message_t z_msg = _zn_z_msg_make_data(key, info, _z_bytes_wrap(payload, 4), 1);
+
+    _z_wbuf_t wbf = _z_wbuf_make(64, 0);
+    assert(_zn_zenoh_message_encode(&wbf, &z_msg) == 0);
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+
+    for (size_t i = 0; i <= RUNS; i++)
+    {
+        // The first sample warms up the dispatch cache
+        if (i == 1)
+            zn_test_heap_ops = 0;
+
+        _z_zbuf_set_rpos(&zbf, 0);
+        _zn_zenoh_message_result_t r = _zn_zenoh_message_decode(&zbf);
+        assert(r.tag == _z_res_t_OK);
+        assert(_zn_handle_zenoh_message(zn, &r.value.zenoh_message) == _z_res_t_OK);
+        _zn_z_msg_clear(&r.value.zenoh_message);
+    }
+
+    size_t ops = zn_test_heap_ops;
+    printf("Delivered %zu samples, %zu heap operations in steady state\n", delivered, ops);
+    assert(delivered == RUNS + 1);
+    assert(ops == 0);
+
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+    _zn_session_free(&zn);
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 8192
+#define MAX_FRAMES 256
+#define SMALL 64
+#define OVERSIZED (ZN_FRAG_MAX_SIZE + 1)
+#define MSGS 10
+
+uint8_t payload[OVERSIZED];
+
+// Frames written on the link of the publishing session, and read by the receiving one
+zn_test_frames_t frames;
+
+size_t delivered = 0;
+int slow_callback = 0;
+
+void data_handler(const zn_sample_t *sample, const void *arg)
+{
+    (void)(sample);
+    (void)(arg);
+    delivered++;
+    if (slow_callback)
+        z_sleep_ms(2);
+}
+
+size_t failing_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    (void)(arg);
+    (void)(ptr);
+    (void)(len);
+    return SIZE_MAX;
+}
+
+int publish(zn_session_t *zn, size_t len, zn_congestion_control_t cong_ctrl)
+{
+    zn_test_frames_reset(&frames);
+    return zn_test_publish(zn, payload, len, cong_ctrl, ZN_PRIORITY_DEFAULT);
+}
+
+void test_histogram(void)
+{
+    printf(">>> Testing histograms\n");
+
+    // Buckets are contiguous, and their width is bounded by the sub-bucket resolution
+    size_t lower = 0;
+    for (size_t i = 0; i < ZN_STATS_HIST_BUCKETS; i++)
+    {
+        size_t upper = zn_histogram_bucket_upper(i);
+        assert(upper > lower);
+        size_t sub = (size_t)1 << ZN_STATS_HIST_SUB_BITS;
+        assert((upper - lower) * sub <= (lower > sub ? lower : sub));
+        lower = upper;
+    }
+    assert(lower == ((size_t)1 << ZN_STATS_HIST_MAX_BITS));
+
+    zn_histogram_t h;
+    memset(&h, 0, sizeof(zn_histogram_t));
+    assert(zn_histogram_percentile(&h, 50) == 0);
+
+    // 99 fast values and a slow one
+    z_clock_t now = z_clock_now();
+    for (int i = 0; i < 99; i++)
+        _zn_histogram_record(&h, &now);
+    z_clock_t past = now;
+    past.tv_sec -= 1;
+    _zn_histogram_record(&h, &past);
+
+    assert(h.count == 100);
+    assert(h.max >= 1000000);
+    assert(h.sum >= h.max);
+    assert(zn_histogram_percentile(&h, 50) < 1000);
+    assert(zn_histogram_percentile(&h, 99) < 1000);
+    assert(zn_histogram_percentile(&h, 99.9) >= 1000000 * 3 / 4);
+    assert(zn_histogram_percentile(&h, 100) == h.max);
+}
+
+void test_session(void)
+{
+    printf(">>> Testing session statistics\n");
+
+    zn_test_frames_init(&frames, 2 * OVERSIZED, MAX_FRAMES);
+    zn_session_t *pub = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(1));
+    zn_session_t *sub = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(0));
+    zn_test_subscribe(sub, "/a/*", data_handler, NULL);
+
+    zn_stats_t st;
+    assert(zn_stats(pub, &st) == 0);
+    assert(st.tx.bytes == 0 && st.send_us.count == 0);
+
+    // Messages are counted on both sides
+    size_t bytes = 0;
+    for (int i = 0; i < MSGS; i++)
+    {
+        assert(publish(pub, SMALL, zn_congestion_control_t_BLOCK) == 0);
+        assert(frames.len == 1);
+        bytes += frames.pos[1];
+        zn_test_receive(sub, 0);
+    }
+    assert(delivered == MSGS);
+
+    assert(zn_stats(pub, &st) == 0);
+    assert(st.tx.bytes == bytes);
+    assert(st.tx.t_msgs == MSGS);
+    assert(st.tx.frames[zn_reliability_t_RELIABLE] == MSGS);
+    assert(st.tx.frames[zn_reliability_t_BEST_EFFORT] == 0);
+    assert(st.tx.msgs_by_mid[_ZN_MID_FRAME] == MSGS);
+    assert(st.tx.z_msgs == MSGS);
+    assert(st.tx.z_msgs_by_reliability[zn_reliability_t_RELIABLE] == MSGS);
+    assert(st.tx.msgs_by_mid[_ZN_MID_DATA] == MSGS);
+    assert(st.send_us.count == MSGS);
+
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.rx.bytes == bytes);
+    assert(st.rx.t_msgs == MSGS);
+    assert(st.rx.frames[zn_reliability_t_RELIABLE] == MSGS);
+    assert(st.rx.z_msgs == MSGS);
+    assert(st.rx.z_msgs_by_reliability[zn_reliability_t_RELIABLE] == MSGS);
+    assert(st.rx.msgs_by_mid[_ZN_MID_DATA] == MSGS);
+    assert(st.callback_us.count == MSGS);
+    assert(st.dropped_out_of_order == 0);
+    assert(st.malformed == 0);
+
+    // The execution time of the callbacks is recorded
+    assert(zn_stats_reset(sub) == 0);
+    slow_callback = 1;
+    assert(publish(pub, SMALL, zn_congestion_control_t_BLOCK) == 0);
+    zn_test_receive(sub, 0);
+    slow_callback = 0;
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.rx.t_msgs == 1);
+    assert(st.callback_us.count == 1);
+    assert(st.callback_us.max >= 2000);
+    assert(zn_histogram_percentile(&st.callback_us, 50) >= 1500);
+
+    // Replayed frames are dropped
+    zn_test_receive(sub, 0);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.dropped_out_of_order == 1);
+    assert(st.callback_us.count == 1);
+
+    // Oversized fragmented messages are dropped
+    assert(publish(pub, OVERSIZED, zn_congestion_control_t_BLOCK) == 0);
+    assert(frames.len > 1);
+    zn_test_receive(sub, 0);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.dropped_fragments == 1);
+    assert(st.rx.t_msgs == 1 + frames.len + 1);
+
+    // Truncated frames are malformed
+    assert(publish(pub, SMALL, zn_congestion_control_t_BLOCK) == 0);
+    frames.pos[1] -= SMALL / 2;
+    zn_test_receive(sub, 0);
+    assert(zn_stats(sub, &st) == 0);
+    assert(st.malformed == 1);
+
+    // Messages are dropped when the transport is busy and they can be dropped
+    assert(zn_stats(pub, &st) == 0);
+    size_t z_msgs = st.tx.z_msgs;
+    z_mutex_lock(&pub->tp->transport.unicast.mutex_tx);
+    assert(publish(pub, SMALL, zn_congestion_control_t_DROP) == 0);
+    z_mutex_unlock(&pub->tp->transport.unicast.mutex_tx);
+    assert(frames.len == 0);
+    assert(zn_stats(pub, &st) == 0);
+    assert(st.dropped_congestion == 1);
+    assert(st.tx.z_msgs == z_msgs);
+
+    // Messages that fail to be sent are not counted
+    _zn_link_t *link = (_zn_link_t *)pub->tp->transport.unicast.link;
+    link->write_f = failing_write;
+    assert(publish(pub, SMALL, zn_congestion_control_t_BLOCK) != 0);
+    link->write_f = zn_test_link_write;
+    assert(zn_stats(pub, &st) == 0);
+    assert(st.tx.z_msgs == z_msgs);
+
+    // Reset clears all the statistics
+    assert(zn_stats_reset(pub) == 0);
+    assert(zn_stats(pub, &st) == 0);
+    zn_stats_t zero;
+    memset(&zero, 0, sizeof(zn_stats_t));
+    assert(memcmp(&st, &zero, sizeof(zn_stats_t)) == 0);
+
+    zn_test_session_free(pub);
+    zn_test_session_free(sub);
+    zn_test_frames_clear(&frames);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < OVERSIZED; i++)
+        payload[i] = (uint8_t)i;
+
+    test_histogram();
+    test_session();
+
+    return 0;
+}
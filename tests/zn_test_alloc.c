@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_alloc.h"
+
+volatile size_t zn_test_heap_ops = 0;
+
+#if ZN_TEST_ALLOC_COUNTED == 1
+// Count every heap operation by interposing the libc allocator
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    zn_test_heap_ops++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    zn_test_heap_ops++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    zn_test_heap_ops++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    if (ptr != NULL)
+        zn_test_heap_ops++;
+    __libc_free(ptr);
+}
+#endif
+
+zn_session_t *zn_test_alloc_session_make(zn_data_handler_t callback)
+{
+    zn_session_t *zn = _zn_session_init();
+
+    // Remote resource declarations: /robot/sensor -> 1, 1 + /temp -> ZN_TEST_ALLOC_RID
+    _zn_resource_t *r1 = (_zn_resource_t *)z_malloc(sizeof(_zn_resource_t));
+    r1->id = 1;
+    r1->key.rid = ZN_RESOURCE_ID_NONE;
+    r1->key.rname = _z_str_clone("/robot/sensor");
+    assert(_zn_register_resource(zn, _ZN_RESOURCE_REMOTE, r1) == 0);
+
+    _zn_resource_t *r2 = (_zn_resource_t *)z_malloc(sizeof(_zn_resource_t));
+    r2->id = ZN_TEST_ALLOC_RID;
+    r2->key.rid = 1;
+    r2->key.rname = _z_str_clone("/temp");
+    assert(_zn_register_resource(zn, _ZN_RESOURCE_REMOTE, r2) == 0);
+
+    // Local subscription
+    _zn_subscriber_t *sub = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(sub, 0, sizeof(_zn_subscriber_t));
+    sub->id = 1;
+    sub->rname = _z_str_clone("/robot/*/temp");
+    sub->callback = callback;
+    assert(_zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, sub) == 0);
+
+    return zn;
+}
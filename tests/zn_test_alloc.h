@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TESTS_ZN_TEST_ALLOC_H
+#define ZENOH_PICO_TESTS_ZN_TEST_ALLOC_H
+
+#include <stdio.h>
+#include "zenoh-pico/api/session.h"
+
+/**
+ * The heap operations are counted by interposing the libc allocator, which is
+ * only supported with glibc. Elsewhere, the tests relying on it are skipped.
+ */
+#if defined(__GLIBC__)
+#define ZN_TEST_ALLOC_COUNTED 1
+#else
+#define ZN_TEST_ALLOC_COUNTED 0
+#endif
+
+// The number of malloc, calloc, realloc and free calls so far, reset at will by the tests
+extern volatile size_t zn_test_heap_ops;
+
+// The numerical resource id declared by the remote peer for /robot/sensor/temp
+#define ZN_TEST_ALLOC_RID 2
+
+/**
+ * Make a session where the remote peer declared /robot/sensor as 1 and 1 + /temp
+ * as ZN_TEST_ALLOC_RID, with a local subscription matching it through a wildcard chunk.
+ */
+zn_session_t *zn_test_alloc_session_make(zn_data_handler_t callback);
+
+#endif /* ZENOH_PICO_TESTS_ZN_TEST_ALLOC_H */
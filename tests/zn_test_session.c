@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zn_test_session.h"
+
+/*------------------ Frames ------------------*/
+void zn_test_frames_init(zn_test_frames_t *frames, size_t capacity, size_t max_len)
+{
+    frames->data = (uint8_t *)z_malloc(capacity);
+    frames->capacity = capacity;
+    frames->pos = (size_t *)z_malloc((max_len + 1) * sizeof(size_t));
+    frames->max_len = max_len;
+    zn_test_frames_reset(frames);
+}
+
+void zn_test_frames_clear(zn_test_frames_t *frames)
+{
+    z_free(frames->data);
+    z_free(frames->pos);
+    frames->data = NULL;
+    frames->pos = NULL;
+}
+
+void zn_test_frames_reset(zn_test_frames_t *frames)
+{
+    frames->pos[0] = 0;
+    frames->len = 0;
+    frames->read = 0;
+}
+
+_zn_transport_message_t zn_test_frames_decode(const zn_test_frames_t *frames, size_t i)
+{
+    assert(i < frames->len);
+    size_t len = frames->pos[i + 1] - frames->pos[i];
+    _z_zbuf_t zbf;
+    zbf.ios = _z_iosli_wrap(frames->data + frames->pos[i], len, 0, len);
+    _zn_transport_message_result_t r = _zn_transport_message_decode_lazy(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    return r.value.transport_message;
+}
+
+/*------------------ Links ------------------*/
+size_t zn_test_link_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    zn_test_frames_t *frames = ((const zn_test_link_t *)arg)->frames;
+    assert(frames->len < frames->max_len);
+    assert(frames->pos[frames->len] + len <= frames->capacity);
+    memcpy(frames->data + frames->pos[frames->len], ptr, len);
+    frames->pos[frames->len + 1] = frames->pos[frames->len] + len;
+    frames->len++;
+    return len;
+}
+
+size_t zn_test_link_read(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr)
+{
+    (void)(addr);
+    zn_test_frames_t *frames = ((const zn_test_link_t *)arg)->frames;
+    assert(frames->read < frames->len);
+    size_t n = frames->pos[frames->read + 1] - frames->pos[frames->read];
+    assert(n <= len);
+    memcpy(ptr, frames->data + frames->pos[frames->read], n);
+    frames->read++;
+    return n;
+}
+
+void zn_test_link_close(void *arg)
+{
+    (void)(arg);
+}
+
+_zn_link_t *zn_test_link_make(zn_test_frames_t *frames, size_t mtu, int is_reliable)
+{
+    zn_test_link_t *tl = (zn_test_link_t *)z_malloc(sizeof(zn_test_link_t));
+    memset(tl, 0, sizeof(zn_test_link_t));
+    tl->frames = frames;
+    tl->link.write_f = zn_test_link_write;
+    tl->link.read_f = zn_test_link_read;
+    tl->link.close_f = zn_test_link_close;
+    tl->link.free_f = zn_test_link_close;
+    tl->link.mtu = (uint16_t)mtu;
+    tl->link.is_reliable = (uint8_t)is_reliable;
+    return &tl->link;
+}
+
+/*------------------ Sessions ------------------*/
+_zn_transport_unicast_establish_param_t zn_test_unicast_param(z_zint_t initial_sn_tx)
+{
+    _zn_transport_unicast_establish_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.sn_resolution = ZN_SN_RESOLUTION;
+    param.lease = ZN_TRANSPORT_LEASE;
+    param.initial_sn_tx = initial_sn_tx;
+    return param;
+}
+
+zn_session_t *zn_test_unicast_session_make(_zn_link_t *link, _zn_transport_unicast_establish_param_t param)
+{
+    zn_session_t *zn = _zn_session_init();
+    zn->tp = _zn_transport_unicast_new(link, param);
+    zn->tp->transport.unicast.session = zn;
+    return zn;
+}
+
+zn_session_t *zn_test_multicast_session_make(_zn_link_t *link, _zn_transport_multicast_establish_param_t param)
+{
+    zn_session_t *zn = _zn_session_init();
+    zn->tp = _zn_transport_multicast_new(link, param);
+    zn->tp->transport.multicast.session = zn;
+    return zn;
+}
+
+void zn_test_session_free(zn_session_t *zn)
+{
+    // The link is not released by the transport, its endpoint is not set
+    const _zn_link_t **link = zn->tp->type == _ZN_TRANSPORT_UNICAST_TYPE ? &zn->tp->transport.unicast.link : &zn->tp->transport.multicast.link;
+    z_free((_zn_link_t *)*link);
+    *link = NULL;
+    _zn_session_free(&zn);
+}
+
+void zn_test_subscribe(zn_session_t *zn, const char *rname, zn_data_handler_t callback, void *arg)
+{
+    _zn_subscriber_t *s = (_zn_subscriber_t *)z_malloc(sizeof(_zn_subscriber_t));
+    memset(s, 0, sizeof(_zn_subscriber_t));
+    s->id = _zn_get_entity_id(zn);
+    s->rname = _z_str_clone((z_str_t)rname);
+    s->callback = callback;
+    s->arg = arg;
+    assert(_zn_register_subscription(zn, _ZN_RESOURCE_IS_LOCAL, s) == 0);
+}
+
+int zn_test_publish(zn_session_t *zn, const uint8_t *payload, size_t len, zn_congestion_control_t cong_ctrl, zn_priority_t priority)
+{
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = "/a/b";
+    return zn_write_prio(zn, key, payload, len, 0, 0, cong_ctrl, priority);
+}
+
+void zn_test_deliver(zn_session_t *zn, const zn_test_frames_t *frames, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++)
+    {
+        _zn_transport_message_t t_msg = zn_test_frames_decode(frames, i);
+        _zn_unicast_handle_transport_message(&zn->tp->transport.unicast, &t_msg);
+        _zn_t_msg_clear(&t_msg);
+    }
+}
+
+void zn_test_receive(zn_session_t *zn, size_t first)
+{
+    zn_test_frames_t *frames = ((const zn_test_link_t *)zn->tp->transport.unicast.link)->frames;
+    frames->read = first;
+    while (frames->read < frames->len)
+    {
+        _zn_transport_message_result_t r = _zn_unicast_recv_t_msg(&zn->tp->transport.unicast);
+        assert(r.tag == _z_res_t_OK);
+        _zn_unicast_handle_transport_message(&zn->tp->transport.unicast, &r.value.transport_message);
+        _zn_t_msg_clear(&r.value.transport_message);
+    }
+}
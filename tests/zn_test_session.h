@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TESTS_ZN_TEST_SESSION_H
+#define ZENOH_PICO_TESTS_ZN_TEST_SESSION_H
+
+#include "zenoh-pico/api/session.h"
+#include "zenoh-pico/link/link.h"
+#include "zenoh-pico/protocol/msg.h"
+
+/**
+ * The frames written on the links of the test sessions, waiting to be handled
+ * by the remote session. Several links might write on the same frames.
+ *
+ * Members:
+ *   uint8_t *data: The content of the frames, one after the other.
+ *   size_t capacity: The size of the content.
+ *   size_t *pos: The position of each frame in the content, followed by the end of the last one.
+ *   size_t max_len: The maximum number of frames.
+ *   volatile size_t len: The number of frames written so far.
+ *   size_t read: The index of the next frame read by the links.
+ */
+typedef struct
+{
+    uint8_t *data;
+    size_t capacity;
+    size_t *pos;
+    size_t max_len;
+    volatile size_t len;
+    size_t read;
+} zn_test_frames_t;
+
+void zn_test_frames_init(zn_test_frames_t *frames, size_t capacity, size_t max_len);
+void zn_test_frames_clear(zn_test_frames_t *frames);
+void zn_test_frames_reset(zn_test_frames_t *frames);
+_zn_transport_message_t zn_test_frames_decode(const zn_test_frames_t *frames, size_t i);
+
+/**
+ * A link writing and reading its frames in memory. The link functions can be
+ * replaced before the session is made.
+ */
+typedef struct
+{
+    _zn_link_t link;
+    zn_test_frames_t *frames;
+} zn_test_link_t;
+
+_zn_link_t *zn_test_link_make(zn_test_frames_t *frames, size_t mtu, int is_reliable);
+size_t zn_test_link_write(const void *arg, const uint8_t *ptr, size_t len);
+size_t zn_test_link_read(const void *arg, uint8_t *ptr, size_t len, z_bytes_t *addr);
+void zn_test_link_close(void *arg);
+
+/*------------------ Sessions ------------------*/
+_zn_transport_unicast_establish_param_t zn_test_unicast_param(z_zint_t initial_sn_tx);
+zn_session_t *zn_test_unicast_session_make(_zn_link_t *link, _zn_transport_unicast_establish_param_t param);
+zn_session_t *zn_test_multicast_session_make(_zn_link_t *link, _zn_transport_multicast_establish_param_t param);
+void zn_test_session_free(zn_session_t *zn);
+
+void zn_test_subscribe(zn_session_t *zn, const char *rname, zn_data_handler_t callback, void *arg);
+int zn_test_publish(zn_session_t *zn, const uint8_t *payload, size_t len, zn_congestion_control_t cong_ctrl, zn_priority_t priority);
+
+// Handle the frames in [first, last) on a unicast session, decoded in place
+void zn_test_deliver(zn_session_t *zn, const zn_test_frames_t *frames, size_t first, size_t last);
+
+// Read the frames from the link of a unicast session, starting from a given one, and handle them
+void zn_test_receive(zn_session_t *zn, size_t first);
+
+#endif /* ZENOH_PICO_TESTS_ZN_TEST_SESSION_H */
@@ -0,0 +1,394 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/api/resource.h"
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/query.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/link/rx.h"
+#include "zenoh-pico/transport/link/task/lease.h"
+#include "zenoh-pico/transport/timer.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zn_test_session.h"
+
+#define TIMERS_NUM 64
+
+/*------------------ Timer service ------------------*/
+_zn_timer_t timers[TIMERS_NUM];
+_zn_timer_t *fired[TIMERS_NUM];
+size_t fired_len = 0;
+
+void record(_zn_timer_t *tmr, void *arg)
+{
+    _zn_timers_t *tms = (_zn_timers_t *)arg;
+    assert(_zn_timers_claim(tms, tmr) == 1);
+    assert(_zn_timer_is_scheduled(tmr) == 0);
+    fired[fired_len++] = tmr;
+}
+
+void assert_heap(const _zn_timers_t *tms)
+{
+    for (size_t i = 0; i < tms->len; i++)
+    {
+        assert(tms->heap[i]->idx == i);
+        if (i > 0)
+            assert(tms->heap[(i - 1) / 2]->deadline <= tms->heap[i]->deadline);
+    }
+}
+
+void test_heap(void)
+{
+    printf("\n>> Timer heap\n");
+    _zn_timers_t tms;
+    _zn_timers_init(&tms);
+
+    // Schedule the timers in a scrambled order of deadlines, more than the initial capacity of
+    // the heap: it grows while keeping the scheduled timers
+    size_t grows = 0;
+    for (size_t i = 0; i < TIMERS_NUM; i++)
+    {
+        size_t capacity = tms.capacity;
+        _zn_timer_init(&timers[i], record, &tms);
+        assert(_zn_timers_schedule(&tms, &timers[i], (i * 37) % TIMERS_NUM) == 0);
+        assert_heap(&tms);
+        grows += tms.capacity != capacity;
+    }
+    assert(tms.len == TIMERS_NUM);
+    assert(grows > 1);
+
+    // Cancel a quarter of them and move another quarter
+    for (size_t i = 0; i < TIMERS_NUM; i += 4)
+    {
+        _zn_timers_cancel(&tms, &timers[i]);
+        assert(_zn_timer_is_scheduled(&timers[i]) == 0);
+        assert_heap(&tms);
+
+        assert(_zn_timers_schedule(&tms, &timers[i + 1], TIMERS_NUM - i) == 0);
+        assert_heap(&tms);
+    }
+    assert(tms.len == TIMERS_NUM - TIMERS_NUM / 4);
+
+    // Cancelling an idle timer does nothing
+    _zn_timers_cancel(&tms, &timers[0]);
+    assert(tms.len == TIMERS_NUM - TIMERS_NUM / 4);
+
+    // Nothing has expired yet, the next deadline is within the maximum delay
+    z_zint_t next = _zn_timers_expire(&tms);
+    assert(fired_len <= 1);
+    assert(next <= TIMERS_NUM);
+
+    z_sleep_ms(TIMERS_NUM + 10);
+    next = _zn_timers_expire(&tms);
+    assert(next == _ZN_TIMER_IDLE);
+    assert(tms.len == 0);
+
+    // All the scheduled timers have expired, in the order of their deadlines
+    assert(fired_len == TIMERS_NUM - TIMERS_NUM / 4);
+    for (size_t i = 0; i < fired_len; i++)
+    {
+        assert((fired[i] - timers) % 4 != 0);
+        if (i > 0)
+            assert(fired[i - 1]->deadline <= fired[i]->deadline);
+    }
+
+    _zn_timers_clear(&tms);
+}
+
+/*------------------ Claiming ------------------*/
+_zn_timers_t claim_tms;
+_zn_timer_t cancelled_tmr;
+_zn_timer_t periodic_tmr;
+int claimed = 0;
+int periods = 0;
+
+void cancel_then_claim(_zn_timer_t *tmr, void *arg)
+{
+    (void)(arg);
+    // The object owning the timer has been freed in the meantime
+    _zn_timers_cancel(&claim_tms, tmr);
+    claimed += _zn_timers_claim(&claim_tms, tmr);
+}
+
+void reschedule(_zn_timer_t *tmr, void *arg)
+{
+    (void)(arg);
+    assert(_zn_timers_claim(&claim_tms, tmr) == 1);
+    // Claiming it twice fails
+    assert(_zn_timers_claim(&claim_tms, tmr) == 0);
+    if (++periods < 3)
+        _zn_timers_schedule(&claim_tms, tmr, 0);
+}
+
+void test_claim(void)
+{
+    printf("\n>> Timer claiming\n");
+    _zn_timers_init(&claim_tms);
+
+    _zn_timer_init(&cancelled_tmr, cancel_then_claim, NULL);
+    _zn_timer_init(&periodic_tmr, reschedule, NULL);
+    _zn_timers_schedule(&claim_tms, &cancelled_tmr, 0);
+    _zn_timers_schedule(&claim_tms, &periodic_tmr, 0);
+
+    z_sleep_ms(2);
+    while (_zn_timers_expire(&claim_tms) != _ZN_TIMER_IDLE)
+        z_sleep_ms(1);
+
+    assert(claimed == 0);
+    assert(periods == 3);
+    assert(claim_tms.len == 0);
+
+    _zn_timers_clear(&claim_tms);
+}
+
+/*------------------ Sessions ------------------*/
+#define MTU 1024
+#define MAX_MIDS 256
+
+// The IDs of the transport messages written on the link
+volatile uint8_t mids[MAX_MIDS];
+volatile size_t mids_len = 0;
+
+size_t record_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    (void)(arg);
+    _z_zbuf_t zbf;
+    zbf.ios = _z_iosli_wrap(ptr, len, 0, len);
+    _zn_transport_message_result_t r = _zn_transport_message_decode_lazy(&zbf);
+    assert(r.tag == _z_res_t_OK);
+    if (mids_len < MAX_MIDS)
+        mids[mids_len++] = _ZN_MID(r.value.transport_message.header);
+    _zn_t_msg_clear(&r.value.transport_message);
+    return len;
+}
+
+size_t count_mids(uint8_t mid)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < mids_len; i++)
+        count += mids[i] == mid;
+    return count;
+}
+
+_zn_link_t *make_link(void)
+{
+    _zn_link_t *link = zn_test_link_make(NULL, MTU, 1);
+    link->write_f = record_write;
+    return link;
+}
+
+zn_session_t *make_unicast_session(z_zint_t lease)
+{
+    _zn_transport_unicast_establish_param_t param = zn_test_unicast_param(0);
+    param.lease = lease;
+    return zn_test_unicast_session_make(make_link(), param);
+}
+
+zn_session_t *make_multicast_session(void)
+{
+    _zn_transport_multicast_establish_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.sn_resolution = ZN_SN_RESOLUTION;
+    return zn_test_multicast_session_make(make_link(), param);
+}
+
+/*------------------ Query deadlines ------------------*/
+size_t replies_final = 0;
+
+void reply_handler(const zn_reply_t reply, const void *arg)
+{
+    (void)(arg);
+    if (reply.tag == zn_reply_t_Tag_FINAL)
+        replies_final++;
+}
+
+void test_query_timeout(void)
+{
+    printf("\n>> Query deadlines\n");
+    zn_session_t *zn = make_unicast_session(ZN_TRANSPORT_LEASE);
+    _zn_timers_t *tms = &zn->tp->transport.unicast.timers;
+
+    // The query is completed upon its final reply, which cancels its deadline
+    zn_query(zn, zn_rname("/a/b"), "", zn_query_target_default(), zn_query_consolidation_default(), reply_handler, NULL);
+    assert(_zn_get_pending_query_by_id(zn, 1) != NULL);
+    assert(tms->len == (ZN_QUERY_TIMEOUT > 0));
+
+    _zn_reply_context_t rc;
+    memset(&rc, 0, sizeof(rc));
+    rc.qid = 1;
+    rc.header = _ZN_MID_REPLY_CONTEXT | _ZN_FLAG_Z_F;
+    assert(_zn_trigger_query_reply_final(zn, &rc) == 0);
+    assert(replies_final == 1);
+    assert(_zn_get_pending_query_by_id(zn, 1) == NULL);
+    assert(tms->len == 0);
+
+    // Without final reply, the query is completed upon its deadline
+    zn_query(zn, zn_rname("/a/b"), "", zn_query_target_default(), zn_query_consolidation_default(), reply_handler, NULL);
+    _zn_pending_query_t *pq = _zn_get_pending_query_by_id(zn, 2);
+    assert(pq != NULL);
+    _zn_timers_schedule(tms, &pq->timer, 0);
+    z_sleep_ms(2);
+    _zn_timers_expire(tms);
+    assert(replies_final == 2);
+    assert(_zn_get_pending_query_by_id(zn, 2) == NULL);
+
+    // A late final reply is ignored
+    rc.qid = 2;
+    assert(_zn_trigger_query_reply_final(zn, &rc) == -1);
+    assert(replies_final == 2);
+
+    zn_test_session_free(zn);
+}
+
+/*------------------ Leases ------------------*/
+void test_unicast_lease(void)
+{
+    printf("\n>> Unicast lease\n");
+    mids_len = 0;
+    zn_session_t *zn = make_unicast_session(70);
+
+    // Nothing is received: keep alive messages are sent until the session expires and is closed
+    assert(znp_start_lease_task(zn) == 0);
+    for (int i = 0; i < 100 && count_mids(_ZN_MID_CLOSE) == 0; i++)
+        z_sleep_ms(10);
+    for (int i = 0; i < 100 && zn->tp->transport.unicast.lease_task_running; i++)
+        z_sleep_ms(10);
+
+    assert(count_mids(_ZN_MID_KEEP_ALIVE) >= 1);
+    assert(count_mids(_ZN_MID_CLOSE) == 1);
+    assert(zn->tp->transport.unicast.lease_task_running == 0);
+
+    zn_test_session_free(zn);
+}
+
+void join_as(zn_session_t *zn, z_bytes_t *addr, const z_bytes_t *id, z_zint_t lease)
+{
+    _zn_conduit_sn_list_t next_sns;
+    _zn_conduit_sn_list_init(&next_sns, 0, 0);
+    z_bytes_t pid = _z_bytes_wrap(id->val, id->len);
+    _zn_transport_message_t t_msg = _zn_t_msg_make_join(ZN_PROTO_VERSION, ZN_PEER, lease, ZN_SN_RESOLUTION, pid, next_sns);
+    _zn_multicast_handle_transport_message(&zn->tp->transport.multicast, &t_msg, addr);
+}
+
+void join(zn_session_t *zn, z_bytes_t *addr, z_zint_t lease)
+{
+    join_as(zn, addr, addr, lease);
+}
+
+void test_peer_lease(void)
+{
+    printf("\n>> Multicast peer leases\n");
+    zn_session_t *zn = make_multicast_session();
+    _zn_transport_multicast_t *ztm = &zn->tp->transport.multicast;
+
+    uint8_t addr_a[] = {10, 0, 0, 1};
+    uint8_t addr_b[] = {10, 0, 0, 2};
+    z_bytes_t a = _z_bytes_wrap(addr_a, sizeof(addr_a));
+    z_bytes_t b = _z_bytes_wrap(addr_b, sizeof(addr_b));
+
+    // Each peer has its own lease
+    join(zn, &a, 10000);
+    join(zn, &b, 20000);
+    _zn_transport_peer_entry_t *pa = _zn_transport_peer_table_get(&ztm->peer_table, &a);
+    _zn_transport_peer_entry_t *pb = _zn_transport_peer_table_get(&ztm->peer_table, &b);
+    assert(pa != NULL && pb != NULL);
+    assert(ztm->timers.len == 2);
+    assert(pb->lease_timer.deadline >= pa->lease_timer.deadline + 10000 - 100);
+
+    // A peer that has sent messages during its lease is kept
+    _zn_timers_schedule(&ztm->timers, &pa->lease_timer, 0);
+    z_sleep_ms(2);
+    _zn_timers_expire(&ztm->timers);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &a) == pa);
+    assert(pa->received == 0);
+    assert(_zn_timer_is_scheduled(&pa->lease_timer));
+
+    // Otherwise it expires
+    _zn_timers_schedule(&ztm->timers, &pa->lease_timer, 0);
+    z_sleep_ms(2);
+    _zn_timers_expire(&ztm->timers);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &a) == NULL);
+    assert(_zn_transport_peer_entry_list_len(ztm->peers) == 1);
+    assert(ztm->timers.len == 1);
+
+    // A peer leaving the group cancels its lease
+    z_bytes_t pid = _z_bytes_wrap(addr_b, sizeof(addr_b));
+    _zn_transport_message_t t_msg = _zn_t_msg_make_close(_ZN_CLOSE_GENERIC, pid, 0);
+    _zn_multicast_handle_transport_message(ztm, &t_msg, &b);
+    assert(_zn_transport_peer_entry_list_len(ztm->peers) == 0);
+    assert(ztm->timers.len == 0);
+
+    zn_test_session_free(zn);
+}
+
+void test_shared_pid(void)
+{
+    printf("\n>> Multicast peers sharing a PID\n");
+    zn_session_t *zn = make_multicast_session();
+    _zn_transport_multicast_t *ztm = &zn->tp->transport.multicast;
+
+    uint8_t addr_a[] = {10, 0, 0, 1};
+    uint8_t addr_b[] = {10, 0, 0, 2};
+    uint8_t id[] = {0xaa, 0xbb};
+    z_bytes_t a = _z_bytes_wrap(addr_a, sizeof(addr_a));
+    z_bytes_t b = _z_bytes_wrap(addr_b, sizeof(addr_b));
+    z_bytes_t pid = _z_bytes_wrap(id, sizeof(id));
+
+    // The same PID joins from two addresses
+    join_as(zn, &a, &pid, 10000);
+    join_as(zn, &b, &pid, 10000);
+    _zn_transport_peer_entry_t *pb = _zn_transport_peer_table_get(&ztm->peer_table, &b);
+    assert(_zn_transport_peer_entry_list_len(ztm->peers) == 2);
+    assert(ztm->timers.len == 2);
+
+    // Closing one of them leaves the other one known
+    _zn_transport_message_t t_msg = _zn_t_msg_make_close(_ZN_CLOSE_GENERIC, pid, 0);
+    _zn_multicast_handle_transport_message(ztm, &t_msg, &a);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &a) == NULL);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &b) == pb);
+    assert(_zn_transport_peer_entry_list_len(ztm->peers) == 1);
+    assert(ztm->peers->val == pb);
+    assert(ztm->timers.len == 1 && ztm->timers.heap[0] == &pb->lease_timer);
+
+    // So does the expiration of one of them
+    join_as(zn, &a, &pid, 10000);
+    _zn_transport_peer_entry_t *pa = _zn_transport_peer_table_get(&ztm->peer_table, &a);
+    _zn_timers_schedule(&ztm->timers, &pa->lease_timer, 0);
+    z_sleep_ms(2);
+    _zn_timers_expire(&ztm->timers);
+    _zn_timers_schedule(&ztm->timers, &pa->lease_timer, 0);
+    z_sleep_ms(2);
+    _zn_timers_expire(&ztm->timers);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &a) == NULL);
+    assert(_zn_transport_peer_table_get(&ztm->peer_table, &b) == pb);
+    assert(_zn_transport_peer_entry_list_len(ztm->peers) == 1);
+    assert(ztm->timers.len == 1 && ztm->timers.heap[0] == &pb->lease_timer);
+
+    zn_test_session_free(zn);
+}
+
+int main(void)
+{
+    test_heap();
+    test_claim();
+    test_query_timeout();
+    test_unicast_lease();
+    test_peer_lease();
+    test_shared_pid();
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/transport/link/tx.h"
+#include "zn_test_session.h"
+
+#define MTU 4096
+#define MAX_FRAMES 16
+#define SMALL 16
+#define LARGE ZN_ZERO_COPY_THRESHOLD
+#define LINGER 50
+#define MSGS 3
+
+uint8_t payload[LARGE];
+
+// Frames written on the link of the publishing session
+zn_test_frames_t frames;
+
+int count_msg(_zn_zenoh_message_t *msg, void *arg)
+{
+    (void)(msg);
+    (*(size_t *)arg)++;
+    return 0;
+}
+
+// Number of zenoh messages packed in a frame
+size_t frame_msgs(size_t i)
+{
+    _zn_transport_message_t t_msg = zn_test_frames_decode(&frames, i);
+    assert(_ZN_MID(t_msg.header) == _ZN_MID_FRAME);
+    size_t len = 0;
+    assert(_zn_frame_messages_decode(&t_msg.body.frame, count_msg, &len) == 0);
+    _zn_t_msg_clear(&t_msg);
+    return len;
+}
+
+void test_linger(void)
+{
+    printf(">>> Testing linger timeout\n");
+
+    zn_test_frames_reset(&frames);
+    zn_session_t *zn = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(0));
+    _zn_transport_unicast_t *ztu = &zn->tp->transport.unicast;
+    ztu->batch_linger = LINGER;
+
+    // The partial batch is held until the linger time expires
+    for (int i = 0; i < MSGS; i++)
+        assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(_zn_unicast_flush_expired(ztu) == 0);
+    assert(frames.len == 0);
+
+    // Once expired, the batch is sent as a single frame
+    z_sleep_ms(2 * LINGER);
+    assert(_zn_unicast_flush_expired(ztu) == 0);
+    assert(frames.len == 1);
+    assert(frame_msgs(0) == MSGS);
+
+    // Nothing is left to send
+    assert(_zn_unicast_flush_expired(ztu) == 0);
+    assert(frames.len == 1);
+
+    zn_test_session_free(zn);
+}
+
+void test_nested_scopes(void)
+{
+    printf(">>> Testing nested batch scopes\n");
+
+    zn_test_frames_reset(&frames);
+    zn_session_t *zn = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(0));
+
+    assert(_zn_batch_start(zn->tp) == 0);
+    assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(_zn_batch_start(zn->tp) == 0);
+    for (int i = 1; i < MSGS; i++)
+        assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+
+    // Flushing the inner scope does not send the outer batch early
+    assert(_zn_batch_flush(zn->tp) == 0);
+    assert(frames.len == 0);
+
+    // Flushing the outermost scope sends all the messages in a single frame
+    assert(_zn_batch_flush(zn->tp) == 0);
+    assert(frames.len == 1);
+    assert(frame_msgs(0) == MSGS);
+
+    // Without any scope open, the messages are sent right away
+    assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(frames.len == 2);
+    assert(frame_msgs(1) == 1);
+
+    zn_test_session_free(zn);
+}
+
+void test_large_payload(void)
+{
+    printf(">>> Testing large payloads in a batch scope\n");
+
+    zn_test_frames_reset(&frames);
+    zn_session_t *zn = zn_test_unicast_session_make(zn_test_link_make(&frames, MTU, 1), zn_test_unicast_param(0));
+
+    assert(_zn_batch_start(zn->tp) == 0);
+    assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(frames.len == 0);
+
+    // Large payloads are not copied in the batch, they are sent right after the batched messages
+    assert(zn_test_publish(zn, payload, LARGE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(frames.len == 2);
+    assert(frame_msgs(0) == 1);
+    assert(frame_msgs(1) == 1);
+
+    // The scope keeps batching the following messages
+    for (int i = 0; i < MSGS; i++)
+        assert(zn_test_publish(zn, payload, SMALL, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+    assert(frames.len == 2);
+    assert(_zn_batch_flush(zn->tp) == 0);
+    assert(frames.len == 3);
+    assert(frame_msgs(2) == MSGS);
+
+    zn_test_session_free(zn);
+}
+
+int main(void)
+{
+    zn_test_frames_init(&frames, 2 * MTU, MAX_FRAMES);
+
+    test_linger();
+    test_nested_scopes();
+    test_large_payload();
+
+    zn_test_frames_clear(&frames);
+    return 0;
+}
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 1024
+#define RUN (10 * ZN_TX_QUEUE_SIZE)
+#define LARGE 5000
+
+// Frames written on the link, by the write task or directly by the publishers
+zn_test_frames_t frames;
+
+// The link blocks its writers while the gate is closed, like a congested TCP peer
+z_mutex_t mutex;
+z_condvar_t gate_cv;
+int gate_open = 1;
+
+// Content of the frames written on the link
+uint32_t data[2 * RUN];
+size_t data_len = 0;
+size_t fragments_len = 0;
+size_t fragments_final = 0;
+
+size_t gate_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    z_mutex_lock(&mutex);
+    while (!gate_open)
+        z_condvar_wait(&gate_cv, &mutex);
+    zn_test_link_write(arg, ptr, len);
+    z_mutex_unlock(&mutex);
+    return len;
+}
+
+int collect_data(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    (void)(arg);
+    _zn_data_t *d = &z_msg->body.data;
+    assert(d->payload.len == sizeof(uint32_t));
+    memcpy(&data[data_len], d->payload.val, sizeof(uint32_t));
+    data_len++;
+    return 0;
+}
+
+// Collect the content of the frames written so far, and forget them
+void collect(void)
+{
+    for (size_t i = 0; i < frames.len; i++)
+    {
+        _zn_transport_message_t t_msg = zn_test_frames_decode(&frames, i);
+        assert(_ZN_MID(t_msg.header) == _ZN_MID_FRAME);
+        if (_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_F))
+        {
+            fragments_len += t_msg.body.frame.payload.fragment.len;
+            if (_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_E))
+                fragments_final++;
+        }
+        else
+        {
+            assert(_zn_frame_messages_decode(&t_msg.body.frame, collect_data, NULL) == 0);
+        }
+        _zn_t_msg_clear(&t_msg);
+    }
+    zn_test_frames_reset(&frames);
+}
+
+void publish(zn_session_t *zn, uint32_t seq, zn_congestion_control_t cong_ctrl)
+{
+    assert(zn_test_publish(zn, (const uint8_t *)&seq, sizeof(seq), cong_ctrl, ZN_PRIORITY_DEFAULT) == 0);
+}
+
+void *publish_task(void *arg)
+{
+    zn_session_t *zn = (zn_session_t *)arg;
+    for (uint32_t i = 0; i < RUN; i++)
+        publish(zn, i, zn_congestion_control_t_BLOCK);
+    return 0;
+}
+
+void *stop_task(void *arg)
+{
+    zn_session_t *zn = (zn_session_t *)arg;
+    assert(znp_stop_write_task(zn) == 0);
+    return 0;
+}
+
+int main(void)
+{
+    z_mutex_init(&mutex);
+    z_condvar_init(&gate_cv);
+
+    zn_test_frames_init(&frames, RUN * MTU, 2 * RUN);
+    _zn_link_t *link = zn_test_link_make(&frames, MTU, 1);
+    link->write_f = gate_write;
+    zn_session_t *zn = zn_test_unicast_session_make(link, zn_test_unicast_param(0));
+
+    assert(znp_stop_write_task(zn) == -1);
+    assert(znp_start_write_task(zn) == 0);
+    assert(znp_start_write_task(zn) == -1);
+
+    // Blocking publications are all sent, in order and packed in frames
+    for (uint32_t i = 0; i < RUN; i++)
+        publish(zn, i, zn_congestion_control_t_BLOCK);
+
+    // Large messages are fragmented by the write task
+    uint8_t large[LARGE];
+    memset(large, 0xab, LARGE);
+    assert(zn_test_publish(zn, large, LARGE, zn_congestion_control_t_BLOCK, ZN_PRIORITY_DEFAULT) == 0);
+
+    assert(znp_stop_write_task(zn) == 0);
+    collect();
+    assert(data_len == RUN);
+    for (uint32_t i = 0; i < RUN; i++)
+        assert(data[i] == i);
+    assert(fragments_final == 1);
+    assert(fragments_len > LARGE);
+
+    // Dropping publications do not wait for a congested link, they fill the queue
+    assert(znp_start_write_task(zn) == 0);
+    z_mutex_lock(&mutex);
+    gate_open = 0;
+    z_mutex_unlock(&mutex);
+
+    for (uint32_t i = 0; i < RUN; i++)
+        publish(zn, RUN + i, zn_congestion_control_t_DROP);
+
+    z_mutex_lock(&mutex);
+    gate_open = 1;
+    z_condvar_signal(&gate_cv);
+    z_mutex_unlock(&mutex);
+
+    assert(znp_stop_write_task(zn) == 0);
+    collect();
+    size_t sent = data_len - RUN;
+    printf("Sent %zu out of %d dropping publications\n", sent, RUN);
+    assert(sent >= ZN_TX_QUEUE_SIZE);
+    assert(sent < RUN);
+    for (size_t i = RUN + 1; i < data_len; i++)
+        assert(data[i] > data[i - 1]);
+
+    // Without the write task, messages are sent directly
+    publish(zn, 2 * RUN, zn_congestion_control_t_BLOCK);
+    assert(frames.len == 1);
+    collect();
+    assert(data[data_len - 1] == 2 * RUN);
+
+    // The write task is stopped while a publisher is blocked on the full queue
+    data_len = 0;
+    assert(znp_start_write_task(zn) == 0);
+    z_mutex_lock(&mutex);
+    gate_open = 0;
+    z_mutex_unlock(&mutex);
+
+    z_task_t publisher;
+    z_task_t stopper;
+    z_task_init(&publisher, NULL, publish_task, zn);
+    z_sleep_ms(10);
+    z_task_init(&stopper, NULL, stop_task, zn);
+    z_sleep_ms(10);
+
+    z_mutex_lock(&mutex);
+    gate_open = 1;
+    z_condvar_signal(&gate_cv);
+    z_mutex_unlock(&mutex);
+    z_task_join(&stopper);
+    z_task_join(&publisher);
+    collect();
+
+    // Each publication is sent once, either by the write task or directly
+    assert(data_len == RUN);
+    uint8_t seen[RUN];
+    memset(seen, 0, sizeof(seen));
+    for (size_t i = 0; i < RUN; i++)
+    {
+        assert(data[i] < RUN && seen[data[i]] == 0);
+        seen[data[i]] = 1;
+    }
+
+    zn_test_session_free(zn);
+    zn_test_frames_clear(&frames);
+
+    z_condvar_free(&gate_cv);
+    z_mutex_free(&mutex);
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/protocol/msgcodec.h"
+#include "zenoh-pico/session/utils.h"
+#include "zn_test_session.h"
+
+#define MTU 4096
+#define MAX_FRAMES 64
+#define SMALL 16
+#define MEDIUM 2000
+#define LARGE 20000
+
+// The payload published by the application
+uint8_t payload[LARGE];
+
+// Frames written on the link
+zn_test_frames_t frames;
+
+// Content written on the stream links, split into frames once published
+uint8_t stream[2 * LARGE];
+size_t stream_len = 0;
+int is_referenced = 0;
+
+// Content of the frames written on the link
+uint8_t fragments[2 * LARGE];
+size_t fragments_len = 0;
+size_t fragments_final = 0;
+size_t data_len = 0;
+
+size_t test_write(const void *arg, const uint8_t *ptr, size_t len)
+{
+    const _zn_link_t *link = (const _zn_link_t *)arg;
+    if (ptr >= payload && ptr < payload + LARGE)
+        is_referenced = 1;
+
+    if (link->is_streamed)
+    {
+        memcpy(stream + stream_len, ptr, len);
+        stream_len += len;
+    }
+    else
+    {
+        zn_test_link_write(arg, ptr, len);
+    }
+    return len;
+}
+
+size_t test_write_vec(const void *arg, const z_bytes_t *bufs, size_t n)
+{
+    // Gather the buffers as the socket would do
+    uint8_t frame[MTU];
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (bufs[i].val >= payload && bufs[i].val < payload + LARGE)
+            is_referenced = 1;
+        memcpy(frame + len, bufs[i].val, bufs[i].len);
+        len += bufs[i].len;
+    }
+    return test_write(arg, frame, len);
+}
+
+int check_data(_zn_zenoh_message_t *z_msg, void *arg)
+{
+    (*(size_t *)arg)++;
+    _zn_data_t *d = &z_msg->body.data;
+    assert(memcmp(d->payload.val, payload, d->payload.len) == 0);
+    data_len = d->payload.len;
+    return 0;
+}
+
+void check_frame(size_t i)
+{
+    _zn_transport_message_t t_msg = zn_test_frames_decode(&frames, i);
+    assert(_ZN_MID(t_msg.header) == _ZN_MID_FRAME);
+    if (_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_F))
+    {
+        z_bytes_t *f = &t_msg.body.frame.payload.fragment;
+        memcpy(fragments + fragments_len, f->val, f->len);
+        fragments_len += f->len;
+        if (_ZN_HAS_FLAG(t_msg.header, _ZN_FLAG_T_E))
+            fragments_final++;
+    }
+    else
+    {
+        size_t msgs = 0;
+        assert(_zn_frame_messages_decode(&t_msg.body.frame, check_data, &msgs) == 0);
+        assert(msgs == 1);
+    }
+    _zn_t_msg_clear(&t_msg);
+}
+
+void reset(void)
+{
+    zn_test_frames_reset(&frames);
+    stream_len = 0;
+    is_referenced = 0;
+    fragments_len = 0;
+    fragments_final = 0;
+    data_len = 0;
+}
+
+void publish_key(zn_session_t *zn, zn_reskey_t key, size_t len)
+{
+    reset();
+
+    int res = zn_write_ext(zn, key, payload, len, 0, 0, zn_congestion_control_t_BLOCK);
+    assert(res == 0);
+
+    // Split the stream into frames using the length prefix
+    const _zn_link_t *link = zn->tp->transport.unicast.link;
+    size_t pos = 0;
+    while (pos < stream_len)
+    {
+        size_t frame_len = (size_t)stream[pos] | ((size_t)stream[pos + 1] << 8);
+        pos += _ZN_MSG_LEN_ENC_SIZE;
+        assert(pos + frame_len <= stream_len);
+        zn_test_link_write(link, stream + pos, frame_len);
+        pos += frame_len;
+    }
+
+    for (size_t i = 0; i < frames.len; i++)
+        check_frame(i);
+}
+
+void publish(zn_session_t *zn, size_t len)
+{
+    zn_reskey_t key;
+    key.rid = 1;
+    key.rname = NULL;
+    publish_key(zn, key, len);
+}
+
+void check_payload(size_t len)
+{
+    if (len <= MTU)
+    {
+        assert(frames.len == 1);
+        assert(data_len == len);
+    }
+    else
+    {
+        // The payload is the last field of the fragmented data message
+        assert(frames.len > 1);
+        assert(fragments_final == 1);
+        assert(fragments_len > len);
+        assert(memcmp(fragments + fragments_len - len, payload, len) == 0);
+    }
+}
+
+void test_link(int is_streamed, int has_write_vec)
+{
+    printf(">>> Testing %s link %s gather writes\n", is_streamed ? "stream" : "datagram", has_write_vec ? "with" : "without");
+
+    _zn_link_t *link = zn_test_link_make(&frames, MTU, 1);
+    link->write_f = test_write;
+    link->write_vec_f = has_write_vec ? test_write_vec : NULL;
+    link->is_streamed = (uint8_t)is_streamed;
+    zn_session_t *zn = zn_test_unicast_session_make(link, zn_test_unicast_param(0));
+
+    // Small payloads are copied in the batch
+    publish(zn, SMALL);
+    check_payload(SMALL);
+    assert(!is_referenced);
+
+    // Large payloads are referenced by the frames, fragmented or not, unless
+    // the datagram link can not send a frame with a single gather write
+    size_t sizes[] = {ZN_ZERO_COPY_THRESHOLD, MEDIUM, LARGE};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); i++)
+    {
+        publish(zn, sizes[i]);
+        check_payload(sizes[i]);
+        assert(is_referenced == (is_streamed || has_write_vec));
+    }
+
+    // Messages whose head does not fit in a frame are fragmented as a whole
+    char rname[2 * MTU];
+    memset(rname, 'a', sizeof(rname));
+    rname[0] = '/';
+    rname[sizeof(rname) - 1] = '\0';
+    zn_reskey_t key;
+    key.rid = ZN_RESOURCE_ID_NONE;
+    key.rname = rname;
+    publish_key(zn, key, MEDIUM);
+    assert(frames.len > 1);
+    assert(fragments_final == 1);
+    assert(fragments_len > sizeof(rname) + MEDIUM);
+    assert(memcmp(fragments + fragments_len - MEDIUM, payload, MEDIUM) == 0);
+    assert(!is_referenced);
+
+    zn_test_session_free(zn);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < LARGE; i++)
+        payload[i] = (uint8_t)(i % 251);
+
+    zn_test_frames_init(&frames, 4 * LARGE, MAX_FRAMES);
+
+    test_link(0, 1);
+    test_link(0, 0);
+    test_link(1, 1);
+    test_link(1, 0);
+
+    zn_test_frames_clear(&frames);
+    return 0;
+}